@@ -3,6 +3,7 @@
 #include <SurfaceUniformFluorophoreProperty.h>
 #include <VolumeUniformFluorophoreProperty.h>
 #include <GridBasedFluorophoreProperty.h>
+#include <ImageIntensityFluorophoreProperty.h>
 
 
 FluorophoreModelDialog
@@ -63,6 +64,8 @@ FluorophoreModelDialog
     = dynamic_cast<VolumeUniformFluorophoreProperty*>(property);
   GridBasedFluorophoreProperty* gridBasedProperty
     = dynamic_cast<GridBasedFluorophoreProperty*>(property);
+  ImageIntensityFluorophoreProperty* imageProperty
+    = dynamic_cast<ImageIntensityFluorophoreProperty*>(property);
 
   if (geometryProperty) {
 
@@ -87,6 +90,14 @@ FluorophoreModelDialog
     gui_AreaEdit->setText(QString().sprintf("%.6f", volume));
     gui_DensityLabel->setText(tr("Density (fluorophores / micron^3)"));
 
+  } else if (imageProperty) {
+
+    gui_FluorophoreModelLabel->setText(tr("Image Intensity Labeling"));
+    gui_AreaLabel->setText(tr("Intensity-weighted volume (micron^3)"));
+    double volume = imageProperty->GetWeightedVolume();
+    gui_AreaEdit->setText(QString().sprintf("%.6f", volume));
+    gui_DensityLabel->setText(tr("Density (fluorophores / micron^3 / intensity)"));
+
   } else if (gridBasedProperty) {
 
     gui_FluorophoreModelLabel->setText(tr("Grid-based Volume Labeling"));
@@ -94,6 +105,7 @@ FluorophoreModelDialog
     gui_SamplingDensityGroupBox->setHidden(true);
     gui_FluorophorePatternsGroupBox->setHidden(true);
     gui_SpacingEdit->setText(QString().sprintf("%.6f", gridBasedProperty->GetSampleSpacing()));
+    gui_GeometricErrorEdit->setText(QString().sprintf("%.6f", gridBasedProperty->GetGeometricError()));
 
   }
 
@@ -169,6 +181,7 @@ FluorophoreModelDialog
     = dynamic_cast<GridBasedFluorophoreProperty*>(m_FluorophoreProperty);
   if (gridBasedProperty) {
     gridBasedProperty->SetSampleSpacing(GetSampleSpacing());
+    gridBasedProperty->SetGeometricError(GetGeometricError());
   }
 
   // These options apply to any kind of fluorophore property
@@ -212,6 +225,13 @@ FluorophoreModelDialog
 }
 
 
+double
+FluorophoreModelDialog
+::GetGeometricError() {
+  return gui_GeometricErrorEdit->text().toDouble();
+}
+
+
 bool
 FluorophoreModelDialog
 ::GetUseFixedNumberOfFluorophores() {
@@ -321,6 +341,8 @@ FluorophoreModelDialog
     dynamic_cast<SurfaceUniformFluorophoreProperty*>(m_FluorophoreProperty);
   VolumeUniformFluorophoreProperty* volumeProperty =
     dynamic_cast<VolumeUniformFluorophoreProperty*>(m_FluorophoreProperty);
+  ImageIntensityFluorophoreProperty* imageProperty =
+    dynamic_cast<ImageIntensityFluorophoreProperty*>(m_FluorophoreProperty);
 
   if (surfaceProperty) {
     // Scale area from square nanometers to square micrometers
@@ -330,6 +352,9 @@ FluorophoreModelDialog
     // Scale area from cubic nanometers to cubic micrometers
     double volume = volumeProperty->GetGeometryVolume();
     return static_cast<int>(density * volume + 0.5);
+  } else if (imageProperty) {
+    double volume = imageProperty->GetWeightedVolume();
+    return static_cast<int>(density * volume + 0.5);
   }
 
   return 0;
@@ -343,6 +368,8 @@ FluorophoreModelDialog
     dynamic_cast<SurfaceUniformFluorophoreProperty*>(m_FluorophoreProperty);
   VolumeUniformFluorophoreProperty* volumeProperty =
     dynamic_cast<VolumeUniformFluorophoreProperty*>(m_FluorophoreProperty);
+  ImageIntensityFluorophoreProperty* imageProperty =
+    dynamic_cast<ImageIntensityFluorophoreProperty*>(m_FluorophoreProperty);
 
   if (surfaceProperty) {
     // Scale area from square nanometers to square micrometers
@@ -352,6 +379,9 @@ FluorophoreModelDialog
     // Scale area from cubic nanometers to cubic micrometers
     double volume = volumeProperty->GetGeometryVolume();
     return static_cast<double>(fluorophores) / volume;
+  } else if (imageProperty) {
+    double volume = imageProperty->GetWeightedVolume();
+    return static_cast<double>(fluorophores) / volume;
   }
 
   return 0.0;
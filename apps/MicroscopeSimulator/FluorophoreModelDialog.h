@@ -28,6 +28,7 @@ Q_OBJECT
   FluorophoreChannelType GetFluorophoreChannel();
   double                 GetIntensityScale();
   double                 GetSampleSpacing();
+  double                 GetGeometricError();
   bool                   GetUseFixedNumberOfFluorophores();
 
   double                 GetDensity();
@@ -59,6 +59,7 @@
 #include <vtkPLYWriter.h>
 #include <vtkPNGWriter.h>
 #include <vtkPolyDataMapper.h>
+#include <vtkPolyDataToTetrahedralGrid.h>
 #include <vtkPolyDataWriter.h>
 #include <vtkQtOutputLogger.h>
 #include <vtkRenderedSurfaceRepresentation.h>
@@ -66,6 +67,7 @@
 #include <vtkRenderWindow.h>
 #include <vtkSmartPointer.h>
 #include <vtkTIFFWriter.h>
+#include <vtkUniformPointSampler.h>
 #include <vtkWindowToImageFilter.h>
 #include <vtkXMLPolyDataWriter.h>
 
@@ -242,6 +244,8 @@ MicroscopeSimulator
     }
   }
 
+  UpdateFluorophoreCacheDirectory();
+
   // Restore inter-session GUI settings.
   ReadProgramSettings();
   RefreshUI();
@@ -417,6 +421,17 @@ MicroscopeSimulator
         return;
       }
 
+    } else if (strcmp(argv[i], "--fluorophore-cache-directory") == 0) {
+
+      i++;
+      if (i < argc) {
+        vtkUniformPointSampler::SetGlobalCacheDirectory(argv[i]);
+        vtkPolyDataToTetrahedralGrid::SetGlobalCacheDirectory(argv[i]);
+      } else {
+        std::cerr << "No directory provided for command --fluorophore-cache-directory" << std::endl;
+        return;
+      }
+
     } else if (strcmp(argv[i], "--optimize-fluorescence") == 0) {
 
       m_Simulation->OptimizeToFluorescence();
@@ -939,7 +954,9 @@ MicroscopeSimulator
 void
 MicroscopeSimulator
 ::on_actionPreferences_triggered() {
-  m_PreferencesDialog->exec();
+  if (m_PreferencesDialog->exec() == QDialog::Accepted) {
+    UpdateFluorophoreCacheDirectory();
+  }
 }
 
 
@@ -1154,8 +1171,6 @@ MicroscopeSimulator
     SetStatusMessage("Error: Could not export geometry");
   }
 
-  geometrySource->Delete();
-
   QString message = QString().append(tr("Exported model geometry to file '")).
     append(selectedFileName.toStdString().c_str()).append(tr("'."));
   SetStatusMessage(message.toStdString());
@@ -2395,6 +2410,23 @@ MicroscopeSimulator
 }
 
 
+void
+MicroscopeSimulator
+::UpdateFluorophoreCacheDirectory() {
+  std::string dataDirectoryPath = m_Preferences->GetDataDirectoryPath();
+  if (dataDirectoryPath == "") {
+    vtkUniformPointSampler::SetGlobalCacheDirectory(NULL);
+    vtkPolyDataToTetrahedralGrid::SetGlobalCacheDirectory(NULL);
+    return;
+  }
+
+  QString cacheDirectoryPath(dataDirectoryPath.c_str());
+  cacheDirectoryPath.append(QDir::separator()).append("FluorophoreCache");
+  vtkUniformPointSampler::SetGlobalCacheDirectory(cacheDirectoryPath.toStdString().c_str());
+  vtkPolyDataToTetrahedralGrid::SetGlobalCacheDirectory(cacheDirectoryPath.toStdString().c_str());
+}
+
+
 void
 MicroscopeSimulator
 ::closeEvent(QCloseEvent* event) {
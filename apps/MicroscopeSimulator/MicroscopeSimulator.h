@@ -65,6 +65,10 @@ protected:
   void ReadProgramSettings();
   void ReadPSFSettings();
 
+  // Stores sampled fluorophores in the data directory so that later
+  // sessions can reuse them.
+  void UpdateFluorophoreCacheDirectory();
+
   // Override the closeEvent handler.
   void closeEvent(QCloseEvent* event);
 
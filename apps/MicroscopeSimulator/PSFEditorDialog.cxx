@@ -1,5 +1,6 @@
 #include <PSFEditorDialog.h>
 
+#include <QApplication>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QSettings>
@@ -13,9 +14,12 @@
 #include <vtkRenderer.h>
 #include <vtkRenderWindow.h>
 
+#include <GibsonLanniWidefieldPointSpreadFunction.h>
 #include <ImagePlaneVisualizationPipeline.h>
+#include <ImportedPointSpreadFunction.h>
 #include <OutlineVisualizationPipeline.h>
 #include <PointSpreadFunction.h>
+#include <PointSpreadFunctionFitter.h>
 #include <PointSpreadFunctionList.h>
 
 
@@ -68,7 +72,7 @@ PSFEditorDialog
   m_RenderWindow->SetInteractor(gui_PSFDisplayQvtkWidget->GetInteractor());
   gui_PSFDisplayQvtkWidget->SetRenderWindow(m_RenderWindow);
 
-  // TODO - remove temporarily disabled PSF fitting widgets
+  // Fitting is only available for Gibson-Lanni PSFs.
   gui_FittingGroupBox->setVisible(false);
 
   m_FirstRender = true;
@@ -153,6 +157,14 @@ PSFEditorDialog
 }
 
 
+void
+PSFEditorDialog
+::on_gui_AddFourierGibsonLanniWidefieldPSFButton_clicked() {
+  m_PSFListModel->GetPSFList()->AddFourierGibsonLanniWidefieldPointSpreadFunction("Fourier Gibson-Lanni Widefield");
+  m_PSFListModel->Refresh();
+}
+
+
 void
 PSFEditorDialog
 ::on_gui_ImportPSFButton_clicked() {
@@ -164,6 +176,7 @@ PSFEditorDialog
 
   m_PSFListModel->GetPSFList()->ImportPointSpreadFunction(fileName.toStdString());
   m_PSFListModel->Refresh();
+  UpdateMeasuredImageComboBox();
 }
 
 
@@ -186,8 +199,10 @@ PSFEditorDialog
                                 QMessageBox::Ok | QMessageBox::Cancel);
   if (reply == QMessageBox::Ok) {
     m_PSFTableModel->SetPointSpreadFunction(NULL);
+    gui_FittingGroupBox->setVisible(false);
     m_PSFListModel->GetPSFList()->DeletePointSpreadFunction(selected);
     m_PSFListModel->Refresh();
+    UpdateMeasuredImageComboBox();
   }
 }
 
@@ -202,6 +217,51 @@ PSFEditorDialog
 }
 
 
+void
+PSFEditorDialog
+::on_gui_FitPSFButton_clicked() {
+  GibsonLanniWidefieldPointSpreadFunction* fittedPSF =
+    dynamic_cast<GibsonLanniWidefieldPointSpreadFunction*>
+    (m_PSFTableModel->GetPointSpreadFunction());
+  int measuredIndex = gui_MeasuredImageComboBox->currentIndex();
+  if (!fittedPSF || measuredIndex < 0)
+    return;
+
+  int listIndex = gui_MeasuredImageComboBox->itemData(measuredIndex).toInt();
+  ImportedPointSpreadFunction* measuredPSF =
+    dynamic_cast<ImportedPointSpreadFunction*>
+    (m_PSFListModel->GetPSFList()->GetPointSpreadFunctionAt(listIndex));
+  if (!measuredPSF)
+    return;
+
+  // Start the fit from the parameters shown in the table.
+  m_PSFTableModel->CopyCacheToPSF();
+
+  PointSpreadFunctionFitter fitter;
+  fitter.SetMeasuredPointSpreadFunction(measuredPSF);
+  fitter.SetFittedPointSpreadFunction(fittedPSF);
+
+  QApplication::setOverrideCursor(Qt::WaitCursor);
+  bool fitted = fitter.Fit();
+  QApplication::restoreOverrideCursor();
+
+  if (!fitted) {
+    QMessageBox::warning
+      (this, tr("Error"),
+       tr("Could not fit the point-spread function to '").
+       append(measuredPSF->GetName().c_str()).append("'."));
+    return;
+  }
+
+  m_PSFTableModel->CopyPSFToCache();
+  m_PSFTableModel->Refresh();
+
+  UpdateImage();
+  UpdateSliders();
+  m_RenderWindow->Render();
+}
+
+
 void
 PSFEditorDialog
 ::on_gui_ShowXPlaneCheckBox_toggled(bool value) {
@@ -386,7 +446,10 @@ PSFEditorDialog
     UpdateImage();
     UpdateSliders();
     UpdatePSFVisualization();
+    UpdateMeasuredImageComboBox();
     SetWidgetsEnabled(activePSF != NULL);
+    gui_FittingGroupBox->setVisible
+      (dynamic_cast<GibsonLanniWidefieldPointSpreadFunction*>(activePSF) != NULL);
   }
 }
 
@@ -520,6 +583,28 @@ PSFEditorDialog
 }
 
 
+void
+PSFEditorDialog
+::UpdateMeasuredImageComboBox() {
+  // List the imported PSFs, keeping their index in the PSF list.
+  gui_MeasuredImageComboBox->clear();
+
+  PointSpreadFunctionList* list = m_PSFListModel->GetPSFList();
+  if (!list)
+    return;
+
+  for (int i = 0; i < list->GetSize(); i++) {
+    ImportedPointSpreadFunction* psf =
+      dynamic_cast<ImportedPointSpreadFunction*>(list->GetPointSpreadFunctionAt(i));
+    if (psf) {
+      gui_MeasuredImageComboBox->addItem(QString(psf->GetName().c_str()), i);
+    }
+  }
+
+  gui_FitPSFButton->setEnabled(gui_MeasuredImageComboBox->count() > 0);
+}
+
+
 void
 PSFEditorDialog
 ::SetWidgetsEnabled(bool enabled) {
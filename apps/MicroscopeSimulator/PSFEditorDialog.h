@@ -36,9 +36,11 @@ Q_OBJECT
   virtual void on_gui_AddCalculatedGibsonLanniWidefieldPSFButton_clicked();
   virtual void on_gui_AddModifiedGibsonLanniWidefieldPSFButton_clicked();
   virtual void on_gui_AddCalculatedHaeberleWidefieldPSFButton_clicked();
+  virtual void on_gui_AddFourierGibsonLanniWidefieldPSFButton_clicked();
   virtual void on_gui_ImportPSFButton_clicked();
   virtual void on_gui_DeletePSFButton_clicked();
   virtual void on_gui_ApplyButton_clicked();
+  virtual void on_gui_FitPSFButton_clicked();
 
   virtual void on_gui_ShowXPlaneCheckBox_toggled(bool value);
   virtual void on_gui_XPlaneEdit_textChanged(QString text);
@@ -94,6 +96,7 @@ Q_OBJECT
   void UpdateImage();
   void UpdateSliders();
   void UpdatePSFVisualization();
+  void UpdateMeasuredImageComboBox();
   void SetWidgetsEnabled(bool enabled);
 
   void RescaleToFullDynamicRange();
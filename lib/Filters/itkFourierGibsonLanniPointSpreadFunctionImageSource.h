@@ -0,0 +1,203 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkFourierGibsonLanniPointSpreadFunctionImageSource.h,v $
+  Language:  C++
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkFourierGibsonLanniPointSpreadFunctionImageSource_h
+#define __itkFourierGibsonLanniPointSpreadFunctionImageSource_h
+
+#include <complex>
+#include <vector>
+
+#include "itkImageSource.h"
+#include "itkNumericTraits.h"
+
+#include "vnl/vnl_vector.h"
+
+
+namespace itk
+{
+
+/** \class FourierGibsonLanniPointSpreadFunctionImageSource
+ * \brief Generate a widefield point-spread function by Fourier
+ * synthesis from a sampled pupil function.
+ *
+ * The pupil is sampled on a square grid covering the disk of radius
+ * NA / wavelength in spatial frequency. Its phase is the Gibson-Lanni
+ * optical path difference for the given design and actual
+ * imaging conditions. Each z-slice of the PSF is the squared magnitude
+ * of the 2D inverse Fourier transform of the pupil, evaluated with a
+ * separable chirp-z transform so that the lateral sampling of the
+ * output is independent of the pupil sampling.
+ *
+ * Lengths are in nanometers except for layer thicknesses and the
+ * point source depth, which are in microns to match
+ * GibsonLanniPointSpreadFunctionImageSource.
+ *
+ * \ingroup DataSources
+ */
+template <class TOutputImage>
+class FourierGibsonLanniPointSpreadFunctionImageSource :
+    public ImageSource<TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef FourierGibsonLanniPointSpreadFunctionImageSource Self;
+  typedef ImageSource<TOutputImage>                        Superclass;
+  typedef SmartPointer<Self>                               Pointer;
+  typedef SmartPointer<const Self>                         ConstPointer;
+
+  /** Typedef for the output image type. */
+  typedef TOutputImage                             OutputImageType;
+  typedef typename OutputImageType::PixelType      PixelType;
+  typedef typename OutputImageType::RegionType     OutputImageRegionType;
+  typedef typename OutputImageType::IndexType      IndexType;
+  typedef typename OutputImageType::SizeType       SizeType;
+  typedef typename OutputImageType::SizeValueType  SizeValueType;
+  typedef typename OutputImageType::SpacingType    SpacingType;
+  typedef typename OutputImageType::PointType      PointType;
+
+  typedef std::complex<double>      ComplexType;
+  typedef vnl_vector< ComplexType > ComplexVectorType;
+
+  itkStaticConstMacro(ImageDimension,
+		      unsigned int,
+		      TOutputImage::ImageDimension);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FourierGibsonLanniPointSpreadFunctionImageSource,ImageSource);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Specify the size of the output image. */
+  itkSetMacro(Size,SizeType);
+  itkGetConstReferenceMacro(Size,SizeType);
+
+  /** Specify the spacing of the output image (in nanometers). */
+  itkSetMacro(Spacing,SpacingType);
+  itkGetConstReferenceMacro(Spacing,SpacingType);
+
+  /** Specify the origin of the output image (in nanometers). */
+  itkSetMacro(Origin,PointType);
+  itkGetConstReferenceMacro(Origin,PointType);
+
+  /** Number of pupil samples along each axis of the pupil grid. */
+  itkSetClampMacro(NumberOfPupilSamples,unsigned int,2,NumericTraits<unsigned int>::max());
+  itkGetConstMacro(NumberOfPupilSamples,unsigned int);
+
+  /** Emission wavelength (in nanometers). */
+  itkSetMacro(EmissionWavelength,double);
+  itkGetConstMacro(EmissionWavelength,double);
+
+  /** Numerical aperture of the objective. */
+  itkSetMacro(NumericalAperture,double);
+  itkGetConstMacro(NumericalAperture,double);
+
+  /** Design and actual cover slip refractive index and thickness
+   * (thickness in microns). */
+  itkSetMacro(DesignCoverSlipRefractiveIndex,double);
+  itkGetConstMacro(DesignCoverSlipRefractiveIndex,double);
+  itkSetMacro(ActualCoverSlipRefractiveIndex,double);
+  itkGetConstMacro(ActualCoverSlipRefractiveIndex,double);
+  itkSetMacro(DesignCoverSlipThickness,double);
+  itkGetConstMacro(DesignCoverSlipThickness,double);
+  itkSetMacro(ActualCoverSlipThickness,double);
+  itkGetConstMacro(ActualCoverSlipThickness,double);
+
+  /** Design and actual immersion oil refractive index and design
+   * immersion oil thickness (in microns). */
+  itkSetMacro(DesignImmersionOilRefractiveIndex,double);
+  itkGetConstMacro(DesignImmersionOilRefractiveIndex,double);
+  itkSetMacro(ActualImmersionOilRefractiveIndex,double);
+  itkGetConstMacro(ActualImmersionOilRefractiveIndex,double);
+  itkSetMacro(DesignImmersionOilThickness,double);
+  itkGetConstMacro(DesignImmersionOilThickness,double);
+
+  /** Actual specimen layer refractive index. */
+  itkSetMacro(ActualSpecimenLayerRefractiveIndex,double);
+  itkGetConstMacro(ActualSpecimenLayerRefractiveIndex,double);
+
+  /** Depth of the point source in the specimen layer (in microns). */
+  itkSetMacro(ActualPointSourceDepthInSpecimenLayer,double);
+  itkGetConstMacro(ActualPointSourceDepthInSpecimenLayer,double);
+
+  /** Lateral shift of the PSF center per unit of z. */
+  itkSetMacro(ShearX,double);
+  itkGetConstMacro(ShearX,double);
+  itkSetMacro(ShearY,double);
+  itkGetConstMacro(ShearY,double);
+
+protected:
+  FourierGibsonLanniPointSpreadFunctionImageSource();
+  ~FourierGibsonLanniPointSpreadFunctionImageSource();
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  virtual void GenerateOutputInformation();
+  virtual void BeforeThreadedGenerateData();
+  virtual void DynamicThreadedGenerateData(const OutputImageRegionType& outputRegionForThread);
+
+  /** Computes the z-independent part of the optical path difference
+   * and the defocus coefficient at normalized pupil radius rho. Returns
+   * false if rho lies beyond the critical angle of any layer. */
+  bool ComputeOpticalPathDifference(double rho, double& opd, double& defocus) const;
+
+  /** Sets up the chirp-z transform that maps numberOfInputs samples
+   * with step alpha to numberOfOutputs samples. On return, chirp holds
+   * the input pre-multiplication chirp and kernel holds the forward
+   * transform of the convolution kernel. */
+  static unsigned int PrepareChirpZTransform(unsigned int numberOfInputs,
+                                             unsigned int numberOfOutputs,
+                                             double alpha,
+                                             ComplexVectorType& chirp,
+                                             ComplexVectorType& kernel);
+
+  SizeType    m_Size;
+  SpacingType m_Spacing;
+  PointType   m_Origin;
+
+  unsigned int m_NumberOfPupilSamples;
+
+  double m_EmissionWavelength;
+  double m_NumericalAperture;
+  double m_DesignCoverSlipRefractiveIndex;
+  double m_ActualCoverSlipRefractiveIndex;
+  double m_DesignCoverSlipThickness;
+  double m_ActualCoverSlipThickness;
+  double m_DesignImmersionOilRefractiveIndex;
+  double m_ActualImmersionOilRefractiveIndex;
+  double m_DesignImmersionOilThickness;
+  double m_ActualSpecimenLayerRefractiveIndex;
+  double m_ActualPointSourceDepthInSpecimenLayer;
+  double m_ShearX;
+  double m_ShearY;
+
+  /** Pupil samples precomputed in BeforeThreadedGenerateData. Samples
+   * outside the pupil have zero in m_PupilMask. Stored row-major with
+   * the x frequency varying fastest. */
+  std::vector<unsigned char> m_PupilMask;
+  std::vector<double>        m_PupilPathDifference;
+  std::vector<double>        m_PupilDefocus;
+
+private:
+  FourierGibsonLanniPointSpreadFunctionImageSource(const FourierGibsonLanniPointSpreadFunctionImageSource&); //purposely not implemented
+  void operator=(const FourierGibsonLanniPointSpreadFunctionImageSource&); //purposely not implemented
+
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFourierGibsonLanniPointSpreadFunctionImageSource.txx"
+#endif
+
+#endif
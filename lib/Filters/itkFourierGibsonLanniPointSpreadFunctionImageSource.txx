@@ -0,0 +1,361 @@
+/*=========================================================================
+
+  Program:   Insight Segmentation & Registration Toolkit
+  Module:    $RCSfile: itkFourierGibsonLanniPointSpreadFunctionImageSource.txx,v $
+  Language:  C++
+
+  Copyright (c) Insight Software Consortium. All rights reserved.
+  See ITKCopyright.txt or http://www.itk.org/HTML/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+#ifndef __itkFourierGibsonLanniPointSpreadFunctionImageSource_txx
+#define __itkFourierGibsonLanniPointSpreadFunctionImageSource_txx
+
+#include "itkFourierGibsonLanniPointSpreadFunctionImageSource.h"
+#include "itkImageRegionIterator.h"
+#include "itkMath.h"
+#include "itkObjectFactory.h"
+
+#include "vnl/algo/vnl_fft_1d.h"
+
+#include <cmath>
+
+
+namespace itk
+{
+
+/**
+ *
+ */
+template< typename TOutputImage >
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::FourierGibsonLanniPointSpreadFunctionImageSource()
+{
+  m_Size.Fill(32);
+  m_Spacing.Fill(65.0);
+  m_Spacing[2] = 100.0;
+  m_Origin.Fill(0.0);
+
+  m_NumberOfPupilSamples = 128;
+
+  m_EmissionWavelength                    = 550.0;  // in nanometers
+  m_NumericalAperture                     = 1.4;
+  m_DesignCoverSlipRefractiveIndex        = 1.522;
+  m_ActualCoverSlipRefractiveIndex        = 1.522;
+  m_DesignCoverSlipThickness              = 170.0;  // in microns
+  m_ActualCoverSlipThickness              = 170.0;  // in microns
+  m_DesignImmersionOilRefractiveIndex     = 1.515;
+  m_ActualImmersionOilRefractiveIndex     = 1.515;
+  m_DesignImmersionOilThickness           = 100.0;  // in microns
+  m_ActualSpecimenLayerRefractiveIndex    = 1.33;
+  m_ActualPointSourceDepthInSpecimenLayer = 0.0;    // in microns
+  m_ShearX = 0.0;
+  m_ShearY = 0.0;
+
+  this->DynamicMultiThreadingOn();
+}
+
+
+template< typename TOutputImage >
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::~FourierGibsonLanniPointSpreadFunctionImageSource()
+{
+}
+
+
+/**
+ *
+ */
+template< typename TOutputImage >
+void
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+
+  os << indent << "Size: " << m_Size << std::endl;
+  os << indent << "Spacing: " << m_Spacing << std::endl;
+  os << indent << "Origin: " << m_Origin << std::endl;
+  os << indent << "NumberOfPupilSamples: " << m_NumberOfPupilSamples << std::endl;
+  os << indent << "EmissionWavelength: " << m_EmissionWavelength << std::endl;
+  os << indent << "NumericalAperture: " << m_NumericalAperture << std::endl;
+  os << indent << "DesignCoverSlipRefractiveIndex: "
+     << m_DesignCoverSlipRefractiveIndex << std::endl;
+  os << indent << "ActualCoverSlipRefractiveIndex: "
+     << m_ActualCoverSlipRefractiveIndex << std::endl;
+  os << indent << "DesignCoverSlipThickness: "
+     << m_DesignCoverSlipThickness << std::endl;
+  os << indent << "ActualCoverSlipThickness: "
+     << m_ActualCoverSlipThickness << std::endl;
+  os << indent << "DesignImmersionOilRefractiveIndex: "
+     << m_DesignImmersionOilRefractiveIndex << std::endl;
+  os << indent << "ActualImmersionOilRefractiveIndex: "
+     << m_ActualImmersionOilRefractiveIndex << std::endl;
+  os << indent << "DesignImmersionOilThickness: "
+     << m_DesignImmersionOilThickness << std::endl;
+  os << indent << "ActualSpecimenLayerRefractiveIndex: "
+     << m_ActualSpecimenLayerRefractiveIndex << std::endl;
+  os << indent << "ActualPointSourceDepthInSpecimenLayer: "
+     << m_ActualPointSourceDepthInSpecimenLayer << std::endl;
+  os << indent << "ShearX: " << m_ShearX << std::endl;
+  os << indent << "ShearY: " << m_ShearY << std::endl;
+}
+
+
+//----------------------------------------------------------------------------
+template< typename TOutputImage >
+void
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::GenerateOutputInformation()
+{
+  TOutputImage *output = this->GetOutput(0);
+
+  IndexType index;
+  index.Fill(0);
+
+  typename TOutputImage::RegionType largestPossibleRegion;
+  largestPossibleRegion.SetSize( m_Size );
+  largestPossibleRegion.SetIndex( index );
+  output->SetLargestPossibleRegion( largestPossibleRegion );
+
+  output->SetSpacing(m_Spacing);
+  output->SetOrigin(m_Origin);
+}
+
+
+//----------------------------------------------------------------------------
+template< typename TOutputImage >
+bool
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::ComputeOpticalPathDifference(double rho, double& opd, double& defocus) const
+{
+  const double NA    = m_NumericalAperture;
+  const double NA2   = NA*NA*rho*rho;
+  const double ng0   = m_DesignCoverSlipRefractiveIndex;
+  const double ng    = m_ActualCoverSlipRefractiveIndex;
+  const double ni0   = m_DesignImmersionOilRefractiveIndex;
+  const double ni    = m_ActualImmersionOilRefractiveIndex;
+  const double ns    = m_ActualSpecimenLayerRefractiveIndex;
+
+  // Convert thicknesses and depth from microns to nanometers
+  const double tg0 = m_DesignCoverSlipThickness * 1e3;
+  const double tg  = m_ActualCoverSlipThickness * 1e3;
+  const double ti0 = m_DesignImmersionOilThickness * 1e3;
+  const double zp  = m_ActualPointSourceDepthInSpecimenLayer * 1e3;
+
+  // Rays beyond the critical angle of any layer do not reach the
+  // objective.
+  if (NA2 >= ng0*ng0 || NA2 >= ng*ng || NA2 >= ni0*ni0 ||
+      NA2 >= ni*ni   || NA2 >= ns*ns) {
+    return false;
+  }
+
+  const double sg0 = sqrt(ng0*ng0 - NA2);
+  const double sg  = sqrt(ng*ng   - NA2);
+  const double si0 = sqrt(ni0*ni0 - NA2);
+  const double si  = sqrt(ni*ni   - NA2);
+  const double ss  = sqrt(ns*ns   - NA2);
+
+  // The actual immersion oil thickness is ti0 + z, where z is the
+  // defocus. The z term is returned separately so that slices can be
+  // computed from the same precomputed pupil.
+  opd = zp*ss + tg*sg - tg0*sg0 + ti0*(si - si0);
+  defocus = si;
+
+  return true;
+}
+
+
+//----------------------------------------------------------------------------
+template< typename TOutputImage >
+unsigned int
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::PrepareChirpZTransform(unsigned int numberOfInputs,
+                         unsigned int numberOfOutputs,
+                         double alpha,
+                         ComplexVectorType& chirp,
+                         ComplexVectorType& kernel)
+{
+  // Bluestein's algorithm: the sum over j of a_j exp(i 2 pi alpha j m)
+  // equals exp(i pi alpha m^2) times the convolution of
+  // a_j exp(i pi alpha j^2) with exp(-i pi alpha n^2). The convolution
+  // is done with power-of-two FFTs long enough to avoid wrap-around.
+  unsigned int length = 1;
+  while (length < numberOfInputs + numberOfOutputs - 1) {
+    length <<= 1;
+  }
+
+  const double pi = itk::Math::pi;
+
+  chirp.set_size(numberOfInputs);
+  for (unsigned int j = 0; j < numberOfInputs; j++) {
+    double jj = static_cast<double>(j);
+    chirp[j] = std::polar(1.0, pi*alpha*jj*jj);
+  }
+
+  kernel.set_size(length);
+  kernel.fill(ComplexType(0.0, 0.0));
+  for (unsigned int n = 0; n < numberOfOutputs; n++) {
+    double nn = static_cast<double>(n);
+    kernel[n] = std::polar(1.0, -pi*alpha*nn*nn);
+  }
+  for (unsigned int n = 1; n < numberOfInputs; n++) {
+    double nn = static_cast<double>(n);
+    kernel[length-n] = std::polar(1.0, -pi*alpha*nn*nn);
+  }
+
+  vnl_fft_1d<double> fft(length);
+  fft.fwd_transform(kernel);
+
+  return length;
+}
+
+
+//----------------------------------------------------------------------------
+template< typename TOutputImage >
+void
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  // Precompute the z-independent pupil terms shared by all threads.
+  const unsigned int N = m_NumberOfPupilSamples;
+  const double du = 2.0 / static_cast<double>(N-1);
+
+  m_PupilMask.assign(N*N, 0);
+  m_PupilPathDifference.assign(N*N, 0.0);
+  m_PupilDefocus.assign(N*N, 0.0);
+
+  for (unsigned int k = 0; k < N; k++) {
+    double v = -1.0 + static_cast<double>(k)*du;
+    for (unsigned int j = 0; j < N; j++) {
+      double u = -1.0 + static_cast<double>(j)*du;
+      double rho = sqrt(u*u + v*v);
+      if (rho > 1.0)
+        continue;
+
+      unsigned int p = k*N + j;
+      if (ComputeOpticalPathDifference(rho, m_PupilPathDifference[p],
+                                       m_PupilDefocus[p])) {
+        m_PupilMask[p] = 1;
+      }
+    }
+  }
+}
+
+
+//----------------------------------------------------------------------------
+template< typename TOutputImage >
+void
+FourierGibsonLanniPointSpreadFunctionImageSource< TOutputImage >
+::DynamicThreadedGenerateData(const OutputImageRegionType& outputRegionForThread)
+{
+  TOutputImage *output = this->GetOutput(0);
+
+  const unsigned int N  = m_NumberOfPupilSamples;
+  const unsigned int nx = outputRegionForThread.GetSize(0);
+  const unsigned int ny = outputRegionForThread.GetSize(1);
+  const unsigned int nz = outputRegionForThread.GetSize(2);
+  const IndexType startIndex = outputRegionForThread.GetIndex();
+
+  const double pi = itk::Math::pi;
+  const double k0 = 2.0*pi / m_EmissionWavelength;
+
+  // Spatial frequency step of the pupil grid in cycles per nanometer.
+  const double df = 2.0*m_NumericalAperture /
+    (m_EmissionWavelength*static_cast<double>(N-1));
+
+  ComplexVectorType chirpX, kernelX, chirpY, kernelY;
+  const unsigned int lengthX =
+    PrepareChirpZTransform(N, nx, df*m_Spacing[0], chirpX, kernelX);
+  const unsigned int lengthY =
+    PrepareChirpZTransform(N, ny, df*m_Spacing[1], chirpY, kernelY);
+  vnl_fft_1d<double> fftX(lengthX);
+  vnl_fft_1d<double> fftY(lengthY);
+
+  ComplexVectorType workX(lengthX);
+  ComplexVectorType workY(lengthY);
+  ComplexVectorType shiftX(N);
+  ComplexVectorType shiftY(N);
+  std::vector<ComplexType> pupil(N*N);
+  std::vector<ComplexType> columns(nx*N);
+  std::vector<double> slice(nx*ny);
+
+  for (unsigned int iz = 0; iz < nz; iz++) {
+    const double z = m_Origin[2] +
+      static_cast<double>(startIndex[2] + iz)*m_Spacing[2];
+    const double xStart = m_Origin[0] +
+      static_cast<double>(startIndex[0])*m_Spacing[0] - m_ShearX*z;
+    const double yStart = m_Origin[1] +
+      static_cast<double>(startIndex[1])*m_Spacing[1] - m_ShearY*z;
+
+    for (unsigned int p = 0; p < N*N; p++) {
+      if (m_PupilMask[p]) {
+        pupil[p] = std::polar(1.0, k0*(m_PupilPathDifference[p] + z*m_PupilDefocus[p]));
+      } else {
+        pupil[p] = ComplexType(0.0, 0.0);
+      }
+    }
+
+    // Translating the output grid to its start position multiplies the
+    // pupil by a linear phase ramp.
+    for (unsigned int j = 0; j < N; j++) {
+      double jj = static_cast<double>(j);
+      shiftX[j] = std::polar(1.0, 2.0*pi*jj*df*xStart) * chirpX[j];
+      shiftY[j] = std::polar(1.0, 2.0*pi*jj*df*yStart) * chirpY[j];
+    }
+
+    // Transform along x for each pupil row. The phase factors that
+    // Bluestein's algorithm and the frequency offset apply to the output
+    // depend only on the output column, so they drop out of the squared
+    // magnitude and are skipped.
+    for (unsigned int k = 0; k < N; k++) {
+      workX.fill(ComplexType(0.0, 0.0));
+      for (unsigned int j = 0; j < N; j++) {
+        workX[j] = pupil[k*N + j] * shiftX[j];
+      }
+      fftX.fwd_transform(workX);
+      for (unsigned int i = 0; i < lengthX; i++) {
+        workX[i] *= kernelX[i];
+      }
+      fftX.bwd_transform(workX);
+      for (unsigned int m = 0; m < nx; m++) {
+        columns[m*N + k] = workX[m];
+      }
+    }
+
+    // Transform along y for each output column.
+    const double scale = 1.0 / (static_cast<double>(lengthX)*static_cast<double>(lengthY));
+    for (unsigned int m = 0; m < nx; m++) {
+      workY.fill(ComplexType(0.0, 0.0));
+      for (unsigned int k = 0; k < N; k++) {
+        workY[k] = columns[m*N + k] * shiftY[k];
+      }
+      fftY.fwd_transform(workY);
+      for (unsigned int i = 0; i < lengthY; i++) {
+        workY[i] *= kernelY[i];
+      }
+      fftY.bwd_transform(workY);
+      for (unsigned int n = 0; n < ny; n++) {
+        slice[n*nx + m] = std::norm(workY[n] * scale);
+      }
+    }
+
+    // Copy the slice into the output.
+    OutputImageRegionType sliceRegion = outputRegionForThread;
+    sliceRegion.SetIndex(2, startIndex[2] + iz);
+    sliceRegion.SetSize(2, 1);
+    ImageRegionIterator<TOutputImage> it(output, sliceRegion);
+    for (unsigned int i = 0; !it.IsAtEnd(); ++it, ++i) {
+      it.Set(static_cast<PixelType>(slice[i]));
+    }
+  }
+}
+
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,420 @@
+#include <itkFourierGibsonLanniPointSpreadFunctionImageSource.txx>
+#include <ITKImageToVTKImage.cxx>
+
+// WARNING: Always include the header file for this class AFTER
+// including the ITK headers. Otherwise, the ITK headers will be included
+// without including the implementation files, and you will have many linker
+// errors.
+#include <FourierGibsonLanniWidefieldPointSpreadFunction.h>
+
+#include <XMLHelper.h>
+
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::PSF_ELEMENT = "FourierGibsonLanniWidefieldPointSpreadFunction";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::EMISSION_WAVELENGTH_ATTRIBUTE = "EmissionWavelength";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::NUMERICAL_APERTURE_ATTRIBUTE = "NumericalAperture";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::DESIGN_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE = "DesignCoverSlipRefractiveIndex";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::ACTUAL_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE = "ActualCoverSlipRefractiveIndex";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::DESIGN_COVER_SLIP_THICKNESS_ATTRIBUTE = "DesignCoverSlipThickness";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::ACTUAL_COVER_SLIP_THICKNESS_ATTRIBUTE = "ActualCoverSlipThickness";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::DESIGN_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE = "DesignImmersionOilRefractiveIndex";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::ACTUAL_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE = "ActualImmersionOilRefractiveIndex";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::DESIGN_IMMERSION_OIL_THICKNESS_ATTRIBUTE = "DesignImmersionOilThickness";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX_ATTRIBUTE = "ActualSpecimenLayerRefractiveIndex";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER_ATTRIBUTE = "ActualPointSourceDepthInSpecimenLayer";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::PSF_SHEAR_IN_X_ATTRIBUTE = "PSFShearInX";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::PSF_SHEAR_IN_Y_ATTRIBUTE = "PSFShearInY";
+const std::string FourierGibsonLanniWidefieldPointSpreadFunction::PUPIL_SAMPLES_ATTRIBUTE = "PupilSamples";
+
+
+FourierGibsonLanniWidefieldPointSpreadFunction
+::FourierGibsonLanniWidefieldPointSpreadFunction() {
+  // Set up parameter names and default parameters
+  m_ParameterNames.push_back("Summed Intensity");
+  m_ParameterNames.push_back("X Size (voxels)");
+  m_ParameterNames.push_back("Y Size (voxels)");
+  m_ParameterNames.push_back("Z Size (voxels)");
+  m_ParameterNames.push_back("X Voxel Spacing (nm)");
+  m_ParameterNames.push_back("Y Voxel Spacing (nm)");
+  m_ParameterNames.push_back("Z Voxel Spacing (nm)");
+  m_ParameterNames.push_back("Emission Wavelength (nm)");
+  m_ParameterNames.push_back("Numerical Aperture");
+  m_ParameterNames.push_back("Design Cover Slip Refractive Index");
+  m_ParameterNames.push_back("Actual Cover Slip Refractive Index");
+  m_ParameterNames.push_back("Design Cover Slip Thickness (microns)");
+  m_ParameterNames.push_back("Actual Cover Slip Thickness (microns)");
+  m_ParameterNames.push_back("Design Immersion Oil Refractive Index");
+  m_ParameterNames.push_back("Actual Immersion Oil Refractive Index");
+  m_ParameterNames.push_back("Design Immersion Oil Thickness (microns)");
+  m_ParameterNames.push_back("Actual Specimen Layer Refractive Index");
+  m_ParameterNames.push_back("Actual Point Source Depth in Specimen Layer (microns)");
+  m_ParameterNames.push_back("PSF Shear in X");
+  m_ParameterNames.push_back("PSF Shear in Y");
+  m_ParameterNames.push_back("Pupil Samples");
+
+  m_FourierSource = ImageSourceType::New();
+
+  m_ITKToVTKFilter = new ITKImageToVTKImage<ImageType>();
+  m_ITKToVTKFilter->SetInput(m_FourierSource->GetOutput());
+
+  SetPSFImage(m_FourierSource->GetOutput());
+
+  RecenterImage();
+}
+
+
+FourierGibsonLanniWidefieldPointSpreadFunction
+::~FourierGibsonLanniWidefieldPointSpreadFunction() {
+  delete m_ITKToVTKFilter;
+}
+
+
+vtkImageData*
+FourierGibsonLanniWidefieldPointSpreadFunction
+::GetOutput() {
+  return m_ITKToVTKFilter->GetOutput();
+}
+
+
+vtkAlgorithmOutput*
+FourierGibsonLanniWidefieldPointSpreadFunction
+::GetOutputPort() {
+  return m_ITKToVTKFilter->GetOutputPort();
+}
+
+
+int
+FourierGibsonLanniWidefieldPointSpreadFunction
+::GetNumberOfProperties() {
+  return static_cast<int>(m_ParameterNames.size());
+}
+
+
+std::string
+FourierGibsonLanniWidefieldPointSpreadFunction
+::GetParameterName(int index) {
+  try {
+    return m_ParameterNames.at(index);
+  } catch (...) {
+  }
+
+  return std::string("Error");
+}
+
+
+double
+FourierGibsonLanniWidefieldPointSpreadFunction
+::GetParameterValue(int index) {
+  switch (index) {
+  case  0: return m_SummedIntensity;
+  case  1: return m_FourierSource->GetSize()[0]; break;
+  case  2: return m_FourierSource->GetSize()[1]; break;
+  case  3: return m_FourierSource->GetSize()[2]; break;
+  case  4: return m_FourierSource->GetSpacing()[0]; break;
+  case  5: return m_FourierSource->GetSpacing()[1]; break;
+  case  6: return m_FourierSource->GetSpacing()[2]; break;
+  case  7: return m_FourierSource->GetEmissionWavelength(); break;
+  case  8: return m_FourierSource->GetNumericalAperture(); break;
+  case  9: return m_FourierSource->GetDesignCoverSlipRefractiveIndex(); break;
+  case 10: return m_FourierSource->GetActualCoverSlipRefractiveIndex(); break;
+  case 11: return m_FourierSource->GetDesignCoverSlipThickness(); break;
+  case 12: return m_FourierSource->GetActualCoverSlipThickness(); break;
+  case 13: return m_FourierSource->GetDesignImmersionOilRefractiveIndex(); break;
+  case 14: return m_FourierSource->GetActualImmersionOilRefractiveIndex(); break;
+  case 15: return m_FourierSource->GetDesignImmersionOilThickness(); break;
+  case 16: return m_FourierSource->GetActualSpecimenLayerRefractiveIndex(); break;
+  case 17: return m_FourierSource->GetActualPointSourceDepthInSpecimenLayer(); break;
+  case 18: return m_FourierSource->GetShearX(); break;
+  case 19: return m_FourierSource->GetShearY(); break;
+  case 20: return m_FourierSource->GetNumberOfPupilSamples(); break;
+
+  default: return 0.0;
+  }
+
+  return 0.0;
+}
+
+
+void
+FourierGibsonLanniWidefieldPointSpreadFunction
+::SetParameterValue(int index, double value) {
+  ImageSourceType::SizeType size = m_FourierSource->GetSize();
+  ImageSourceType::SpacingType spacing = m_FourierSource->GetSpacing();
+
+  switch (index) {
+  case 0:
+    SetSummedIntensity(value);
+    break;
+
+  case 1:
+  case 2:
+  case 3:
+    size[index-1] = static_cast<ImageSourceType::SizeValueType>(value);
+    m_FourierSource->SetSize(size);
+    RecenterImage();
+    break;
+
+  case 4:
+  case 5:
+  case 6:
+    spacing[index-4] = static_cast<ImageSourceType::SpacingType::ValueType>(value);
+    m_FourierSource->SetSpacing(spacing);
+    RecenterImage();
+    break;
+
+  case 7:
+    m_FourierSource->SetEmissionWavelength(value);
+    break;
+
+  case 8:
+    m_FourierSource->SetNumericalAperture(value);
+    break;
+
+  case 9:
+    m_FourierSource->SetDesignCoverSlipRefractiveIndex(value);
+    break;
+
+  case 10:
+    m_FourierSource->SetActualCoverSlipRefractiveIndex(value);
+    break;
+
+  case 11:
+    m_FourierSource->SetDesignCoverSlipThickness(value);
+    break;
+
+  case 12:
+    m_FourierSource->SetActualCoverSlipThickness(value);
+    break;
+
+  case 13:
+    m_FourierSource->SetDesignImmersionOilRefractiveIndex(value);
+    break;
+
+  case 14:
+    m_FourierSource->SetActualImmersionOilRefractiveIndex(value);
+    break;
+
+  case 15:
+    m_FourierSource->SetDesignImmersionOilThickness(value);
+    break;
+
+  case 16:
+    m_FourierSource->SetActualSpecimenLayerRefractiveIndex(value);
+    break;
+
+  case 17:
+    m_FourierSource->SetActualPointSourceDepthInSpecimenLayer(value);
+    break;
+
+  case 18:
+    m_FourierSource->SetShearX(value);
+    break;
+
+  case 19:
+    m_FourierSource->SetShearY(value);
+    break;
+
+  case 20:
+    m_FourierSource->SetNumberOfPupilSamples(static_cast<unsigned int>(value));
+    break;
+
+  default:
+    break;
+  }
+
+}
+
+
+void
+FourierGibsonLanniWidefieldPointSpreadFunction
+::RecenterImage() {
+  ImageSourceType::SpacingType spacing = m_FourierSource->GetSpacing();
+  ImageSourceType::SizeType size = m_FourierSource->GetSize();
+
+  ImageSourceType::PointType origin;
+  for (int i = 0; i < 3; i++) {
+  origin[i] = -0.5 * static_cast<ImageSourceType::SpacingType::ValueType>
+    (size[i]-1) * spacing[i];
+  }
+
+  m_FourierSource->SetOrigin(origin);
+}
+
+
+void
+FourierGibsonLanniWidefieldPointSpreadFunction
+::GetXMLConfiguration(xmlNodePtr node) {
+  xmlNodePtr root = xmlNewChild(node, NULL, BAD_CAST PSF_ELEMENT.c_str(), NULL);
+
+  char intFormat[] = "%d";
+  char doubleFormat[] = "%f";
+  char buf[128];
+
+  xmlNewProp(root, BAD_CAST NAME_ATTRIBUTE.c_str(), BAD_CAST m_Name.c_str());
+  sprintf(buf, "%f", GetSummedIntensity());
+  xmlNewProp(root, BAD_CAST SUMMED_INTENSITY_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  xmlNodePtr sizeNode = xmlNewChild(root, NULL, BAD_CAST SIZE_ELEMENT.c_str(), NULL);
+  sprintf(buf, intFormat, m_FourierSource->GetSize()[0]);
+  xmlNewProp(sizeNode, BAD_CAST X_ATTRIBUTE.c_str(), BAD_CAST buf);
+  sprintf(buf, intFormat, m_FourierSource->GetSize()[1]);
+  xmlNewProp(sizeNode, BAD_CAST Y_ATTRIBUTE.c_str(), BAD_CAST buf);
+  sprintf(buf, intFormat, m_FourierSource->GetSize()[2]);
+  xmlNewProp(sizeNode, BAD_CAST Z_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  xmlNodePtr spacingNode = xmlNewChild(root, NULL, BAD_CAST SPACING_ELEMENT.c_str(), NULL);
+  sprintf(buf, doubleFormat, m_FourierSource->GetSpacing()[0]);
+  xmlNewProp(spacingNode, BAD_CAST X_ATTRIBUTE.c_str(), BAD_CAST buf);
+  sprintf(buf, doubleFormat, m_FourierSource->GetSpacing()[1]);
+  xmlNewProp(spacingNode, BAD_CAST Y_ATTRIBUTE.c_str(), BAD_CAST buf);
+  sprintf(buf, doubleFormat, m_FourierSource->GetSpacing()[2]);
+  xmlNewProp(spacingNode, BAD_CAST Z_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetEmissionWavelength());
+  xmlNewProp(root, BAD_CAST EMISSION_WAVELENGTH_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetNumericalAperture());
+  xmlNewProp(root, BAD_CAST NUMERICAL_APERTURE_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetDesignCoverSlipRefractiveIndex());
+  xmlNewProp(root, BAD_CAST DESIGN_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetActualCoverSlipRefractiveIndex());
+  xmlNewProp(root, BAD_CAST ACTUAL_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetDesignCoverSlipThickness());
+  xmlNewProp(root, BAD_CAST DESIGN_COVER_SLIP_THICKNESS_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetActualCoverSlipThickness());
+  xmlNewProp(root, BAD_CAST ACTUAL_COVER_SLIP_THICKNESS_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetDesignImmersionOilRefractiveIndex());
+  xmlNewProp(root, BAD_CAST DESIGN_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetActualImmersionOilRefractiveIndex());
+  xmlNewProp(root, BAD_CAST ACTUAL_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetDesignImmersionOilThickness());
+  xmlNewProp(root, BAD_CAST DESIGN_IMMERSION_OIL_THICKNESS_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetActualSpecimenLayerRefractiveIndex());
+  xmlNewProp(root, BAD_CAST ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetActualPointSourceDepthInSpecimenLayer());
+  xmlNewProp(root, BAD_CAST ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetShearX());
+  xmlNewProp(root, BAD_CAST PSF_SHEAR_IN_X_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, doubleFormat, m_FourierSource->GetShearY());
+  xmlNewProp(root, BAD_CAST PSF_SHEAR_IN_Y_ATTRIBUTE.c_str(), BAD_CAST buf);
+
+  sprintf(buf, intFormat, m_FourierSource->GetNumberOfPupilSamples());
+  xmlNewProp(root, BAD_CAST PUPIL_SAMPLES_ATTRIBUTE.c_str(), BAD_CAST buf);
+}
+
+
+void
+FourierGibsonLanniWidefieldPointSpreadFunction
+::RestoreFromXML(xmlNodePtr node) {
+  const char* name =
+    (const char*) xmlGetProp(node, BAD_CAST NAME_ATTRIBUTE.c_str());
+  SetName(name);
+
+  char* summedIntensityStr = (char*) xmlGetProp(node, BAD_CAST SUMMED_INTENSITY_ATTRIBUTE.c_str());
+  if (summedIntensityStr) {
+    SetSummedIntensity(atof(summedIntensityStr));
+  }
+
+  ImageSourceType::SizeType size;
+  xmlNodePtr sizeNode = xmlGetFirstElementChildWithName(node, BAD_CAST SIZE_ELEMENT.c_str());
+  size[0] = atoi((const char*) xmlGetProp(sizeNode, BAD_CAST X_ATTRIBUTE.c_str()));
+  size[1] = atoi((const char*) xmlGetProp(sizeNode, BAD_CAST Y_ATTRIBUTE.c_str()));
+  size[2] = atoi((const char*) xmlGetProp(sizeNode, BAD_CAST Z_ATTRIBUTE.c_str()));
+  m_FourierSource->SetSize(size);
+
+  ImageSourceType::SpacingType spacing;
+  xmlNodePtr spacingNode = xmlGetFirstElementChildWithName(node, BAD_CAST SPACING_ELEMENT.c_str());
+  spacing[0] = atof((const char*) xmlGetProp(spacingNode, BAD_CAST X_ATTRIBUTE.c_str()));
+  spacing[1] = atof((const char*) xmlGetProp(spacingNode, BAD_CAST Y_ATTRIBUTE.c_str()));
+  spacing[2] = atof((const char*) xmlGetProp(spacingNode, BAD_CAST Z_ATTRIBUTE.c_str()));
+  m_FourierSource->SetSpacing(spacing);
+
+  const char* attribute;
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST EMISSION_WAVELENGTH_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetEmissionWavelength(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST NUMERICAL_APERTURE_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetNumericalAperture(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST DESIGN_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetDesignCoverSlipRefractiveIndex(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST ACTUAL_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetActualCoverSlipRefractiveIndex(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST DESIGN_COVER_SLIP_THICKNESS_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetDesignCoverSlipThickness(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST ACTUAL_COVER_SLIP_THICKNESS_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetActualCoverSlipThickness(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST DESIGN_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetDesignImmersionOilRefractiveIndex(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST ACTUAL_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetActualImmersionOilRefractiveIndex(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST DESIGN_IMMERSION_OIL_THICKNESS_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetDesignImmersionOilThickness(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetActualSpecimenLayerRefractiveIndex(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetActualPointSourceDepthInSpecimenLayer(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST PSF_SHEAR_IN_X_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetShearX(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST PSF_SHEAR_IN_Y_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetShearY(atof(attribute));
+  }
+
+  attribute = (const char*) xmlGetProp(node, BAD_CAST PUPIL_SAMPLES_ATTRIBUTE.c_str());
+  if (attribute) {
+    m_FourierSource->SetNumberOfPupilSamples(atoi(attribute));
+  }
+
+  RecenterImage();
+
+  m_FourierSource->Update();
+
+  // It is critical to call this to ensure that the PSF is normalized after loading
+  Update();
+}
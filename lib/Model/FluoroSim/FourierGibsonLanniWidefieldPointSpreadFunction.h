@@ -0,0 +1,67 @@
+#ifndef _FOURIER_GIBSON_LANNI_WIDEFIELD_POINT_SPREAD_FUNCTION_H_
+#define _FOURIER_GIBSON_LANNI_WIDEFIELD_POINT_SPREAD_FUNCTION_H_
+
+#include <vector>
+
+#define ITK_MANUAL_INSTANTIATION
+#include <itkFourierGibsonLanniPointSpreadFunctionImageSource.h>
+#include <ITKImageToVTKImage.h>
+#undef ITK_MANUAL_INSTANTIATION
+
+
+#include <PointSpreadFunction.h>
+
+
+// Gibson-Lanni widefield PSF computed by Fourier synthesis from a
+// sampled pupil function rather than by numerical quadrature. Much
+// faster than GibsonLanniWidefieldPointSpreadFunction for PSFs with
+// large lateral size.
+class FourierGibsonLanniWidefieldPointSpreadFunction : public PointSpreadFunction {
+
+ public:
+  static const std::string PSF_ELEMENT;
+  static const std::string EMISSION_WAVELENGTH_ATTRIBUTE;
+  static const std::string NUMERICAL_APERTURE_ATTRIBUTE;
+  static const std::string DESIGN_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE;
+  static const std::string ACTUAL_COVER_SLIP_REFRACTIVE_INDEX_ATTRIBUTE;
+  static const std::string DESIGN_COVER_SLIP_THICKNESS_ATTRIBUTE;
+  static const std::string ACTUAL_COVER_SLIP_THICKNESS_ATTRIBUTE;
+  static const std::string DESIGN_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE;
+  static const std::string ACTUAL_IMMERSION_OIL_REFRACTIVE_INDEX_ATTRIBUTE;
+  static const std::string DESIGN_IMMERSION_OIL_THICKNESS_ATTRIBUTE;
+  static const std::string ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX_ATTRIBUTE;
+  static const std::string ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER_ATTRIBUTE;
+  static const std::string PSF_SHEAR_IN_X_ATTRIBUTE;
+  static const std::string PSF_SHEAR_IN_Y_ATTRIBUTE;
+  static const std::string PUPIL_SAMPLES_ATTRIBUTE;
+
+
+  FourierGibsonLanniWidefieldPointSpreadFunction();
+  virtual ~FourierGibsonLanniWidefieldPointSpreadFunction();
+
+  virtual vtkImageData*       GetOutput();
+  virtual vtkAlgorithmOutput* GetOutputPort();
+
+  virtual int         GetNumberOfProperties();
+  virtual std::string GetParameterName(int index);
+  virtual double      GetParameterValue(int index);
+  virtual void        SetParameterValue(int index, double value);
+
+  virtual void GetXMLConfiguration(xmlNodePtr node);
+  virtual void RestoreFromXML(xmlNodePtr node);
+
+  typedef float                                     PixelType;
+  typedef itk::Image<PixelType, 3>                  ImageType;
+  typedef itk::FourierGibsonLanniPointSpreadFunctionImageSource<ImageType> ImageSourceType;
+  typedef ImageSourceType::Pointer                  ImageSourceTypePointer;
+
+ protected:
+  ImageSourceTypePointer    m_FourierSource;
+  ITKImageToVTKImage<ImageType>* m_ITKToVTKFilter;
+
+  std::vector<std::string> m_ParameterNames;
+
+  void RecenterImage();
+};
+
+#endif // _FOURIER_GIBSON_LANNI_WIDEFIELD_POINT_SPREAD_FUNCTION_H_
@@ -49,16 +49,10 @@ GaussianPointSpreadFunction
   double mean[3] = {0.0, 0.0, 0.0};
   m_GaussianSource->SetMean(mean);
 
-  m_Statistics->SetInput(m_GaussianSource->GetOutput());
-
-  m_ScaleFilter->SetInput(m_GaussianSource->GetOutput());
-
   m_ITKToVTKFilter = new ITKImageToVTKImage<ImageType>();
-  m_ITKToVTKFilter->SetInput(m_ScaleFilter->GetOutput());
+  m_ITKToVTKFilter->SetInput(m_GaussianSource->GetOutput());
 
-  m_DerivativeX->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeY->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeZ->SetInput(m_ScaleFilter->GetOutput());
+  SetPSFImage(m_GaussianSource->GetOutput());
 
   RecenterImage();
 }
@@ -138,7 +132,7 @@ GaussianPointSpreadFunction
 
   switch (index) {
   case 0:
-    m_SummedIntensity = value;
+    SetSummedIntensity(value);
     break;
 
   case 1:
@@ -55,16 +55,10 @@ GibsonLanniWidefieldPointSpreadFunction
 
   m_GibsonLanniSource = ImageSourceType::New();
 
-  m_Statistics->SetInput(m_GibsonLanniSource->GetOutput());
-
-  m_ScaleFilter->SetInput(m_GibsonLanniSource->GetOutput());
-
   m_ITKToVTKFilter = new ITKImageToVTKImage<ImageType>();
-  m_ITKToVTKFilter->SetInput(m_ScaleFilter->GetOutput());
+  m_ITKToVTKFilter->SetInput(m_GibsonLanniSource->GetOutput());
 
-  m_DerivativeX->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeY->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeZ->SetInput(m_ScaleFilter->GetOutput());
+  SetPSFImage(m_GibsonLanniSource->GetOutput());
 
   RecenterImage();
 }
@@ -90,6 +84,13 @@ GibsonLanniWidefieldPointSpreadFunction
 }
 
 
+void
+GibsonLanniWidefieldPointSpreadFunction
+::SetNumberOfWorkUnits(unsigned int units) {
+  m_GibsonLanniSource->SetNumberOfWorkUnits(units);
+}
+
+
 int
 GibsonLanniWidefieldPointSpreadFunction
 ::GetNumberOfProperties() {
@@ -151,7 +152,7 @@ GibsonLanniWidefieldPointSpreadFunction
 
   switch (index) {
   case 0:
-    m_SummedIntensity = value;
+    SetSummedIntensity(value);
     break;
 
   case 1:
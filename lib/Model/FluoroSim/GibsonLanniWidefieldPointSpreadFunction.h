@@ -44,6 +44,10 @@ class GibsonLanniWidefieldPointSpreadFunction : public PointSpreadFunction {
   virtual double      GetParameterValue(int index);
   virtual void        SetParameterValue(int index, double value);
 
+  // Limits the number of ITK work units used to compute the PSF image,
+  // e.g. to one when several PSFs are computed in parallel.
+  void SetNumberOfWorkUnits(unsigned int units);
+
   virtual void GetXMLConfiguration(xmlNodePtr node);
   virtual void RestoreFromXML(xmlNodePtr node);
 
@@ -52,16 +52,10 @@ HaeberleWidefieldPointSpreadFunction
 
   m_HaeberleSource = ImageSourceType::New();
 
-  m_Statistics->SetInput(m_HaeberleSource->GetOutput());
-
-  m_ScaleFilter->SetInput(m_HaeberleSource->GetOutput());
-
   m_ITKToVTKFilter = new ITKImageToVTKImage<ImageType>();
-  m_ITKToVTKFilter->SetInput(m_ScaleFilter->GetOutput());
+  m_ITKToVTKFilter->SetInput(m_HaeberleSource->GetOutput());
 
-  m_DerivativeX->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeY->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeZ->SetInput(m_ScaleFilter->GetOutput());
+  SetPSFImage(m_HaeberleSource->GetOutput());
 
   RecenterImage();
 }
@@ -147,7 +141,7 @@ HaeberleWidefieldPointSpreadFunction
 
   switch (index) {
   case 0:
-    m_SummedIntensity = value;
+    SetSummedIntensity(value);
     break;
 
   case 1: case 2: case 3:
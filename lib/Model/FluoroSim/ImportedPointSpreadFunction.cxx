@@ -6,7 +6,6 @@
 #include <vtkImageChangeInformation.h>
 
 #include <itkCastImageFilter.h>
-#include <itkChangeInformationImageFilter.hxx>
 #include <itkImageFileReader.hxx>
 #include <itkBinaryGeneratorImageFilter.hxx> // Needed for AddConstantToImageFilter
 #include <ITKImageToVTKImage.cxx>
@@ -45,36 +44,23 @@ ImportedPointSpreadFunction
 
   m_FileIsValid = false;
 
-  m_ChangeInformationFilter = ChangeInfoFilterType::New();
-  m_ChangeInformationFilter->ChangeDirectionOff();
-  m_ChangeInformationFilter->ChangeOriginOn();
-  m_ChangeInformationFilter->ChangeRegionOff();
-  m_ChangeInformationFilter->ChangeSpacingOn();
-  ImageType::SpacingType spacing;
-  spacing[0] = 65.0;
-  spacing[1] = 65.0;
-  spacing[2] = 200.0;
-  m_ChangeInformationFilter->SetOutputSpacing(spacing);
-  ImageType::PointType origin;
-  origin[0] = 0.0;
-  origin[1] = 0.0;
-  origin[2] = 0.0;
-  m_ChangeInformationFilter->SetOutputOrigin(origin);
+  m_Spacing[0] = 65.0;
+  m_Spacing[1] = 65.0;
+  m_Spacing[2] = 200.0;
+
+  // Empty until a file is read
+  m_Image = ImageType::New();
 
+  // Not in place, so the file image keeps its raw pixels
   m_AddConstantFilter = AddConstantFilterType::New();
-  m_AddConstantFilter->SetInput(m_ChangeInformationFilter->GetOutput());
+  m_AddConstantFilter->InPlaceOff();
+  m_AddConstantFilter->SetInput(m_Image);
   m_AddConstantFilter->SetConstant2(m_IntensityOffset);
 
-  m_Statistics->SetInput(m_AddConstantFilter->GetOutput());
-
-  m_ScaleFilter->SetInput(m_AddConstantFilter->GetOutput());
-
   m_ITKToVTKFilter = new ITKImageToVTKImage<ImageType>();
-  m_ITKToVTKFilter->SetInput(m_ScaleFilter->GetOutput());
+  m_ITKToVTKFilter->SetInput(m_AddConstantFilter->GetOutput());
 
-  m_DerivativeX->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeY->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeZ->SetInput(m_ScaleFilter->GetOutput());
+  SetPSFImage(m_AddConstantFilter->GetOutput());
 }
 
 
@@ -88,8 +74,9 @@ void
 ImportedPointSpreadFunction
 ::SetFileName(const std::string& fileName) {
   m_FileName = fileName;
-  this->ReadFile();
-  m_ChangeInformationFilter->UpdateLargestPossibleRegion();
+  if (this->ReadFile()) {
+    RecenterImage();
+  }
 }
 
 
@@ -118,7 +105,6 @@ ImportedPointSpreadFunction
 vtkImageData*
 ImportedPointSpreadFunction
 ::GetOutput() {
-  m_ChangeInformationFilter->UpdateLargestPossibleRegion();
   m_ITKToVTKFilter->Modified();
   return m_ITKToVTKFilter->GetOutput();
 }
@@ -127,7 +113,6 @@ ImportedPointSpreadFunction
 vtkAlgorithmOutput*
 ImportedPointSpreadFunction
 ::GetOutputPort() {
-  m_ChangeInformationFilter->UpdateLargestPossibleRegion();
   m_ITKToVTKFilter->Modified();
   return m_ITKToVTKFilter->GetOutputPort();
 }
@@ -161,9 +146,9 @@ ImportedPointSpreadFunction
   case  2: return m_Image->GetLargestPossibleRegion().GetSize()[0]; break;
   case  3: return m_Image->GetLargestPossibleRegion().GetSize()[1]; break;
   case  4: return m_Image->GetLargestPossibleRegion().GetSize()[2]; break;
-  case  5: return m_ChangeInformationFilter->GetOutputSpacing()[0]; break;
-  case  6: return m_ChangeInformationFilter->GetOutputSpacing()[1]; break;
-  case  7: return m_ChangeInformationFilter->GetOutputSpacing()[2]; break;
+  case  5: return m_Spacing[0]; break;
+  case  6: return m_Spacing[1]; break;
+  case  7: return m_Spacing[2]; break;
   case  8: return m_PointCenter[0]; break;
   case  9: return m_PointCenter[1]; break;
   case 10: return m_PointCenter[2]; break;
@@ -178,19 +163,13 @@ ImportedPointSpreadFunction
 void
 ImportedPointSpreadFunction
 ::SetParameterValue(int index, double value) {
-  ImageType::SpacingType outputSpacing = 
-    m_ChangeInformationFilter->GetOutputSpacing();
-  ImageType::PointType outputOrigin =
-    m_ChangeInformationFilter->GetOutputOrigin();
-
   switch(index) {
   case  0:
-    m_SummedIntensity = value;
+    SetSummedIntensity(value);
     break;
 
   case  1:
-    m_IntensityOffset = value;
-    m_AddConstantFilter->SetConstant2(value);
+    SetIntensityOffset(value);
     break;
 
   case  2:
@@ -201,8 +180,7 @@ ImportedPointSpreadFunction
   case  5:
   case  6:
   case  7:
-    outputSpacing[index-5] = value;
-    m_ChangeInformationFilter->SetOutputSpacing(outputSpacing);
+    m_Spacing[index-5] = value;
     RecenterImage();
     break;
     
@@ -240,11 +218,11 @@ ImportedPointSpreadFunction
   xmlNewProp(root, BAD_CAST INTENSITY_OFFSET_ATTRIBUTE.c_str(), BAD_CAST buf);
 
   xmlNodePtr spacingNode = xmlNewChild(root, NULL, BAD_CAST SPACING_ELEMENT.c_str(), NULL);
-  sprintf(buf, doubleFormat, m_ChangeInformationFilter->GetOutputSpacing()[0]);
+  sprintf(buf, doubleFormat, m_Spacing[0]);
   xmlNewProp(spacingNode, BAD_CAST X_ATTRIBUTE.c_str(), BAD_CAST buf);
-  sprintf(buf, doubleFormat, m_ChangeInformationFilter->GetOutputSpacing()[1]);
+  sprintf(buf, doubleFormat, m_Spacing[1]);
   xmlNewProp(spacingNode, BAD_CAST Y_ATTRIBUTE.c_str(), BAD_CAST buf);
-  sprintf(buf, doubleFormat, m_ChangeInformationFilter->GetOutputSpacing()[2]);
+  sprintf(buf, doubleFormat, m_Spacing[2]);
   xmlNewProp(spacingNode, BAD_CAST Z_ATTRIBUTE.c_str(), BAD_CAST buf);
 
   xmlNodePtr pointCenterNode = xmlNewChild(root, NULL, BAD_CAST POINT_CENTER_ELEMENT.c_str(), NULL);
@@ -290,11 +268,9 @@ ImportedPointSpreadFunction
     char* y = (char*) xmlGetProp(spacingNode, BAD_CAST Y_ATTRIBUTE.c_str());
     char* z = (char*) xmlGetProp(spacingNode, BAD_CAST Z_ATTRIBUTE.c_str());
     if (x && y && z) {
-      double spacing[3];
-      spacing[0] = atof(x);
-      spacing[1] = atof(y);
-      spacing[2] = atof(z);
-      m_ChangeInformationFilter->SetOutputSpacing(spacing);
+      m_Spacing[0] = atof(x);
+      m_Spacing[1] = atof(y);
+      m_Spacing[2] = atof(z);
     }
   }
 
@@ -320,17 +296,16 @@ ImportedPointSpreadFunction
 void
 ImportedPointSpreadFunction
 ::RecenterImage() {
-  // Change the origin here
-  const ImageType::RegionType region = m_ChangeInformationFilter->GetOutput()->GetLargestPossibleRegion();
-  const ImageType::SpacingType spacing = m_ChangeInformationFilter->GetOutputSpacing();
+  // Change the spacing and origin of the image itself. This touches only
+  // the image meta data, not the pixels.
+  const ImageType::RegionType region = m_Image->GetLargestPossibleRegion();
 
   ImageType::PointType origin;
   for (unsigned int i = 0; i < ImageType::GetImageDimension(); i++) {
-    origin[i] = -0.5 * static_cast<double>(region.GetSize(i)-1) * spacing[i] + m_PointCenter[i];
+    origin[i] = -0.5 * static_cast<double>(region.GetSize(i)-1) * m_Spacing[i] + m_PointCenter[i];
   }
-  m_ChangeInformationFilter->SetOutputOrigin(origin);
-
-  m_ChangeInformationFilter->UpdateLargestPossibleRegion();
+  m_Image->SetSpacing(m_Spacing);
+  m_Image->SetOrigin(origin);
 }
 
 
@@ -348,9 +323,16 @@ ImportedPointSpreadFunction
     typedef itk::CastImageFilter< FileImageType, ImageType > CastFilterType;
     typename CastFilterType::Pointer caster = CastFilterType::New();
     caster->SetInput( reader->GetOutput() );
-    m_ChangeInformationFilter->SetInput( caster->GetOutput() );
-    m_ChangeInformationFilter->UpdateLargestPossibleRegion();
-    m_Image = m_ChangeInformationFilter->GetOutput();
+    caster->InPlaceOn(); // Reuses the reader's buffer for float files
+    caster->UpdateLargestPossibleRegion();
+
+    // Keep the cast image on its own; the reader and caster release
+    // their references when they go out of scope.
+    m_Image = caster->GetOutput();
+    m_Image->DisconnectPipeline();
+    m_Image->SetSpacing(m_Spacing);
+
+    m_AddConstantFilter->SetInput(m_Image);
   } catch ( itk::ExceptionObject & except ) {
     std::cerr << "Could not read file '" << m_FileName << "'" << std::endl;
     std::cerr << except << std::endl;
@@ -4,7 +4,6 @@
 #include <vector>
 
 #define ITK_MANUAL_INSTANTIATION
-#include <itkChangeInformationImageFilter.h>
 #include <itkImageFileReader.h>
 #include <itkAddImageFilter.h>
 #include <ITKImageToVTKImage.h>
@@ -49,10 +48,9 @@ class ImportedPointSpreadFunction : public PointSpreadFunction {
   //typedef itk::Image<PixelType, 3>                  ImageType;
   typedef PointSpreadFunction::ImageType               ImageType;
   typedef itk::ImageFileReader<ImageType>              ImageSourceType;
-  typedef itk::ChangeInformationImageFilter<ImageType> ChangeInfoFilterType;
   typedef itk::AddImageFilter<ImageType, ImageType, ImageType>
     AddConstantFilterType;
-  
+
  protected:
   std::vector<std::string> m_ParameterNames;
 
@@ -61,13 +59,19 @@ class ImportedPointSpreadFunction : public PointSpreadFunction {
   double      m_IntensityOffset;
   double      m_PointCenter[3];
 
-  ImageType::Pointer m_Image;
+  ImageType::SpacingType m_Spacing;
 
-  ITKImageToVTKImage<ImageType>* m_ITKToVTKFilter;
+  // Image read from the file. Spacing and origin are set on this image
+  // directly; its pixels are never changed.
+  ImageType::Pointer m_Image;
 
-  ChangeInfoFilterType::Pointer  m_ChangeInformationFilter;
+  // Adds the intensity offset to the file image. Its output is the PSF
+  // image, so each change to the offset or the summed intensity
+  // renormalizes from the file pixels.
   AddConstantFilterType::Pointer m_AddConstantFilter;
 
+  ITKImageToVTKImage<ImageType>* m_ITKToVTKFilter;
+
   void RecenterImage();
 
   template< class TPixel >
@@ -70,16 +70,10 @@ ModifiedGibsonLanniWidefieldPointSpreadFunction
   ImageSourceType::SpacingType spacing; spacing.Fill(65.0); spacing[2] = 100.0;
   m_ModifiedGibsonLanniSource->SetSpacing(spacing);
 
-  m_Statistics->SetInput(m_ModifiedGibsonLanniSource->GetOutput());
-
-  m_ScaleFilter->SetInput(m_ModifiedGibsonLanniSource->GetOutput());
-
   m_ITKToVTKFilter = new ITKImageToVTKImage<ImageType>();
-  m_ITKToVTKFilter->SetInput(m_ScaleFilter->GetOutput());
+  m_ITKToVTKFilter->SetInput(m_ModifiedGibsonLanniSource->GetOutput());
 
-  m_DerivativeX->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeY->SetInput(m_ScaleFilter->GetOutput());
-  m_DerivativeZ->SetInput(m_ScaleFilter->GetOutput());
+  SetPSFImage(m_ModifiedGibsonLanniSource->GetOutput());
 
   RecenterImage();
 }
@@ -156,7 +150,7 @@ ModifiedGibsonLanniWidefieldPointSpreadFunction
 
   switch (index) {
   case 0:
-    m_SummedIntensity = value;
+    SetSummedIntensity(value);
     break;
 
   case 1:
@@ -1,6 +1,4 @@
 #include <itkRecursiveGaussianImageFilter.h>
-#include <itkStatisticsImageFilter.h>
-#include <itkShiftScaleImageFilter.h>
 
 #include <ITKImageToVTKImage.h>
 
@@ -26,9 +24,10 @@ PointSpreadFunction
   SetSummedIntensity(1.0);
   SetSigma(200.0);
 
-  m_Statistics = StatisticsType::New();
-  
-  m_ScaleFilter = ScaleFilterType::New();
+  m_NormalizeObserverTag = 0;
+
+  m_PyramidTime = 0;
+  m_PyramidSummedIntensity = 0.0;
 
   m_DerivativeX = DerivativeFilterType::New();
   m_DerivativeX->SetDirection(0);
@@ -60,9 +59,17 @@ PointSpreadFunction
 
 PointSpreadFunction
 ::~PointSpreadFunction() {
+  if (m_PSFSource) {
+    m_PSFSource->RemoveObserver(m_NormalizeObserverTag);
+  }
+
   delete m_VTKDerivativeX;
   delete m_VTKDerivativeY;
   delete m_VTKDerivativeZ;
+
+  for (size_t i = 0; i < m_VTKPyramidImages.size(); i++) {
+    delete m_VTKPyramidImages[i];
+  }
 }
 
 
@@ -83,16 +90,12 @@ PointSpreadFunction
 void
 PointSpreadFunction
 ::Update() {
-  try {
-    m_Statistics->Update();
-  } catch ( itk::ExceptionObject & except ) {
-    std::cerr << except << std::endl;
-  }
-  double sum = m_Statistics->GetSum();
-  if ( sum > 0.0 ) {
-    m_ScaleFilter->SetScale(m_SummedIntensity / sum);
-  } else {
-    m_ScaleFilter->SetScale(1.0);
+  if (m_PSFImage) {
+    try {
+      m_PSFImage->UpdateLargestPossibleRegion();
+    } catch ( itk::ExceptionObject & except ) {
+      std::cerr << except << std::endl;
+    }
   }
   UpdateGradientImage();
 }
@@ -112,10 +115,66 @@ PointSpreadFunction
 }
 
 
+int
+PointSpreadFunction
+::GetNumberOfPyramidLevels() {
+  if (!m_PSFImage) {
+    return 1;
+  }
+
+  // Count halvings until every dimension is a single voxel
+  ImageType::SizeType size = m_PSFImage->GetLargestPossibleRegion().GetSize();
+  int levels = 1;
+  while (size[0] > 1 || size[1] > 1 || size[2] > 1) {
+    for (unsigned int i = 0; i < ImageType::GetImageDimension(); i++) {
+      size[i] = (size[i] + 1) / 2;
+    }
+    levels++;
+  }
+
+  return levels;
+}
+
+
+vtkImageData*
+PointSpreadFunction
+::GetPyramidLevelOutput(int level) {
+  if (level >= GetNumberOfPyramidLevels())
+    level = GetNumberOfPyramidLevels() - 1;
+  if (level <= 0) {
+    return GetOutput();
+  }
+
+  UpdatePyramid(level);
+
+  return m_VTKPyramidImages[level-1]->GetOutput();
+}
+
+
+vtkAlgorithmOutput*
+PointSpreadFunction
+::GetPyramidLevelOutputPort(int level) {
+  if (level >= GetNumberOfPyramidLevels())
+    level = GetNumberOfPyramidLevels() - 1;
+  if (level <= 0) {
+    return GetOutputPort();
+  }
+
+  UpdatePyramid(level);
+
+  return m_VTKPyramidImages[level-1]->GetOutputPort();
+}
+
+
 void
 PointSpreadFunction
 ::SetSummedIntensity(double intensity) {
   m_SummedIntensity = intensity;
+
+  // Regenerate the PSF so that it is normalized from raw values.
+  if (m_PSFSource) {
+    m_PSFSource->Modified();
+  }
 }
 
 
@@ -140,6 +199,204 @@ PointSpreadFunction
 }
 
 
+void
+PointSpreadFunction
+::SetPSFImage(ImageType* image) {
+  if (m_PSFSource) {
+    m_PSFSource->RemoveObserver(m_NormalizeObserverTag);
+    m_PSFSource = NULL;
+  }
+
+  m_PSFImage = image;
+  if (image && image->GetSource()) {
+    NormalizeCommandType::Pointer command = NormalizeCommandType::New();
+    command->SetCallbackFunction(this, &PointSpreadFunction::NormalizeImage);
+    m_PSFSource = image->GetSource();
+    m_NormalizeObserverTag = m_PSFSource->AddObserver(itk::EndEvent(), command);
+    m_PSFSource->Modified();
+  }
+
+  m_DerivativeX->SetInput(image);
+  m_DerivativeY->SetInput(image);
+  m_DerivativeZ->SetInput(image);
+}
+
+
+void
+PointSpreadFunction
+::NormalizeImage() {
+  PixelType* buffer = m_PSFImage->GetBufferPointer();
+  if (!buffer) {
+    return;
+  }
+  size_t numPixels = m_PSFImage->GetBufferedRegion().GetNumberOfPixels();
+
+  double sum = 0.0;
+  for (size_t i = 0; i < numPixels; i++) {
+    sum += buffer[i];
+  }
+
+  // Leave the raw image alone if it cannot be normalized.
+  if (sum <= 0.0 || m_SummedIntensity <= 0.0) {
+    return;
+  }
+
+  double scale = m_SummedIntensity / sum;
+  for (size_t i = 0; i < numPixels; i++) {
+    buffer[i] = static_cast<PixelType>(buffer[i] * scale);
+  }
+}
+
+
+void
+PointSpreadFunction
+::UpdatePyramid(int level) {
+  try {
+    m_PSFImage->UpdateLargestPossibleRegion();
+  } catch ( itk::ExceptionObject & except ) {
+    std::cerr << except << std::endl;
+    return;
+  }
+
+  // Regeneration, including renormalization, updates the image and a
+  // change to its meta data modifies it, so either one invalidates the
+  // cached levels.
+  itk::ModifiedTimeType imageTime = m_PSFImage->GetMTime();
+  if (m_PSFImage->GetUpdateMTime() > imageTime)
+    imageTime = m_PSFImage->GetUpdateMTime();
+
+  if (imageTime != m_PyramidTime || m_SummedIntensity != m_PyramidSummedIntensity) {
+    m_PyramidImages.clear();
+    m_PyramidTime = imageTime;
+    m_PyramidSummedIntensity = m_SummedIntensity;
+  }
+
+  while (static_cast<int>(m_PyramidImages.size()) < level) {
+    ImageType* previous = m_PyramidImages.empty() ?
+      m_PSFImage.GetPointer() : m_PyramidImages.back().GetPointer();
+    m_PyramidImages.push_back(DownsampleImage(previous));
+
+    size_t index = m_PyramidImages.size() - 1;
+    if (m_VTKPyramidImages.size() <= index) {
+      m_VTKPyramidImages.push_back(new ITKImageToVTKImage<ImageType>());
+    }
+    m_VTKPyramidImages[index]->SetInput(m_PyramidImages[index]);
+    m_VTKPyramidImages[index]->Modified();
+  }
+}
+
+
+PointSpreadFunction::ImageType::Pointer
+PointSpreadFunction
+::DownsampleImage(ImageType* image) {
+  const unsigned int dimension = ImageType::GetImageDimension();
+
+  ImageType::SizeType    inputSize    = image->GetLargestPossibleRegion().GetSize();
+  ImageType::SpacingType inputSpacing = image->GetSpacing();
+  ImageType::PointType   inputOrigin  = image->GetOrigin();
+
+  ImageType::SizeType    outputSize;
+  ImageType::SpacingType outputSpacing;
+  ImageType::PointType   outputOrigin;
+
+  // Filter taps (input index, weight) for each output index along each
+  // axis. Even-sized axes are averaged in pairs, odd-sized axes with a
+  // [1/4 1/2 1/4] tent centered on the even voxels. Both keep the center
+  // of the image fixed.
+  std::vector< std::vector<int> >    tapIndex[3];
+  std::vector< std::vector<double> > tapWeight[3];
+  for (unsigned int d = 0; d < dimension; d++) {
+    int n = static_cast<int>(inputSize[d]);
+    if (n <= 1) {
+      outputSize[d]    = n;
+      outputSpacing[d] = inputSpacing[d];
+      outputOrigin[d]  = inputOrigin[d];
+    } else if (n % 2 == 0) {
+      outputSize[d]    = n / 2;
+      outputSpacing[d] = 2.0 * inputSpacing[d];
+      outputOrigin[d]  = inputOrigin[d] + 0.5 * inputSpacing[d];
+    } else {
+      outputSize[d]    = (n + 1) / 2;
+      outputSpacing[d] = 2.0 * inputSpacing[d];
+      outputOrigin[d]  = inputOrigin[d];
+    }
+
+    int m = static_cast<int>(outputSize[d]);
+    tapIndex[d].resize(m);
+    tapWeight[d].resize(m);
+    for (int i = 0; i < m; i++) {
+      if (n <= 1) {
+        tapIndex[d][i].push_back(i);
+        tapWeight[d][i].push_back(1.0);
+      } else if (n % 2 == 0) {
+        tapIndex[d][i].push_back(2*i);
+        tapWeight[d][i].push_back(0.5);
+        tapIndex[d][i].push_back(2*i+1);
+        tapWeight[d][i].push_back(0.5);
+      } else {
+        tapIndex[d][i].push_back(2*i);
+        tapWeight[d][i].push_back(0.5);
+        if (2*i-1 >= 0) {
+          tapIndex[d][i].push_back(2*i-1);
+          tapWeight[d][i].push_back(0.25);
+        }
+        if (2*i+1 < n) {
+          tapIndex[d][i].push_back(2*i+1);
+          tapWeight[d][i].push_back(0.25);
+        }
+      }
+    }
+  }
+
+  ImageType::RegionType region;
+  region.SetSize(outputSize);
+
+  ImageType::Pointer output = ImageType::New();
+  output->SetRegions(region);
+  output->SetSpacing(outputSpacing);
+  output->SetOrigin(outputOrigin);
+  output->SetDirection(image->GetDirection());
+  output->Allocate();
+
+  const PixelType* in  = image->GetBufferPointer();
+  PixelType*       out = output->GetBufferPointer();
+  const size_t inSliceSize = inputSize[0]*inputSize[1];
+
+  double sum = 0.0;
+  for (unsigned int k = 0; k < outputSize[2]; k++) {
+    for (unsigned int j = 0; j < outputSize[1]; j++) {
+      for (unsigned int i = 0; i < outputSize[0]; i++) {
+        double value = 0.0;
+        for (size_t c = 0; c < tapIndex[2][k].size(); c++) {
+          for (size_t b = 0; b < tapIndex[1][j].size(); b++) {
+            const PixelType* row = in + tapIndex[2][k][c]*inSliceSize +
+              tapIndex[1][j][b]*inputSize[0];
+            double wzy = tapWeight[2][k][c]*tapWeight[1][j][b];
+            for (size_t a = 0; a < tapIndex[0][i].size(); a++) {
+              value += wzy*tapWeight[0][i][a]*row[tapIndex[0][i][a]];
+            }
+          }
+        }
+        *out++ = static_cast<PixelType>(value);
+        sum += value;
+      }
+    }
+  }
+
+  // Renormalize to the summed intensity of the PSF
+  if (sum > 0.0) {
+    double scale = m_SummedIntensity / sum;
+    out = output->GetBufferPointer();
+    size_t numPixels = region.GetNumberOfPixels();
+    for (size_t i = 0; i < numPixels; i++) {
+      out[i] = static_cast<PixelType>(out[i] * scale);
+    }
+  }
+
+  return output;
+}
+
+
 void
 PointSpreadFunction
 ::UpdateGradientImage() {
@@ -2,13 +2,13 @@
 #define _POINT_SPREAD_FUNCTION_H_
 
 #include <string>
+#include <vector>
 
 #include <XMLStorable.h>
 
 #define ITK_MANUAL_INSTANTIATION
+#include <itkCommand.h>
 #include <itkRecursiveGaussianImageFilter.h>
-#include <itkStatisticsImageFilter.h>
-#include <itkShiftScaleImageFilter.h>
 #include <ITKImageToVTKImage.h>
 #undef ITK_MANUAL_INSTANTIATION
 
@@ -31,9 +31,6 @@ class PointSpreadFunction : public XMLStorable {
 
   typedef float                                 PixelType;
   typedef itk::Image<PixelType, 3>              ImageType;
-  typedef itk::StatisticsImageFilter<ImageType> StatisticsType;
-  typedef itk::ShiftScaleImageFilter<ImageType, ImageType>
-    ScaleFilterType;
   typedef itk::RecursiveGaussianImageFilter<ImageType, ImageType>
     DerivativeFilterType;
 
@@ -51,6 +48,15 @@ class PointSpreadFunction : public XMLStorable {
   virtual vtkImageData*       GetGradientOutput();
   virtual vtkAlgorithmOutput* GetGradientOutputPort();
 
+  // Coarse versions of the PSF for previews and coarse-to-fine work.
+  // Level 0 is the PSF itself; each further level halves the number of
+  // voxels along each axis and doubles the spacing, keeping the PSF
+  // centered and its summed intensity unchanged. Levels are computed on
+  // demand from the level above and cached until the PSF changes.
+  int                 GetNumberOfPyramidLevels();
+  vtkImageData*       GetPyramidLevelOutput(int level);
+  vtkAlgorithmOutput* GetPyramidLevelOutputPort(int level);
+
   void   SetSummedIntensity(double intensity);
   double GetSummedIntensity();
 
@@ -73,9 +79,16 @@ class PointSpreadFunction : public XMLStorable {
   // Scale at which to take derivatives
   double                        m_Sigma;
 
-  // Filters to scale the PSF so that its summed intensity is m_SummedIntensity
-  StatisticsType::Pointer  m_Statistics;
-  ScaleFilterType::Pointer m_ScaleFilter;
+  // PSF image produced by the subclass. Its source scales it in place so
+  // that its summed intensity is m_SummedIntensity; no normalized copy is
+  // kept.
+  ImageType::Pointer m_PSFImage;
+
+  // Source of m_PSFImage and the tag of the observer that normalizes its
+  // output each time it executes.
+  typedef itk::SimpleMemberCommand<PointSpreadFunction> NormalizeCommandType;
+  itk::ProcessObject::Pointer m_PSFSource;
+  unsigned long               m_NormalizeObserverTag;
 
   DerivativeFilterType::Pointer m_DerivativeX;
   DerivativeFilterType::Pointer m_DerivativeY;
@@ -87,6 +100,28 @@ class PointSpreadFunction : public XMLStorable {
 
   vtkSmartPointer<vtkImageAppendComponents> m_VTKGradient;
 
+  // Cached pyramid levels 1 and up, the time of the PSF image they were
+  // computed from, and the summed intensity they were normalized to.
+  std::vector<ImageType::Pointer>              m_PyramidImages;
+  std::vector<ITKImageToVTKImage<ImageType>*>  m_VTKPyramidImages;
+  itk::ModifiedTimeType                        m_PyramidTime;
+  double                                       m_PyramidSummedIntensity;
+
+  // Sets the image that is normalized and differentiated. Subclasses
+  // call this when they connect their image source. The image must be
+  // the output of a source.
+  void SetPSFImage(ImageType* image);
+
+  // Scales the freshly generated pixels of the PSF image to the summed
+  // intensity. Called at the end of each execution of the image source,
+  // so the pixels are always raw when it runs.
+  void NormalizeImage();
+
+  // Makes sure pyramid levels up to and including level are current.
+  void UpdatePyramid(int level);
+
+  ImageType::Pointer DownsampleImage(ImageType* image);
+
   void UpdateGradientImage();
 };
 
@@ -0,0 +1,554 @@
+#include <PointSpreadFunctionFitter.h>
+
+#include <GibsonLanniWidefieldPointSpreadFunction.h>
+#include <ImportedPointSpreadFunction.h>
+
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkCriticalSection.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkPointData.h>
+
+#include <cfloat>
+#include <iostream>
+#include <cmath>
+
+
+// Indices into the GibsonLanniWidefieldPointSpreadFunction parameter list.
+enum {
+  SUMMED_INTENSITY = 0,
+  X_SIZE = 1,
+  X_SPACING = 4,
+  EMISSION_WAVELENGTH = 7,
+  NUMERICAL_APERTURE,
+  MAGNIFICATION,
+  DESIGN_COVER_SLIP_REFRACTIVE_INDEX,
+  ACTUAL_COVER_SLIP_REFRACTIVE_INDEX,
+  DESIGN_COVER_SLIP_THICKNESS,
+  ACTUAL_COVER_SLIP_THICKNESS,
+  DESIGN_IMMERSION_OIL_REFRACTIVE_INDEX,
+  ACTUAL_IMMERSION_OIL_REFRACTIVE_INDEX,
+  DESIGN_IMMERSION_OIL_THICKNESS,
+  DESIGN_SPECIMEN_LAYER_REFRACTIVE_INDEX,
+  ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX,
+  ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER,
+  PSF_SHEAR_IN_X,
+  PSF_SHEAR_IN_Y,
+  NUMBER_OF_PARAMETERS
+};
+
+// Indices into the ImportedPointSpreadFunction parameter list.
+enum {
+  IMPORTED_X_SIZE = 2,
+  IMPORTED_X_SPACING = 5
+};
+
+
+PointSpreadFunctionFitter
+::PointSpreadFunctionFitter() {
+  m_MeasuredPSF = NULL;
+  m_FittedPSF   = NULL;
+
+  m_ParameterActive.resize(NUMBER_OF_PARAMETERS, false);
+  m_ParameterActive[NUMERICAL_APERTURE]                          = true;
+  m_ParameterActive[ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX]      = true;
+  m_ParameterActive[ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER] = true;
+  m_ParameterActive[PSF_SHEAR_IN_X]                              = true;
+  m_ParameterActive[PSF_SHEAR_IN_Y]                              = true;
+
+  m_ParameterSteps.resize(NUMBER_OF_PARAMETERS, 0.0);
+  m_ParameterSteps[EMISSION_WAVELENGTH]                         = 10.0;
+  m_ParameterSteps[NUMERICAL_APERTURE]                          = 0.02;
+  m_ParameterSteps[MAGNIFICATION]                               = 5.0;
+  m_ParameterSteps[DESIGN_COVER_SLIP_REFRACTIVE_INDEX]          = 0.01;
+  m_ParameterSteps[ACTUAL_COVER_SLIP_REFRACTIVE_INDEX]          = 0.01;
+  m_ParameterSteps[DESIGN_COVER_SLIP_THICKNESS]                 = 5.0;
+  m_ParameterSteps[ACTUAL_COVER_SLIP_THICKNESS]                 = 5.0;
+  m_ParameterSteps[DESIGN_IMMERSION_OIL_REFRACTIVE_INDEX]       = 0.01;
+  m_ParameterSteps[ACTUAL_IMMERSION_OIL_REFRACTIVE_INDEX]       = 0.01;
+  m_ParameterSteps[DESIGN_IMMERSION_OIL_THICKNESS]              = 5.0;
+  m_ParameterSteps[DESIGN_SPECIMEN_LAYER_REFRACTIVE_INDEX]      = 0.01;
+  m_ParameterSteps[ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX]      = 0.01;
+  m_ParameterSteps[ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER] = 1.0;
+  m_ParameterSteps[PSF_SHEAR_IN_X]                              = 0.05;
+  m_ParameterSteps[PSF_SHEAR_IN_Y]                              = 0.05;
+
+  m_MaximumNumberOfIterations = 100;
+  m_StepTolerance = 0.01;
+
+  m_Threader = vtkMultiThreader::New();
+  m_NumberOfThreads = m_Threader->GetNumberOfThreads();
+
+  m_CandidateMutex = new vtkSimpleCriticalSection;
+  m_NextCandidate = 0;
+
+  m_ObjectiveFunctionValue = DBL_MAX;
+  m_NumberOfEvaluations = 0;
+  m_NumberOfCacheHits = 0;
+}
+
+
+PointSpreadFunctionFitter
+::~PointSpreadFunctionFitter() {
+  DeleteWorkerPointSpreadFunctions();
+  m_Threader->Delete();
+  delete m_CandidateMutex;
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetMeasuredPointSpreadFunction(ImportedPointSpreadFunction* psf) {
+  m_MeasuredPSF = psf;
+}
+
+
+ImportedPointSpreadFunction*
+PointSpreadFunctionFitter
+::GetMeasuredPointSpreadFunction() {
+  return m_MeasuredPSF;
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetFittedPointSpreadFunction(GibsonLanniWidefieldPointSpreadFunction* psf) {
+  m_FittedPSF = psf;
+}
+
+
+GibsonLanniWidefieldPointSpreadFunction*
+PointSpreadFunctionFitter
+::GetFittedPointSpreadFunction() {
+  return m_FittedPSF;
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetParameterActive(int index, bool active) {
+  // Size, spacing and summed intensity are not fittable.
+  if (index < EMISSION_WAVELENGTH || index >= NUMBER_OF_PARAMETERS)
+    return;
+
+  m_ParameterActive[index] = active;
+}
+
+
+bool
+PointSpreadFunctionFitter
+::GetParameterActive(int index) {
+  if (index < 0 || index >= NUMBER_OF_PARAMETERS)
+    return false;
+
+  return m_ParameterActive[index];
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetParameterStep(int index, double step) {
+  if (index < EMISSION_WAVELENGTH || index >= NUMBER_OF_PARAMETERS)
+    return;
+
+  m_ParameterSteps[index] = fabs(step);
+}
+
+
+double
+PointSpreadFunctionFitter
+::GetParameterStep(int index) {
+  if (index < 0 || index >= NUMBER_OF_PARAMETERS)
+    return 0.0;
+
+  return m_ParameterSteps[index];
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetMaximumNumberOfIterations(int iterations) {
+  m_MaximumNumberOfIterations = iterations;
+}
+
+
+int
+PointSpreadFunctionFitter
+::GetMaximumNumberOfIterations() {
+  return m_MaximumNumberOfIterations;
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetStepTolerance(double tolerance) {
+  m_StepTolerance = tolerance;
+}
+
+
+double
+PointSpreadFunctionFitter
+::GetStepTolerance() {
+  return m_StepTolerance;
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetNumberOfThreads(int threads) {
+  m_NumberOfThreads = threads < 1 ? 1 : threads;
+}
+
+
+int
+PointSpreadFunctionFitter
+::GetNumberOfThreads() {
+  return m_NumberOfThreads;
+}
+
+
+bool
+PointSpreadFunctionFitter
+::Fit() {
+  if (!m_MeasuredPSF || !m_FittedPSF) {
+    std::cout << "ERROR: PointSpreadFunctionFitter needs a measured and a fitted PSF."
+              << std::endl;
+    return false;
+  }
+
+  if (!PrepareMeasuredImage()) {
+    std::cout << "ERROR: Could not read measured PSF '"
+              << m_MeasuredPSF->GetName() << "'." << std::endl;
+    return false;
+  }
+
+  m_Cache.clear();
+  m_NumberOfEvaluations = 0;
+  m_NumberOfCacheHits = 0;
+
+  // Compute the fitted PSF on the grid of the measured PSF.
+  for (int i = 0; i < 3; i++) {
+    m_FittedPSF->SetParameterValue(X_SIZE + i,
+      m_MeasuredPSF->GetParameterValue(IMPORTED_X_SIZE + i));
+    m_FittedPSF->SetParameterValue(X_SPACING + i,
+      m_MeasuredPSF->GetParameterValue(IMPORTED_X_SPACING + i));
+  }
+
+  ParameterVector current = GetParameters(m_FittedPSF);
+  std::vector<double> steps(m_ParameterSteps);
+
+  int numActive = 0;
+  for (int i = 0; i < NUMBER_OF_PARAMETERS; i++) {
+    if (m_ParameterActive[i] && steps[i] > 0.0)
+      numActive++;
+  }
+
+  // There are at most two candidates per active parameter.
+  int numThreads = m_NumberOfThreads;
+  if (numThreads > 2*numActive)
+    numThreads = 2*numActive;
+  if (numThreads < 1)
+    numThreads = 1;
+  CreateWorkerPointSpreadFunctions(numThreads);
+
+  std::vector<ParameterVector> candidates(1, current);
+  std::vector<double> values;
+  EvaluateCandidates(candidates, values);
+  double currentValue = values[0];
+
+  for (int iteration = 0; iteration < m_MaximumNumberOfIterations; iteration++) {
+    candidates.clear();
+    for (int i = 0; i < NUMBER_OF_PARAMETERS; i++) {
+      if (!m_ParameterActive[i] || steps[i] <= 0.0)
+        continue;
+
+      ParameterVector candidate(current);
+      candidate[i] = current[i] + steps[i];
+      candidates.push_back(candidate);
+      candidate[i] = current[i] - steps[i];
+      candidates.push_back(candidate);
+    }
+
+    if (candidates.size() == 0)
+      break;
+
+    EvaluateCandidates(candidates, values);
+
+    int best = -1;
+    double bestValue = currentValue;
+    for (size_t c = 0; c < candidates.size(); c++) {
+      if (values[c] < bestValue) {
+        best = static_cast<int>(c);
+        bestValue = values[c];
+      }
+    }
+
+    if (best >= 0) {
+      current = candidates[best];
+      currentValue = bestValue;
+    } else {
+      // No improvement; refine the search.
+      bool converged = true;
+      for (int i = 0; i < NUMBER_OF_PARAMETERS; i++) {
+        steps[i] *= 0.5;
+        if (m_ParameterActive[i] &&
+            steps[i] > m_StepTolerance*m_ParameterSteps[i]) {
+          converged = false;
+        }
+      }
+      if (converged)
+        break;
+    }
+  }
+
+  DeleteWorkerPointSpreadFunctions();
+
+  SetParameters(m_FittedPSF, current);
+  m_FittedPSF->Update();
+
+  m_ObjectiveFunctionValue = currentValue;
+
+  return true;
+}
+
+
+double
+PointSpreadFunctionFitter
+::GetObjectiveFunctionValue() {
+  return m_ObjectiveFunctionValue;
+}
+
+
+int
+PointSpreadFunctionFitter
+::GetNumberOfEvaluations() {
+  return m_NumberOfEvaluations;
+}
+
+
+int
+PointSpreadFunctionFitter
+::GetNumberOfCacheHits() {
+  return m_NumberOfCacheHits;
+}
+
+
+bool
+PointSpreadFunctionFitter
+::PrepareMeasuredImage() {
+  m_MeasuredImage.clear();
+
+  if (!m_MeasuredPSF->IsFileValid())
+    return false;
+
+  // Update the PSF itself rather than only its VTK output so that the
+  // intensity offset is applied to the measured image.
+  m_MeasuredPSF->Update();
+  m_MeasuredPSF->GetOutputPort()->GetProducer()->Update();
+  vtkImageData* image = m_MeasuredPSF->GetOutput();
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  if (!scalars)
+    return false;
+
+  vtkIdType numValues = scalars->GetNumberOfTuples();
+  double sum = 0.0;
+  for (vtkIdType i = 0; i < numValues; i++) {
+    sum += scalars->GetTuple1(i);
+  }
+  if (sum <= 0.0)
+    return false;
+
+  m_MeasuredImage.resize(numValues);
+  for (vtkIdType i = 0; i < numValues; i++) {
+    m_MeasuredImage[i] = scalars->GetTuple1(i) / sum;
+  }
+
+  return true;
+}
+
+
+void
+PointSpreadFunctionFitter
+::CreateWorkerPointSpreadFunctions(int count) {
+  DeleteWorkerPointSpreadFunctions();
+
+  ParameterVector parameters = GetParameters(m_FittedPSF);
+  for (int i = 0; i < count; i++) {
+    GibsonLanniWidefieldPointSpreadFunction* psf =
+      new GibsonLanniWidefieldPointSpreadFunction();
+
+    // The candidates are already spread over the threads of m_Threader,
+    // so each worker PSF is computed in a single ITK work unit.
+    psf->SetNumberOfWorkUnits(1);
+    SetParameters(psf, parameters);
+    m_WorkerPSFs.push_back(psf);
+  }
+}
+
+
+void
+PointSpreadFunctionFitter
+::DeleteWorkerPointSpreadFunctions() {
+  for (size_t i = 0; i < m_WorkerPSFs.size(); i++) {
+    delete m_WorkerPSFs[i];
+  }
+  m_WorkerPSFs.clear();
+}
+
+
+void
+PointSpreadFunctionFitter
+::EvaluateCandidates(std::vector<ParameterVector>& candidates,
+                     std::vector<double>& values) {
+  values.resize(candidates.size());
+
+  // Look up candidates already evaluated. Each remaining candidate is
+  // evaluated once even if it appears more than once.
+  m_Candidates.clear();
+  std::vector<int> candidateIndex(candidates.size(), -1);
+  std::map<ParameterVector, int> pending;
+  for (size_t c = 0; c < candidates.size(); c++) {
+    ObjectiveCache::iterator cached = m_Cache.find(candidates[c]);
+    if (cached != m_Cache.end()) {
+      values[c] = cached->second;
+      m_NumberOfCacheHits++;
+      continue;
+    }
+
+    std::map<ParameterVector, int>::iterator iter = pending.find(candidates[c]);
+    if (iter != pending.end()) {
+      candidateIndex[c] = iter->second;
+    } else {
+      candidateIndex[c] = static_cast<int>(m_Candidates.size());
+      pending[candidates[c]] = candidateIndex[c];
+      m_Candidates.push_back(candidates[c]);
+    }
+  }
+
+  if (m_Candidates.size() > 0) {
+    m_CandidateValues.assign(m_Candidates.size(), DBL_MAX);
+    m_NextCandidate = 0;
+
+    int numThreads = static_cast<int>(m_WorkerPSFs.size());
+    if (numThreads > static_cast<int>(m_Candidates.size()))
+      numThreads = static_cast<int>(m_Candidates.size());
+    m_Threader->SetNumberOfThreads(numThreads);
+    m_Threader->SetSingleMethod(PointSpreadFunctionFitter::ThreadedEvaluate,
+                                (void *) this);
+    m_Threader->SingleMethodExecute();
+
+    m_NumberOfEvaluations += static_cast<int>(m_Candidates.size());
+    for (size_t i = 0; i < m_Candidates.size(); i++) {
+      m_Cache[m_Candidates[i]] = m_CandidateValues[i];
+    }
+  }
+
+  for (size_t c = 0; c < candidates.size(); c++) {
+    if (candidateIndex[c] >= 0)
+      values[c] = m_CandidateValues[candidateIndex[c]];
+  }
+}
+
+
+VTK_THREAD_RETURN_TYPE
+PointSpreadFunctionFitter
+::ThreadedEvaluate(void* arg) {
+  int threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
+  PointSpreadFunctionFitter* self = (PointSpreadFunctionFitter *)
+    (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
+
+  GibsonLanniWidefieldPointSpreadFunction* psf = self->m_WorkerPSFs[threadId];
+
+  // Hand out candidates one at a time so that threads stay busy even
+  // when evaluation times differ.
+  while (true) {
+    self->m_CandidateMutex->Lock();
+    int index = self->m_NextCandidate++;
+    self->m_CandidateMutex->Unlock();
+
+    if (index >= static_cast<int>(self->m_Candidates.size()))
+      break;
+
+    self->m_CandidateValues[index] =
+      self->EvaluateCandidate(psf, self->m_Candidates[index]);
+  }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+
+double
+PointSpreadFunctionFitter
+::EvaluateCandidate(GibsonLanniWidefieldPointSpreadFunction* psf,
+                    const ParameterVector& parameters) {
+  // Reject physically meaningless parameters without computing a PSF.
+  if (parameters[NUMERICAL_APERTURE] <= 0.0 ||
+      parameters[ACTUAL_SPECIMEN_LAYER_REFRACTIVE_INDEX] <= 0.0 ||
+      parameters[ACTUAL_COVER_SLIP_REFRACTIVE_INDEX] <= 0.0 ||
+      parameters[ACTUAL_IMMERSION_OIL_REFRACTIVE_INDEX] <= 0.0 ||
+      parameters[ACTUAL_COVER_SLIP_THICKNESS] <= 0.0 ||
+      parameters[ACTUAL_POINT_SOURCE_DEPTH_IN_SPECIMEN_LAYER] < 0.0) {
+    return DBL_MAX;
+  }
+
+  SetParameters(psf, parameters);
+
+  // The candidate is normalized here, so there is no need for the
+  // statistics and gradient computations in PointSpreadFunction::Update().
+  vtkImageData* image = NULL;
+  try {
+    psf->GetOutputPort()->GetProducer()->Update();
+    image = psf->GetOutput();
+  } catch (...) {
+    return DBL_MAX;
+  }
+
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  if (!scalars ||
+      scalars->GetNumberOfTuples() != static_cast<vtkIdType>(m_MeasuredImage.size())) {
+    return DBL_MAX;
+  }
+
+  vtkIdType numValues = scalars->GetNumberOfTuples();
+  double sum = 0.0;
+  for (vtkIdType i = 0; i < numValues; i++) {
+    sum += scalars->GetTuple1(i);
+  }
+  if (!(sum > 0.0))
+    return DBL_MAX;
+
+  double ssd = 0.0;
+  for (vtkIdType i = 0; i < numValues; i++) {
+    double diff = scalars->GetTuple1(i) / sum - m_MeasuredImage[i];
+    ssd += diff*diff;
+  }
+
+  if (ssd != ssd) // NaN
+    return DBL_MAX;
+
+  return ssd;
+}
+
+
+PointSpreadFunctionFitter::ParameterVector
+PointSpreadFunctionFitter
+::GetParameters(GibsonLanniWidefieldPointSpreadFunction* psf) {
+  ParameterVector parameters(NUMBER_OF_PARAMETERS);
+  for (int i = 0; i < NUMBER_OF_PARAMETERS; i++) {
+    parameters[i] = psf->GetParameterValue(i);
+  }
+
+  return parameters;
+}
+
+
+void
+PointSpreadFunctionFitter
+::SetParameters(GibsonLanniWidefieldPointSpreadFunction* psf,
+                const ParameterVector& parameters) {
+  // The summed intensity is left alone; it does not affect the fit.
+  for (int i = SUMMED_INTENSITY + 1; i < NUMBER_OF_PARAMETERS; i++) {
+    psf->SetParameterValue(i, parameters[i]);
+  }
+}
@@ -0,0 +1,131 @@
+#ifndef _POINT_SPREAD_FUNCTION_FITTER_H_
+#define _POINT_SPREAD_FUNCTION_FITTER_H_
+
+#include <map>
+#include <vector>
+
+#include <vtkMultiThreader.h>
+
+class vtkSimpleCriticalSection;
+
+class GibsonLanniWidefieldPointSpreadFunction;
+class ImportedPointSpreadFunction;
+
+
+// Fits the parameters of a GibsonLanniWidefieldPointSpreadFunction to a
+// measured bead stack loaded as an ImportedPointSpreadFunction.
+//
+// The fit is a compass (pattern) search: each iteration evaluates the
+// current parameters offset by plus and minus the step size along each
+// active parameter, moves to the best candidate, and halves the steps
+// when no candidate improves. The candidates of one iteration are
+// independent, so they are evaluated in parallel, each thread using its
+// own copy of the PSF. Objective values are cached by parameter vector
+// because the search revisits points frequently.
+//
+// Only whole objective values are cached. The pupil and optical path
+// difference terms are computed inside the Gibson-Lanni image source and
+// depend on the refractive indices, numerical aperture and source depth
+// being fitted, so no part of a PSF computation is shared between
+// candidates that differ in any parameter.
+//
+// The objective is the sum of squared differences between the measured
+// and candidate PSFs, both normalized to unit summed intensity. The
+// fitted PSF takes on the size and voxel spacing of the measured PSF,
+// so the bead should be centered in the measured stack (see the point
+// center parameters of ImportedPointSpreadFunction).
+class PointSpreadFunctionFitter {
+
+ public:
+  PointSpreadFunctionFitter();
+  virtual ~PointSpreadFunctionFitter();
+
+  void SetMeasuredPointSpreadFunction(ImportedPointSpreadFunction* psf);
+  ImportedPointSpreadFunction* GetMeasuredPointSpreadFunction();
+
+  // The parameters of this PSF are the starting point of the fit and
+  // are replaced by the fitted parameters when Fit() returns.
+  void SetFittedPointSpreadFunction(GibsonLanniWidefieldPointSpreadFunction* psf);
+  GibsonLanniWidefieldPointSpreadFunction* GetFittedPointSpreadFunction();
+
+  // Parameters are identified by their index in the fitted PSF's
+  // parameter list. By default, the actual specimen layer refractive
+  // index, point source depth, numerical aperture and shear are active.
+  void   SetParameterActive(int index, bool active);
+  bool   GetParameterActive(int index);
+
+  // Initial search step for a parameter.
+  void   SetParameterStep(int index, double step);
+  double GetParameterStep(int index);
+
+  void   SetMaximumNumberOfIterations(int iterations);
+  int    GetMaximumNumberOfIterations();
+
+  // The search stops when every step has shrunk below this fraction of
+  // its initial value.
+  void   SetStepTolerance(double tolerance);
+  double GetStepTolerance();
+
+  void   SetNumberOfThreads(int threads);
+  int    GetNumberOfThreads();
+
+  // Runs the fit. Returns false if the fit could not be set up.
+  bool   Fit();
+
+  double GetObjectiveFunctionValue();
+  int    GetNumberOfEvaluations();
+  int    GetNumberOfCacheHits();
+
+ protected:
+  typedef std::vector<double>               ParameterVector;
+  typedef std::map<ParameterVector, double> ObjectiveCache;
+
+  ImportedPointSpreadFunction*             m_MeasuredPSF;
+  GibsonLanniWidefieldPointSpreadFunction* m_FittedPSF;
+
+  std::vector<bool>   m_ParameterActive;
+  std::vector<double> m_ParameterSteps;
+
+  int    m_MaximumNumberOfIterations;
+  double m_StepTolerance;
+  int    m_NumberOfThreads;
+
+  double m_ObjectiveFunctionValue;
+  int    m_NumberOfEvaluations;
+  int    m_NumberOfCacheHits;
+
+  // Measured PSF normalized to unit sum, computed once per fit.
+  std::vector<double> m_MeasuredImage;
+
+  ObjectiveCache m_Cache;
+
+  // State shared with the worker threads during EvaluateCandidates().
+  std::vector<GibsonLanniWidefieldPointSpreadFunction*> m_WorkerPSFs;
+  std::vector<ParameterVector> m_Candidates;
+  std::vector<double>          m_CandidateValues;
+  int                          m_NextCandidate;
+  vtkSimpleCriticalSection*    m_CandidateMutex;
+
+  vtkMultiThreader* m_Threader;
+
+  bool   PrepareMeasuredImage();
+  void   CreateWorkerPointSpreadFunctions(int count);
+  void   DeleteWorkerPointSpreadFunctions();
+
+  // Fills in values for candidates from the cache and evaluates the rest
+  // in parallel.
+  void   EvaluateCandidates(std::vector<ParameterVector>& candidates,
+                            std::vector<double>& values);
+
+  double EvaluateCandidate(GibsonLanniWidefieldPointSpreadFunction* psf,
+                           const ParameterVector& parameters);
+
+  static VTK_THREAD_RETURN_TYPE ThreadedEvaluate(void* arg);
+
+  ParameterVector GetParameters(GibsonLanniWidefieldPointSpreadFunction* psf);
+  void            SetParameters(GibsonLanniWidefieldPointSpreadFunction* psf,
+                                const ParameterVector& parameters);
+
+};
+
+#endif // _POINT_SPREAD_FUNCTION_FITTER_H_
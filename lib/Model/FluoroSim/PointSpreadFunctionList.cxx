@@ -5,6 +5,7 @@
 #include <GibsonLanniWidefieldPointSpreadFunction.h>
 #include <ModifiedGibsonLanniWidefieldPointSpreadFunction.h>
 #include <HaeberleWidefieldPointSpreadFunction.h>
+#include <FourierGibsonLanniWidefieldPointSpreadFunction.h>
 #include <PointSpreadFunctionList.h>
 
 #include <libxml/tree.h>
@@ -71,6 +72,18 @@ PointSpreadFunctionList
 }
 
 
+PointSpreadFunction*
+PointSpreadFunctionList
+::AddFourierGibsonLanniWidefieldPointSpreadFunction(const std::string& name) {
+  FourierGibsonLanniWidefieldPointSpreadFunction* psf =
+    new FourierGibsonLanniWidefieldPointSpreadFunction();
+  psf->SetName(GetUniqueName(-1, name));
+  m_PSFList.push_back(psf);
+
+  return psf;
+}
+
+
 PointSpreadFunction*
 PointSpreadFunctionList
 ::ImportPointSpreadFunction(const std::string& name) {
@@ -174,6 +187,10 @@ PointSpreadFunctionList
         PointSpreadFunction* psf = new HaeberleWidefieldPointSpreadFunction();
         psf->RestoreFromXML(psfNode);
         m_PSFList.push_back(psf);
+      } else if (nodeName == FourierGibsonLanniWidefieldPointSpreadFunction::PSF_ELEMENT) {
+        PointSpreadFunction* psf = new FourierGibsonLanniWidefieldPointSpreadFunction();
+        psf->RestoreFromXML(psfNode);
+        m_PSFList.push_back(psf);
       }
     }
     psfNode = psfNode->next;
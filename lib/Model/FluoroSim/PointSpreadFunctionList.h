@@ -17,6 +17,7 @@ class PointSpreadFunctionList : public XMLStorable {
   PointSpreadFunction* AddGibsonLanniWidefieldPointSpreadFunction(const std::string& name);
   PointSpreadFunction* AddModifiedGibsonLanniWidefieldPointSpreadFunction(const std::string& name);
   PointSpreadFunction* AddHaeberlieWidefieldPointSpreadFunction(const std::string& name);
+  PointSpreadFunction* AddFourierGibsonLanniWidefieldPointSpreadFunction(const std::string& name);
   PointSpreadFunction* ImportPointSpreadFunction(const std::string& fileName);
   void DeletePointSpreadFunction(int index);
 
@@ -3,6 +3,8 @@
 #include <VolumeUniformFluorophoreProperty.h>
 #include <GridBasedFluorophoreProperty.h>
 
+#include <vtkAnalyticPartialVolumeSource.h>
+#include <vtkAnalyticUniformPointSampler.h>
 #include <vtkDataSetSurfaceFilter.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkVolumetricCylinderSource.h>
@@ -25,7 +27,6 @@ CylinderModelObject
 
   // Set up geometry
   m_CylinderSource = vtkSmartPointer<vtkVolumetricCylinderSource>::New();
-  m_CylinderSource->SetResolution(32);
 
   vtkSmartPointer<vtkDataSetSurfaceFilter> surfaceFilter =
     vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
@@ -40,16 +41,27 @@ CylinderModelObject
 
   SetGeometrySubAssembly("All", m_GeometrySource);
 
+  // Fluorophores are sampled from the shape parameters rather than
+  // from the tessellated geometry.
+  m_SurfaceSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_SurfaceSampler->SetShapeToCylinder();
+  m_VolumeSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_VolumeSampler->SetShapeToCylinder();
+
+  // Voxel coverage is also computed from the shape parameters.
+  m_PartialVolumeSource = vtkSmartPointer<vtkAnalyticPartialVolumeSource>::New();
+  m_PartialVolumeSource->SetShapeToCylinder();
+
   // Set up properties
   AddProperty(new ModelObjectProperty(RADIUS_PROP,  100.0, "nanometers"));
   AddProperty(new ModelObjectProperty(LENGTH_PROP, 1000.0, "nanometers"));
 
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, m_GeometrySource));
+              (SURFACE_FLUOR_PROP, m_SurfaceSampler));
   AddProperty(new VolumeUniformFluorophoreProperty
-              (VOLUME_FLUOR_PROP,  m_CylinderSource));
+              (VOLUME_FLUOR_PROP,  m_VolumeSampler));
   AddProperty(new GridBasedFluorophoreProperty
-              (GRID_FLUOR_PROP, m_CylinderSource));
+              (GRID_FLUOR_PROP, m_PartialVolumeSource));
 
   // Must call this after setting up properties
   Update();
@@ -65,8 +77,23 @@ CylinderModelObject
 void
 CylinderModelObject
 ::Update() {
-  m_CylinderSource->SetRadius(GetProperty(RADIUS_PROP)->GetDoubleValue());
-  m_CylinderSource->SetHeight(GetProperty(LENGTH_PROP)->GetDoubleValue());
+  double radius = GetProperty(RADIUS_PROP)->GetDoubleValue();
+  double height = GetProperty(LENGTH_PROP)->GetDoubleValue();
+  m_CylinderSource->SetRadius(radius);
+  m_CylinderSource->SetHeight(height);
+  m_SurfaceSampler->SetRadius(radius);
+  m_SurfaceSampler->SetHeight(height);
+  m_VolumeSampler->SetRadius(radius);
+  m_VolumeSampler->SetHeight(height);
+  m_PartialVolumeSource->SetRadius(radius);
+  m_PartialVolumeSource->SetHeight(height);
+
+  // Facet the geometry relative to the voxels of the grid fluorophore
+  // model, so objects that are small compared to the sample spacing get
+  // few facets.
+  GridBasedFluorophoreProperty* gridProperty =
+    dynamic_cast<GridBasedFluorophoreProperty*>(GetProperty(GRID_FLUOR_PROP));
+  m_CylinderSource->SetMaximumError(gridProperty->GetMaximumGeometricError());
 
   // Call superclass update method
   ModelObject::Update();
@@ -6,6 +6,8 @@
 #include <vtkSmartPointer.h>
 
 //class vtkCylinderSource;
+class vtkAnalyticPartialVolumeSource;
+class vtkAnalyticUniformPointSampler;
 class vtkVolumetricCylinderSource;
 class vtkTriangleFilter;
 
@@ -32,6 +34,9 @@ class CylinderModelObject : public ModelObject {
   //vtkSmartPointer<vtkCylinderSource> m_CylinderSource;
   vtkSmartPointer<vtkVolumetricCylinderSource> m_CylinderSource;
   vtkSmartPointer<vtkTriangleFilter> m_GeometrySource;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_SurfaceSampler;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_VolumeSampler;
+  vtkSmartPointer<vtkAnalyticPartialVolumeSource> m_PartialVolumeSource;
 
 };
 
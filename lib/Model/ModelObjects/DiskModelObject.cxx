@@ -2,6 +2,7 @@
 #include <GridBasedFluorophoreProperty.h>
 #include <SurfaceUniformFluorophoreProperty.h>
 
+#include <vtkAnalyticUniformPointSampler.h>
 #include <vtkDiskSource2.h>
 
 
@@ -23,10 +24,15 @@ DiskModelObject
 
   SetGeometrySubAssembly("All", m_GeometrySource);
 
+  // Fluorophores are sampled from the shape parameters rather than
+  // from the tessellated geometry.
+  m_SurfaceSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_SurfaceSampler->SetShapeToDisk();
+
   // Set up properties
   AddProperty(new ModelObjectProperty(RADIUS_PROP, 500.0, "nanometers"));
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, m_GeometrySource));
+              (SURFACE_FLUOR_PROP, m_SurfaceSampler));
 
   // Must call this after setting up properties
   Update();
@@ -43,6 +49,7 @@ void
 DiskModelObject
 ::Update() {
   m_GeometrySource->SetRadius(GetProperty("Radius")->GetDoubleValue());
+  m_SurfaceSampler->SetRadius(GetProperty("Radius")->GetDoubleValue());
 
   // Call superclass update method
   ModelObject::Update();
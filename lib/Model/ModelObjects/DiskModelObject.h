@@ -4,6 +4,7 @@
 #include <ModelObject.h>
 #include <vtkSmartPointer.h>
 
+class vtkAnalyticUniformPointSampler;
 class vtkDiskSource2;
 
 
@@ -25,6 +26,7 @@ class DiskModelObject : public ModelObject {
   DiskModelObject() {};
 
   vtkSmartPointer<vtkDiskSource2> m_GeometrySource;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_SurfaceSampler;
 };
 
 #endif // _DISK_MODEL_OBJECT_H_
@@ -5,6 +5,8 @@
 #include <VolumeUniformFluorophoreProperty.h>
 #include <GridBasedFluorophoreProperty.h>
 
+#include <vtkAnalyticPartialVolumeSource.h>
+#include <vtkAnalyticUniformPointSampler.h>
 #include <vtkDataSetSurfaceFilter.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkVolumetricEllipsoidSource.h>
@@ -30,8 +32,6 @@ EllipsoidModelObject
 
   // Set up geometry
   m_EllipsoidSource = vtkSmartPointer<vtkVolumetricEllipsoidSource>::New();
-  m_EllipsoidSource->SetThetaResolution(32);
-  m_EllipsoidSource->SetPhiResolution(16);
 
   vtkSmartPointer<vtkDataSetSurfaceFilter> surfaceFilter =
     vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
@@ -42,17 +42,28 @@ EllipsoidModelObject
 
   SetGeometrySubAssembly("All", m_GeometrySource);
 
+  // Fluorophores are sampled from the shape parameters rather than
+  // from the tessellated geometry.
+  m_SurfaceSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_SurfaceSampler->SetShapeToEllipsoid();
+  m_VolumeSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_VolumeSampler->SetShapeToEllipsoid();
+
+  // Voxel coverage is also computed from the shape parameters.
+  m_PartialVolumeSource = vtkSmartPointer<vtkAnalyticPartialVolumeSource>::New();
+  m_PartialVolumeSource->SetShapeToEllipsoid();
+
   // Set up properties
   AddProperty(new ModelObjectProperty(RADIUS_X_PROP, 100.0, "nanometers"));
   AddProperty(new ModelObjectProperty(RADIUS_Y_PROP, 100.0, "nanometers"));
   AddProperty(new ModelObjectProperty(RADIUS_Z_PROP, 100.0, "nanometers"));
 
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, m_GeometrySource));
+              (SURFACE_FLUOR_PROP, m_SurfaceSampler));
   AddProperty(new VolumeUniformFluorophoreProperty
-              (VOLUME_FLUOR_PROP, m_EllipsoidSource));
+              (VOLUME_FLUOR_PROP, m_VolumeSampler));
   AddProperty(new GridBasedFluorophoreProperty
-              (GRID_FLUOR_PROP, m_EllipsoidSource));
+              (GRID_FLUOR_PROP, m_PartialVolumeSource));
 
   // Must call this after setting up properties
   Update();
@@ -72,6 +83,16 @@ EllipsoidModelObject
   double radiusY = GetProperty(RADIUS_Y_PROP)->GetDoubleValue();
   double radiusZ = GetProperty(RADIUS_Z_PROP)->GetDoubleValue();
   m_EllipsoidSource->SetRadius(radiusX, radiusY, radiusZ);
+  m_SurfaceSampler->SetRadii(radiusX, radiusY, radiusZ);
+  m_VolumeSampler->SetRadii(radiusX, radiusY, radiusZ);
+  m_PartialVolumeSource->SetRadii(radiusX, radiusY, radiusZ);
+
+  // Facet the geometry relative to the voxels of the grid fluorophore
+  // model, so objects that are small compared to the sample spacing get
+  // few facets.
+  GridBasedFluorophoreProperty* gridProperty =
+    dynamic_cast<GridBasedFluorophoreProperty*>(GetProperty(GRID_FLUOR_PROP));
+  m_EllipsoidSource->SetMaximumError(gridProperty->GetMaximumGeometricError());
 
   // Call superclass update method
   ModelObject::Update();
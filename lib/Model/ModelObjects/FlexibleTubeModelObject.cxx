@@ -14,9 +14,12 @@
 #include <vtkPoints.h>
 #include <vtkPolyDataToTetrahedralGrid.h>
 #include <vtkSpline.h>
+#include <vtkSplineTubeUniformPointSampler.h>
 #include <vtkTubeFilter.h>
 #include <vtkTriangleFilter.h>
 
+#include <algorithm>
+
 
 const char* FlexibleTubeModelObject::OBJECT_TYPE_NAME = "FlexibleTubeModel";
 
@@ -55,20 +58,24 @@ FlexibleTubeModelObject
 
   SetGeometrySubAssembly("All", m_TubeSource);
 
+  m_SurfaceSampler = vtkSmartPointer<vtkSplineTubeUniformPointSampler>::New();
+  m_SurfaceSampler->SetSpline(m_Spline);
+  m_VolumeSampler = vtkSmartPointer<vtkSplineTubeUniformPointSampler>::New();
+  m_VolumeSampler->SetSpline(m_Spline);
+
   // Set up properties
   AddProperty(new ModelObjectProperty(RADIUS_PROP, 50.0, "nanometers"));
   AddProperty(new ModelObjectProperty(NUMBER_OF_POINTS_PROP, 2, "-", true, false));
 
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, m_TubeSource));
+              (SURFACE_FLUOR_PROP, m_SurfaceSampler));
+  AddProperty(new VolumeUniformFluorophoreProperty
+              (VOLUME_FLUOR_PROP, m_VolumeSampler));
 
   // Perform the tetrahedralization here
-  vtkSmartPointer<vtkPolyDataToTetrahedralGrid> tetrahedralizer =
-    vtkSmartPointer<vtkPolyDataToTetrahedralGrid>::New();
-  tetrahedralizer->SetInputConnection(m_TubeSource->GetOutputPort());
-
-  AddProperty(new VolumeUniformFluorophoreProperty
-              (VOLUME_FLUOR_PROP, tetrahedralizer));
+  //vtkSmartPointer<vtkPolyDataToTetrahedralGrid> tetrahedralizer =
+  //  vtkSmartPointer<vtkPolyDataToTetrahedralGrid>::New();
+  //tetrahedralizer->SetInputConnection(m_TubeSource->GetOutputPort());
   //AddProperty(new GridBasedFluorophoreProperty
   //            (GRID_FLUOR_PROP, tetrahedralizer));
 
@@ -108,6 +115,8 @@ FlexibleTubeModelObject
   double radius =
     GetProperty(FlexibleTubeModelObject::RADIUS_PROP)->GetDoubleValue();
   m_TubeFilter->SetRadius(radius);
+  m_SurfaceSampler->SetRadius(radius);
+  m_VolumeSampler->SetRadius(radius);
 
   int numPoints = 
     GetProperty(PointSetModelObject::NUMBER_OF_POINTS_PROP)->GetIntValue();
@@ -148,11 +157,13 @@ FlexibleTubeModelObject
     m_Points->Modified();
     m_Spline->Modified();
     m_SplineSource->Modified();
-    m_SplineSource->Update();
 
-    // Adjust tessellation based on curve length
+    // Adjust tessellation based on curve length and bending, so that
+    // tight bends are not cut short.
     double length = GetLength();
-    m_SplineSource->SetUResolution(static_cast<int>(length/100.0));
+    int resolution = m_SurfaceSampler->ComputeUniformResolution(32);
+    resolution = std::max(resolution, static_cast<int>(length/100.0));
+    m_SplineSource->SetUResolution(std::max(resolution, 1));
   }
 
   // Call superclass update method
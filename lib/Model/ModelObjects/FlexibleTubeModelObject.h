@@ -8,6 +8,7 @@
 class vtkParametricSpline;
 class vtkParametricFunctionSource;
 class vtkPoints;
+class vtkSplineTubeUniformPointSampler;
 class vtkTubeFilter;
 class vtkTriangleFilter;
 
@@ -38,6 +39,11 @@ class FlexibleTubeModelObject : public PointSetModelObject {
   vtkSmartPointer<vtkTubeFilter>               m_TubeFilter;
   vtkSmartPointer<vtkTriangleFilter>           m_TubeSource;
 
+  // Fluorophores are sampled from the spline itself, so they do not
+  // wait on the tube filter or a tetrahedralization.
+  vtkSmartPointer<vtkSplineTubeUniformPointSampler> m_SurfaceSampler;
+  vtkSmartPointer<vtkSplineTubeUniformPointSampler> m_VolumeSampler;
+
   double GetLength();
 
  private:
@@ -1,9 +1,11 @@
 #include <GridBasedFluorophoreProperty.h>
 
+#include <vtkAnalyticPartialVolumeSource.h>
 #include <vtkDataObject.h>
 #include <vtkFloatArray.h>
 #include <vtkImageData.h>
 #include <vtkPartialVolumeModeller.h>
+#include <vtkPassThrough.h>
 #include <vtkPointData.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkUnstructuredGridAlgorithm.h>
@@ -11,7 +13,8 @@
 #include <vtkXMLPolyDataWriter.h>
 
 
-const char* GridBasedFluorophoreProperty::SAMPLE_SPACING_ATT = "sampleSpacing";
+const char* GridBasedFluorophoreProperty::SAMPLE_SPACING_ATT  = "sampleSpacing";
+const char* GridBasedFluorophoreProperty::GEOMETRIC_ERROR_ATT = "geometricError";
 
 
 GridBasedFluorophoreProperty
@@ -21,6 +24,7 @@ GridBasedFluorophoreProperty
   : FluorophoreModelObjectProperty(name, editable, optimizable) {
 
   m_SampleSpacing = 50.0;
+  m_GeometricError = 0.01;
   m_GridSource = gridSource;
 
   // Set up the class that computes partial volume effects
@@ -28,9 +32,32 @@ GridBasedFluorophoreProperty
   m_PartialVolumeVoxelizer->SetInputConnection(gridSource->GetOutputPort());
   m_PartialVolumeVoxelizer->SetOutputScalarTypeToFloat();
 
+  // Take the voxels with nonzero coverage directly from the voxelizer
+  // instead of thresholding a dense grid.
+  m_PartialVolumeVoxelizer->GenerateDenseOutputOff();
+  m_SparseOutput = vtkSmartPointer<vtkPassThrough>::New();
+  m_SparseOutput->SetInputConnection(m_PartialVolumeVoxelizer->GetOutputPort(1));
+
+  m_FluorophoreOutput = m_SparseOutput;
+
+  this->Update();
+}
+
+
+GridBasedFluorophoreProperty
+::GridBasedFluorophoreProperty(const std::string& name,
+                               vtkAnalyticPartialVolumeSource* shapeSource,
+                               bool editable, bool optimizable)
+  : FluorophoreModelObjectProperty(name, editable, optimizable) {
+
+  m_SampleSpacing = 50.0;
+  m_GeometricError = 0.01;
+  m_ShapeSource = shapeSource;
+  m_ShapeSource->SetOutputScalarTypeToFloat();
+
   m_Threshold = vtkSmartPointer<vtkThresholdPoints>::New();
   m_Threshold->ThresholdByUpper(1e-9);
-  m_Threshold->SetInputConnection(m_PartialVolumeVoxelizer->GetOutputPort());
+  m_Threshold->SetInputConnection(m_ShapeSource->GetOutputPort());
 
   m_FluorophoreOutput = m_Threshold;
 
@@ -58,6 +85,27 @@ GridBasedFluorophoreProperty
 }
 
 
+void
+GridBasedFluorophoreProperty
+::SetGeometricError(double error) {
+  m_GeometricError = error;
+}
+
+
+double
+GridBasedFluorophoreProperty
+::GetGeometricError() {
+  return m_GeometricError;
+}
+
+
+double
+GridBasedFluorophoreProperty
+::GetMaximumGeometricError() {
+  return m_GeometricError * m_SampleSpacing;
+}
+
+
 int
 GridBasedFluorophoreProperty
 ::GetNumberOfFluorophores() {
@@ -79,14 +127,23 @@ GridBasedFluorophoreProperty
   if (!this->GetEnabled()) {
     // Set the sample dimensions to 2 in case the voxelizers get updated
     dims[0] = dims[1] = dims[2] = 2;
-    m_PartialVolumeVoxelizer->SetSampleDimensions(dims);
+    if (m_ShapeSource) {
+      m_ShapeSource->SetSampleDimensions(dims);
+    } else {
+      m_PartialVolumeVoxelizer->SetSampleDimensions(dims);
+    }
     return;
   }
 
-  // Get bounding box size of the grid source
+  // Get bounding box size of the shape or grid source. Shapes know their
+  // bounds without generating a mesh.
   double bounds[6];
-  m_GridSource->Update();
-  m_GridSource->GetOutput()->GetBounds(bounds);
+  if (m_ShapeSource) {
+    m_ShapeSource->GetShapeBounds(bounds);
+  } else {
+    m_GridSource->Update();
+    m_GridSource->GetOutput()->GetBounds(bounds);
+  }
 
   for (int i = 0; i < 3; i++) {
     // Pad the boundaries by half a voxel in each dimension
@@ -104,9 +161,15 @@ GridBasedFluorophoreProperty
     dims[i]++;
   }
 
-  m_PartialVolumeVoxelizer->SetModelBounds(bounds);
-  m_PartialVolumeVoxelizer->SetSampleDimensions(dims);
-  m_PartialVolumeVoxelizer->Update();
+  if (m_ShapeSource) {
+    m_ShapeSource->SetModelBounds(bounds);
+    m_ShapeSource->SetSampleDimensions(dims);
+    m_ShapeSource->Update();
+  } else {
+    m_PartialVolumeVoxelizer->SetModelBounds(bounds);
+    m_PartialVolumeVoxelizer->SetSampleDimensions(dims);
+    m_PartialVolumeVoxelizer->Update();
+  }
 }
 
 
@@ -118,6 +181,9 @@ GridBasedFluorophoreProperty
   char value[256];
   sprintf(value, "%f", GetSampleSpacing());
   xmlNewProp(root, BAD_CAST SAMPLE_SPACING_ATT, BAD_CAST value);
+
+  sprintf(value, "%f", GetGeometricError());
+  xmlNewProp(root, BAD_CAST GEOMETRIC_ERROR_ATT, BAD_CAST value);
 }
 
 
@@ -131,6 +197,11 @@ GridBasedFluorophoreProperty
     double sampleSpacing = atof(value);
     SetSampleSpacing(sampleSpacing);
   }
+
+  value = (char *) xmlGetProp(root, BAD_CAST GEOMETRIC_ERROR_ATT);
+  if (value) {
+    SetGeometricError(atof(value));
+  }
 }
 
 
@@ -3,7 +3,9 @@
 
 #include <FluorophoreModelObjectProperty.h>
 
+class vtkAnalyticPartialVolumeSource;
 class vtkPartialVolumeModeller;
+class vtkPassThrough;
 class vtkThresholdPoints;
 class vtkUnstructuredGridAlgorithm;
 
@@ -13,18 +15,39 @@ class GridBasedFluorophoreProperty : public FluorophoreModelObjectProperty {
  public:
 
   static const char* SAMPLE_SPACING_ATT;
+  static const char* GEOMETRIC_ERROR_ATT;
 
   GridBasedFluorophoreProperty(const std::string& name,
                                vtkUnstructuredGridAlgorithm* gridSource,
                                bool editable = false,
                                bool optimizable = true);
+
+  // Computes voxel coverage directly from the parameters of a primitive
+  // shape instead of voxelizing its tetrahedral mesh.
+  GridBasedFluorophoreProperty(const std::string& name,
+                               vtkAnalyticPartialVolumeSource* shapeSource,
+                               bool editable = false,
+                               bool optimizable = true);
   virtual ~GridBasedFluorophoreProperty();
 
   virtual void   SetSampleSpacing(double spacing);
   virtual double GetSampleSpacing();
 
+  // Largest distance between the tessellated geometry of a curved shape
+  // and its true surface, as a fraction of the sample spacing. Shapes
+  // that are large compared to the sample spacing get more facets.
+  virtual void   SetGeometricError(double error);
+  virtual double GetGeometricError();
+
+  // Geometric error in nanometers.
+  double GetMaximumGeometricError();
+
   virtual int GetNumberOfFluorophores();
 
+  // The voxels are computed in object coordinates, and the position and
+  // rotation of the object are applied to the fluorophores afterwards, so
+  // moving an object reuses its voxels. They are only recomputed when the
+  // shape, the scale, or the sample spacing changes.
   virtual void Update();
 
   virtual void GetXMLConfiguration(xmlNodePtr root);
@@ -36,10 +59,14 @@ class GridBasedFluorophoreProperty : public FluorophoreModelObjectProperty {
   virtual double GetDensityScale();
 
   double m_SampleSpacing;
-
-  vtkSmartPointer<vtkUnstructuredGridAlgorithm> m_GridSource;
-  vtkSmartPointer<vtkThresholdPoints>           m_Threshold;
-  vtkSmartPointer<vtkPartialVolumeModeller>     m_PartialVolumeVoxelizer;
+  double m_GeometricError;
+
+  // Only one of m_GridSource and m_ShapeSource is set.
+  vtkSmartPointer<vtkUnstructuredGridAlgorithm>   m_GridSource;
+  vtkSmartPointer<vtkAnalyticPartialVolumeSource> m_ShapeSource;
+  vtkSmartPointer<vtkThresholdPoints>             m_Threshold;
+  vtkSmartPointer<vtkPartialVolumeModeller>       m_PartialVolumeVoxelizer;
+  vtkSmartPointer<vtkPassThrough>                 m_SparseOutput;
 };
 
 
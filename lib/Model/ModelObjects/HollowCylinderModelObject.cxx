@@ -3,6 +3,8 @@
 #include <VolumeUniformFluorophoreProperty.h>
 #include <GridBasedFluorophoreProperty.h>
 
+#include <vtkAnalyticPartialVolumeSource.h>
+#include <vtkAnalyticUniformPointSampler.h>
 #include <vtkDataSetSurfaceFilter.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkVolumetricHollowCylinderSource.h>
@@ -27,7 +29,6 @@ HollowCylinderModelObject
 
   // Set up geometry
   m_HollowCylinderSource = vtkSmartPointer<vtkVolumetricHollowCylinderSource>::New();
-  m_HollowCylinderSource->SetResolution(32);
 
   vtkSmartPointer<vtkDataSetSurfaceFilter> surfaceFilter =
     vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
@@ -38,17 +39,28 @@ HollowCylinderModelObject
 
   SetGeometrySubAssembly("All", m_GeometrySource);
 
+  // Fluorophores are sampled from the shape parameters rather than
+  // from the tessellated geometry.
+  m_SurfaceSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_SurfaceSampler->SetShapeToHollowCylinder();
+  m_VolumeSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_VolumeSampler->SetShapeToHollowCylinder();
+
+  // Voxel coverage is also computed from the shape parameters.
+  m_PartialVolumeSource = vtkSmartPointer<vtkAnalyticPartialVolumeSource>::New();
+  m_PartialVolumeSource->SetShapeToHollowCylinder();
+
   // Set up properties
   AddProperty(new ModelObjectProperty(OUTER_RADIUS_PROP, 100.0, "nanometers"));
   AddProperty(new ModelObjectProperty(THICKNESS_PROP,     10.0, "nanometers"));
   AddProperty(new ModelObjectProperty(LENGTH_PROP,      1000.0, "nanometers"));
 
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, m_GeometrySource));
+              (SURFACE_FLUOR_PROP, m_SurfaceSampler));
   AddProperty(new VolumeUniformFluorophoreProperty
-              (VOLUME_FLUOR_PROP, m_HollowCylinderSource));
+              (VOLUME_FLUOR_PROP, m_VolumeSampler));
   AddProperty(new GridBasedFluorophoreProperty
-              (GRID_FLUOR_PROP, m_HollowCylinderSource));
+              (GRID_FLUOR_PROP, m_PartialVolumeSource));
 
   // Must call this after setting up properties
   Update();
@@ -70,6 +82,23 @@ HollowCylinderModelObject
   m_HollowCylinderSource->SetInnerRadius(outerRadius - thickness);
   m_HollowCylinderSource->SetHeight(GetProperty(LENGTH_PROP)->GetDoubleValue());
 
+  vtkAnalyticUniformPointSampler* samplers[2] = {m_SurfaceSampler, m_VolumeSampler};
+  for (int i = 0; i < 2; i++) {
+    samplers[i]->SetOuterRadius(outerRadius);
+    samplers[i]->SetInnerRadius(outerRadius - thickness);
+    samplers[i]->SetHeight(GetProperty(LENGTH_PROP)->GetDoubleValue());
+  }
+  m_PartialVolumeSource->SetOuterRadius(outerRadius);
+  m_PartialVolumeSource->SetInnerRadius(outerRadius - thickness);
+  m_PartialVolumeSource->SetHeight(GetProperty(LENGTH_PROP)->GetDoubleValue());
+
+  // Facet the geometry relative to the voxels of the grid fluorophore
+  // model, so objects that are small compared to the sample spacing get
+  // few facets.
+  GridBasedFluorophoreProperty* gridProperty =
+    dynamic_cast<GridBasedFluorophoreProperty*>(GetProperty(GRID_FLUOR_PROP));
+  m_HollowCylinderSource->SetMaximumError(gridProperty->GetMaximumGeometricError());
+
   // Call superclass update method
   ModelObject::Update();
 }
@@ -5,6 +5,8 @@
 
 #include <vtkSmartPointer.h>
 
+class vtkAnalyticPartialVolumeSource;
+class vtkAnalyticUniformPointSampler;
 class vtkPolyDataNormals;
 class vtkVolumetricHollowCylinderSource;
 
@@ -31,6 +33,9 @@ class HollowCylinderModelObject : public ModelObject {
 
   vtkSmartPointer<vtkVolumetricHollowCylinderSource> m_HollowCylinderSource;
   vtkSmartPointer<vtkPolyDataNormals>                m_GeometrySource;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_SurfaceSampler;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_VolumeSampler;
+  vtkSmartPointer<vtkAnalyticPartialVolumeSource> m_PartialVolumeSource;
 
 };
 
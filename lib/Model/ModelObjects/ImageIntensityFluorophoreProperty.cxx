@@ -0,0 +1,85 @@
+#include <ImageIntensityFluorophoreProperty.h>
+
+#include <vtkImageAlgorithm.h>
+#include <vtkImageIntensityPointSampler.h>
+#include <vtkPatternExpansionFilter.h>
+
+
+const char* ImageIntensityFluorophoreProperty::BACKGROUND_INTENSITY_ATT = "backgroundIntensity";
+
+
+ImageIntensityFluorophoreProperty::
+ImageIntensityFluorophoreProperty(const std::string& name,
+                                  vtkImageAlgorithm* imageSource,
+                                  bool editable, bool optimizable)
+  : UniformFluorophoreProperty(name, editable, optimizable) {
+
+  m_ImageSource = imageSource;
+
+  m_ImageSampler = vtkSmartPointer<vtkImageIntensityPointSampler>::New();
+  m_ImageSampler->SetInputConnection(m_ImageSource->GetOutputPort());
+  m_Sampler = m_ImageSampler;
+
+  m_PatternExpander->SetInputConnection(m_Sampler->GetOutputPort());
+
+  SetDensity(100.0);
+  SetSamplingModeToFixedDensity();
+  SetSamplePatternToSinglePoint();
+}
+
+
+ImageIntensityFluorophoreProperty::
+~ImageIntensityFluorophoreProperty() {
+}
+
+
+void
+ImageIntensityFluorophoreProperty
+::SetBackgroundIntensity(double intensity) {
+  m_ImageSampler->SetBackgroundIntensity(intensity);
+}
+
+
+double
+ImageIntensityFluorophoreProperty
+::GetBackgroundIntensity() {
+  return m_ImageSampler->GetBackgroundIntensity();
+}
+
+
+double
+ImageIntensityFluorophoreProperty
+::GetWeightedVolume() {
+  m_ImageSampler->Update();
+  return m_ImageSampler->GetWeightedVolume() * 1.0e-9;
+}
+
+
+double
+ImageIntensityFluorophoreProperty
+::GetDensityScale() {
+  return 1.0e-9;
+}
+
+
+void
+ImageIntensityFluorophoreProperty
+::GetXMLConfiguration(xmlNodePtr root) {
+  UniformFluorophoreProperty::GetXMLConfiguration(root);
+
+  char value[256];
+  sprintf(value, "%f", GetBackgroundIntensity());
+  xmlNewProp(root, BAD_CAST BACKGROUND_INTENSITY_ATT, BAD_CAST value);
+}
+
+
+void
+ImageIntensityFluorophoreProperty
+::RestoreFromXML(xmlNodePtr root) {
+  UniformFluorophoreProperty::RestoreFromXML(root);
+
+  char* value = (char*) xmlGetProp(root, BAD_CAST BACKGROUND_INTENSITY_ATT);
+  if (value) {
+    SetBackgroundIntensity(atof(value));
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef _IMAGE_INTENSITY_FLUOROPHORE_PROPERTY_H_
+#define _IMAGE_INTENSITY_FLUOROPHORE_PROPERTY_H_
+
+#include <UniformFluorophoreProperty.h>
+
+class vtkImageAlgorithm;
+class vtkImageIntensityPointSampler;
+
+
+// Places fluorophores at random with a density proportional to the
+// intensity of an image above a background intensity. Density is in
+// fluorophores per cubic micron at unit intensity.
+class ImageIntensityFluorophoreProperty : public UniformFluorophoreProperty {
+
+ public:
+  static const char* BACKGROUND_INTENSITY_ATT;
+
+  ImageIntensityFluorophoreProperty(const std::string& name,
+                                    vtkImageAlgorithm* imageSource,
+                                    bool editable = false,
+                                    bool optimizable = true);
+  virtual ~ImageIntensityFluorophoreProperty();
+
+  void   SetBackgroundIntensity(double intensity);
+  double GetBackgroundIntensity();
+
+  // Integral of the image intensity above the background, in cubic
+  // microns times intensity units.
+  double GetWeightedVolume();
+
+  virtual void GetXMLConfiguration(xmlNodePtr root);
+  virtual void RestoreFromXML(xmlNodePtr root);
+
+ protected:
+  ImageIntensityFluorophoreProperty() {};
+
+  virtual double GetDensityScale();
+
+  vtkSmartPointer<vtkImageAlgorithm>             m_ImageSource;
+  vtkSmartPointer<vtkImageIntensityPointSampler> m_ImageSampler;
+};
+
+
+#endif // _IMAGE_INTENSITY_FLUOROPHORE_PROPERTY_H_
@@ -1,5 +1,6 @@
 #include <ImageModelObject.h>
 
+#include <ImageIntensityFluorophoreProperty.h>
 #include <ModelObjectPropertyList.h>
 
 #include <vtkContourFilter.h>
@@ -12,6 +13,7 @@ const char* ImageModelObject::X_SPACING_PROP = "X Spacing";
 const char* ImageModelObject::Y_SPACING_PROP = "Y Spacing";
 const char* ImageModelObject::Z_SPACING_PROP = "Z Spacing";
 const char* ImageModelObject::ISO_VALUE_PROP = "Isovalue";
+const char* ImageModelObject::INTENSITY_FLUOR_PROP = "Intensity Fluorophore Model";
 
 
 ImageModelObject
@@ -23,8 +25,10 @@ ImageModelObject
 
   m_ImageReader = new ImageReader();
 
-  // Image changer info object
+  // Image changer info object. It sees an empty image until a file is
+  // loaded.
   m_InfoChanger = vtkSmartPointer<vtkImageChangeInformation>::New();
+  m_InfoChanger->SetInputData(vtkSmartPointer<vtkImageData>::New());
 
   // Set up isosurface object
   m_IsosurfaceSource = vtkSmartPointer<vtkContourFilter>::New();
@@ -33,6 +37,11 @@ ImageModelObject
 
   SetGeometrySubAssembly("All", m_IsosurfaceSource);
 
+  // Fluorophores are sampled from the image intensities directly rather
+  // than from the isosurface.
+  AddProperty(new ImageIntensityFluorophoreProperty
+              (INTENSITY_FLUOR_PROP, m_InfoChanger));
+
   Update();
 }
 
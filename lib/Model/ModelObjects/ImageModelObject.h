@@ -21,6 +21,7 @@ class ImageModelObject : public ModelObject {
   static const char* Y_SPACING_PROP;
   static const char* Z_SPACING_PROP;
   static const char* ISO_VALUE_PROP;
+  static const char* INTENSITY_FLUOR_PROP;
 
   ImageModelObject(DirtyListener* dirtyListener);
   virtual ~ImageModelObject();
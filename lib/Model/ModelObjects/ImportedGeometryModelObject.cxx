@@ -40,10 +40,12 @@ ImportedGeometryModelObject
 
   SetGeometrySubAssembly("All", m_TransformFilter);
 
+  // The fluorophore models are built from the unscaled geometry and
+  // scaled afterwards, so changing the scale does not tetrahedralize the
+  // geometry again.
   m_TriangleFilter = vtkSmartPointer<vtkTriangleFilter>::New();
   m_TriangleFilter->PassVertsOff();
   m_TriangleFilter->PassLinesOff();
-  m_TriangleFilter->SetInputConnection(m_TransformFilter->GetOutputPort());
 
   m_CleanPolyData = vtkSmartPointer<vtkCleanPolyData>::New();
   m_CleanPolyData->SetTolerance(0.0);
@@ -53,16 +55,21 @@ ImportedGeometryModelObject
   m_CleanPolyData->PointMergingOn();
   m_CleanPolyData->SetInputConnection(m_TriangleFilter->GetOutputPort());
 
+  m_SurfaceTransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  m_SurfaceTransformFilter->SetTransform(m_Transform);
+  m_SurfaceTransformFilter->SetInputConnection(m_CleanPolyData->GetOutputPort());
+
   // Perform the tetrahedralization here
   vtkSmartPointer<vtkPolyDataToTetrahedralGrid> tetrahedralizer =
     vtkSmartPointer<vtkPolyDataToTetrahedralGrid>::New();
   tetrahedralizer->SetInputConnection(m_CleanPolyData->GetOutputPort());
+  tetrahedralizer->SetTransform(m_Transform);
   
   // Set up properties
   AddProperty(new ModelObjectProperty(SCALE_PROP, 1.0, "-", true, true));
   AddProperty(new ModelObjectProperty(FILE_NAME_PROP, ModelObjectProperty::STRING_TYPE, "-", false, false));
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, m_CleanPolyData));
+              (SURFACE_FLUOR_PROP, m_SurfaceTransformFilter));
   AddProperty(new VolumeUniformFluorophoreProperty
               (VOLUME_FLUOR_PROP, tetrahedralizer));
   AddProperty(new GridBasedFluorophoreProperty
@@ -104,21 +111,25 @@ ImportedGeometryModelObject
     reader->SetFileName(fileName.c_str());
     reader->Update();
     m_TransformFilter->SetInputConnection(reader->GetOutputPort());
+    m_TriangleFilter->SetInputConnection(reader->GetOutputPort());
   } else if (extension == "ply") {
     vtkSmartPointer<vtkPLYReader> reader = vtkSmartPointer<vtkPLYReader>::New();
     reader->SetFileName(fileName.c_str());
     reader->Update();
     m_TransformFilter->SetInputConnection(reader->GetOutputPort());
+    m_TriangleFilter->SetInputConnection(reader->GetOutputPort());
   } else if (extension == "vtk") {
     vtkSmartPointer<vtkPolyDataReader> reader = vtkSmartPointer<vtkPolyDataReader>::New();
     reader->SetFileName(fileName.c_str());
     reader->Update();
     m_TransformFilter->SetInputConnection(reader->GetOutputPort());
+    m_TriangleFilter->SetInputConnection(reader->GetOutputPort());
   } else if (extension == "vtp") {
     vtkSmartPointer<vtkXMLPolyDataReader> reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
     reader->SetFileName(fileName.c_str());
     reader->Update();
     m_TransformFilter->SetInputConnection(reader->GetOutputPort());
+    m_TriangleFilter->SetInputConnection(reader->GetOutputPort());
   }
 
 }
@@ -41,6 +41,8 @@ protected:
 
   vtkSmartPointer<vtkTriangleFilter>  m_TriangleFilter;
   vtkSmartPointer<vtkCleanPolyData>   m_CleanPolyData;
+
+  vtkSmartPointer<vtkTransformPolyDataFilter> m_SurfaceTransformFilter;
 };
 
 typedef ImportedGeometryModelObject* ImportedGeometryModelObjectPtr;
@@ -91,6 +91,22 @@ ModelObject
 ::Initialize() {
   m_ObjectTypeName = OBJECT_TYPE_NAME;
   m_Color[0] = 0.8;   m_Color[1] = 0.8;   m_Color[2] = 0.8;
+
+  m_AllGeometry = vtkSmartPointer<vtkAppendPolyData>::New();
+
+  // The transform starts out as the identity, which matches the default
+  // position and rotation.
+  m_AllGeometryTransform = vtkSmartPointer<vtkTransform>::New();
+  m_AllGeometryPosition[0] = 0.0;
+  m_AllGeometryPosition[1] = 0.0;
+  m_AllGeometryPosition[2] = 0.0;
+  m_AllGeometryRotation[0] = 0.0;
+  m_AllGeometryRotation[1] = 1.0;
+  m_AllGeometryRotation[2] = 0.0;
+  m_AllGeometryRotation[3] = 0.0;
+
+  m_AllGeometryTransformed = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+  m_AllGeometryTransformed->SetTransform(m_AllGeometryTransform);
 }
 
 
@@ -421,47 +437,60 @@ ModelObject
 vtkPolyDataAlgorithm*
 ModelObject
 ::GetAllGeometry() {
-  vtkAppendPolyData* appender = vtkAppendPolyData::New();
-
-  SubAssemblyMapType::iterator iter;
-  for (iter = m_SubAssemblies.begin(); iter != m_SubAssemblies.end(); iter++) {
-    appender->AddInputConnection((*iter).second->GetOutputPort());
-  }
+  // A single sub-assembly is passed along as is rather than copied by
+  // the appender.
+  if (m_SubAssemblies.size() == 1)
+    return m_SubAssemblies.begin()->second;
 
-  return appender;
+  return m_AllGeometry;
 }
 
 
 vtkPolyDataAlgorithm*
 ModelObject
 ::GetAllGeometryTransformed() {
-  vtkTransform* transform = vtkTransform::New();
   double rotation[4];
   GetRotation(rotation);
   double position[3];
   GetPosition(position);
-  transform->Translate(position);
-  transform->RotateWXYZ(rotation[0], rotation[1], rotation[2], rotation[3]);
-  
-  vtkTransformPolyDataFilter* transformFilter = vtkTransformPolyDataFilter::New();
-  transformFilter->SetTransform(transform);
-  transform->Delete();
 
-  vtkPolyDataAlgorithm* geometry = GetAllGeometry();
-  transformFilter->SetInputConnection(geometry->GetOutputPort());
-  geometry->Delete();
-            
-  return transformFilter;
+  // Rebuilding the transform modifies it even if the values are the
+  // same, which would make the filter execute again.
+  bool samePose = true;
+  for (int i = 0; i < 3; i++) {
+    samePose = samePose && (m_AllGeometryPosition[i] == position[i]);
+  }
+  for (int i = 0; i < 4; i++) {
+    samePose = samePose && (m_AllGeometryRotation[i] == rotation[i]);
+  }
+
+  if (!samePose) {
+    m_AllGeometryTransform->Identity();
+    m_AllGeometryTransform->Translate(position);
+    m_AllGeometryTransform->RotateWXYZ(rotation[0], rotation[1], rotation[2], rotation[3]);
+    for (int i = 0; i < 3; i++) {
+      m_AllGeometryPosition[i] = position[i];
+    }
+    for (int i = 0; i < 4; i++) {
+      m_AllGeometryRotation[i] = rotation[i];
+    }
+  }
+
+  // Does nothing if the connection is unchanged.
+  m_AllGeometryTransformed->SetInputConnection(GetAllGeometry()->GetOutputPort());
+
+  return m_AllGeometryTransformed;
 }
 
 
 vtkPolyDataAlgorithm*
 ModelObject
 ::GetGeometrySubAssembly(const std::string& name) {
-  try {
-    return m_SubAssemblies[name];
-  } catch (...) {
-  }
+  // Look the name up without adding it to the map.
+  SubAssemblyMapType::iterator iter = m_SubAssemblies.find(name);
+  if (iter != m_SubAssemblies.end())
+    return (*iter).second;
+
   return NULL;
 }
 
@@ -470,6 +499,12 @@ void
 ModelObject
 ::SetGeometrySubAssembly(const std::string& name, vtkPolyDataAlgorithm* assembly) {
   m_SubAssemblies[name] = assembly;
+
+  m_AllGeometry->RemoveAllInputs();
+  SubAssemblyMapType::iterator iter;
+  for (iter = m_SubAssemblies.begin(); iter != m_SubAssemblies.end(); iter++) {
+    m_AllGeometry->AddInputConnection((*iter).second->GetOutputPort());
+  }
 }
 
 
@@ -9,6 +9,8 @@
 #include <ModelObjectProperty.h>
 #include <XMLStorable.h>
 
+#include <vtkSmartPointer.h>
+
 // Forward declarations
 class GeometrySource;
 class FluorophoreModelObjectProperty;
@@ -18,10 +20,13 @@ class ModelObjectPropertyList;
 typedef ModelObjectProperty* ModelObjectPropertyPtr;
 
 class vtkActor;
+class vtkAppendPolyData;
 class vtkPoints;
 class vtkPolyData;
 class vtkPolyDataAlgorithm;
 class vtkPolyDataCollection;
+class vtkTransform;
+class vtkTransformPolyDataFilter;
 
 
 class ModelObject : public DirtyListener, public XMLStorable {
@@ -99,6 +104,11 @@ class ModelObject : public DirtyListener, public XMLStorable {
   void GetColor(double color[3]);
   double* GetColor();
 
+  /** Get the geometry of all sub-assemblies, in object coordinates and
+      moved to the object's position and rotation. The returned
+      algorithms belong to this object and should not be deleted. They
+      are kept between calls, so their outputs are only recomputed when
+      a sub-assembly or the position or rotation changes. */
   vtkPolyDataAlgorithm* GetAllGeometry();
   vtkPolyDataAlgorithm* GetAllGeometryTransformed();
   vtkPolyDataAlgorithm* GetGeometrySubAssembly(const std::string& name);
@@ -126,6 +136,14 @@ class ModelObject : public DirtyListener, public XMLStorable {
   typedef std::map<std::string, vtkPolyDataAlgorithm*> SubAssemblyMapType;
   SubAssemblyMapType m_SubAssemblies;
 
+  vtkSmartPointer<vtkAppendPolyData>          m_AllGeometry;
+  vtkSmartPointer<vtkTransform>               m_AllGeometryTransform;
+  vtkSmartPointer<vtkTransformPolyDataFilter> m_AllGeometryTransformed;
+
+  // Position and rotation m_AllGeometryTransform was built from.
+  double m_AllGeometryPosition[3];
+  double m_AllGeometryRotation[4];
+
   ModelObjectPropertyList* CreateDefaultProperties();
 
   void SetGeometrySubAssembly(const std::string& name, vtkPolyDataAlgorithm* assembly);
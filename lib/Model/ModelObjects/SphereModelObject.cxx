@@ -5,6 +5,8 @@
 #include <VolumeUniformFluorophoreProperty.h>
 #include <GridBasedFluorophoreProperty.h>
 
+#include <vtkAnalyticPartialVolumeSource.h>
+#include <vtkAnalyticUniformPointSampler.h>
 #include <vtkDataSetSurfaceFilter.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkVolumetricEllipsoidSource.h>
@@ -27,8 +29,6 @@ SphereModelObject
 
   // Set up geometry
   m_SphereSource = vtkSmartPointer<vtkVolumetricEllipsoidSource>::New();
-  m_SphereSource->SetThetaResolution(32);
-  m_SphereSource->SetPhiResolution(16);
 
   vtkSmartPointer<vtkDataSetSurfaceFilter> surfaceFilter =
     vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
@@ -39,15 +39,26 @@ SphereModelObject
 
   SetGeometrySubAssembly("All", m_GeometrySource);
 
+  // Fluorophores are sampled from the shape parameters rather than
+  // from the tessellated geometry.
+  m_SurfaceSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_SurfaceSampler->SetShapeToEllipsoid();
+  m_VolumeSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_VolumeSampler->SetShapeToEllipsoid();
+
+  // Voxel coverage is also computed from the shape parameters.
+  m_PartialVolumeSource = vtkSmartPointer<vtkAnalyticPartialVolumeSource>::New();
+  m_PartialVolumeSource->SetShapeToEllipsoid();
+
   // Set up properties
   AddProperty(new ModelObjectProperty(RADIUS_PROP, 100.0, "nanometers"));
 
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, m_GeometrySource));
+              (SURFACE_FLUOR_PROP, m_SurfaceSampler));
   AddProperty(new VolumeUniformFluorophoreProperty
-              (VOLUME_FLUOR_PROP, m_SphereSource));
+              (VOLUME_FLUOR_PROP, m_VolumeSampler));
   AddProperty(new GridBasedFluorophoreProperty
-              (GRID_FLUOR_PROP, m_SphereSource));
+              (GRID_FLUOR_PROP, m_PartialVolumeSource));
 
   // Must call this after setting up properties
   Update();
@@ -65,6 +76,16 @@ SphereModelObject
 ::Update() {
   double radius = GetProperty("Radius")->GetDoubleValue();
   m_SphereSource->SetRadius(radius, radius, radius);
+  m_SurfaceSampler->SetRadii(radius, radius, radius);
+  m_VolumeSampler->SetRadii(radius, radius, radius);
+  m_PartialVolumeSource->SetRadii(radius, radius, radius);
+
+  // Facet the geometry relative to the voxels of the grid fluorophore
+  // model, so objects that are small compared to the sample spacing get
+  // few facets.
+  GridBasedFluorophoreProperty* gridProperty =
+    dynamic_cast<GridBasedFluorophoreProperty*>(GetProperty(GRID_FLUOR_PROP));
+  m_SphereSource->SetMaximumError(gridProperty->GetMaximumGeometricError());
 
   // Call superclass update method
   ModelObject::Update();
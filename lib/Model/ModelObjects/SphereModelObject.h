@@ -10,6 +10,8 @@
 
 #include <vtkSmartPointer.h>
 
+class vtkAnalyticPartialVolumeSource;
+class vtkAnalyticUniformPointSampler;
 class vtkPolyDataNormals;
 class vtkVolumetricEllipsoidSource;
 
@@ -36,6 +38,9 @@ class SphereModelObject : public ModelObject {
 
   vtkSmartPointer<vtkVolumetricEllipsoidSource> m_SphereSource;
   vtkSmartPointer<vtkPolyDataNormals>           m_GeometrySource;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_SurfaceSampler;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_VolumeSampler;
+  vtkSmartPointer<vtkAnalyticPartialVolumeSource> m_PartialVolumeSource;
 
 };
 
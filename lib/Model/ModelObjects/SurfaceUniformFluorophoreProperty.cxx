@@ -1,8 +1,8 @@
 #include <SurfaceUniformFluorophoreProperty.h>
 
-#include <vtkGlyph3D.h>
+#include <vtkAnalyticUniformPointSampler.h>
+#include <vtkPatternExpansionFilter.h>
 #include <vtkPolyDataAlgorithm.h>
-#include <vtkProgrammableGlyphFilter.h>
 #include <vtkSurfaceUniformPointSampler.h>
 #include <vtkTriangleFilter.h>
 
@@ -24,7 +24,25 @@ SurfaceUniformFluorophoreProperty(const std::string& name,
   m_SurfaceSampler->SetInputConnection(triangulizer->GetOutputPort());
   m_Sampler = m_SurfaceSampler;
 
-  m_Glypher->SetInputConnection(m_Sampler->GetOutputPort());
+  m_PatternExpander->SetInputConnection(m_Sampler->GetOutputPort());
+
+  SetDensity(100.0);
+  SetSamplingModeToFixedDensity();
+  SetSamplePatternToSinglePoint();
+}
+
+
+SurfaceUniformFluorophoreProperty::
+SurfaceUniformFluorophoreProperty(const std::string& name,
+                                  vtkAnalyticUniformPointSampler* analyticSampler,
+                                  bool editable, bool optimizable)
+  : UniformFluorophoreProperty(name, editable, optimizable) {
+
+  m_AnalyticSampler = analyticSampler;
+  m_AnalyticSampler->SampleVolumeOff();
+  m_Sampler = m_AnalyticSampler;
+
+  m_PatternExpander->SetInputConnection(m_Sampler->GetOutputPort());
 
   SetDensity(100.0);
   SetSamplingModeToFixedDensity();
@@ -40,6 +58,8 @@ SurfaceUniformFluorophoreProperty::
 double
 SurfaceUniformFluorophoreProperty
 ::GetGeometryArea() {
+  if (m_AnalyticSampler)
+    return m_AnalyticSampler->ComputeSurfaceArea() * 1.0e-6;
   return m_SurfaceSampler->GetSurfaceArea() * 1.0e-6;
 }
 
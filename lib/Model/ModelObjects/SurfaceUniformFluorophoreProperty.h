@@ -3,6 +3,7 @@
 
 #include <UniformFluorophoreProperty.h>
 
+class vtkAnalyticUniformPointSampler;
 class vtkPolyDataAlgorithm;
 class vtkSurfaceUniformPointSampler;
 
@@ -14,6 +15,14 @@ class SurfaceUniformFluorophoreProperty : public UniformFluorophoreProperty {
                                     vtkPolyDataAlgorithm* surfaceSource,
                                     bool editable = false,
                                     bool optimizable = true);
+
+  // Samples the surface of a primitive shape directly from the given
+  // analytic sampler, which the owner keeps up to date with the shape
+  // parameters.
+  SurfaceUniformFluorophoreProperty(const std::string& name,
+                                    vtkAnalyticUniformPointSampler* analyticSampler,
+                                    bool editable = false,
+                                    bool optimizable = true);
   virtual ~SurfaceUniformFluorophoreProperty();
 
   double GetGeometryArea();
@@ -25,6 +34,7 @@ class SurfaceUniformFluorophoreProperty : public UniformFluorophoreProperty {
 
   vtkSmartPointer<vtkPolyDataAlgorithm>          m_SurfaceSource;
   vtkSmartPointer<vtkSurfaceUniformPointSampler> m_SurfaceSampler;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_AnalyticSampler;
 };
 
 
@@ -3,6 +3,8 @@
 #include <VolumeUniformFluorophoreProperty.h>
 #include <GridBasedFluorophoreProperty.h>
 
+#include <vtkAnalyticPartialVolumeSource.h>
+#include <vtkAnalyticUniformPointSampler.h>
 #include <vtkDataSetSurfaceFilter.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkVolumetricTorusSource.h>
@@ -26,8 +28,6 @@ TorusModelObject
 
   // Set up geometry
   m_TorusSource = vtkSmartPointer<vtkVolumetricTorusSource>::New();
-  m_TorusSource->SetThetaResolution(32);
-  m_TorusSource->SetPhiResolution(16);
 
   vtkSmartPointer<vtkDataSetSurfaceFilter> surfaceFilter =
     vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
@@ -38,16 +38,27 @@ TorusModelObject
  
   SetGeometrySubAssembly("All", m_GeometrySource);
 
+  // Fluorophores are sampled from the shape parameters rather than
+  // from the tessellated geometry.
+  m_SurfaceSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_SurfaceSampler->SetShapeToTorus();
+  m_VolumeSampler = vtkSmartPointer<vtkAnalyticUniformPointSampler>::New();
+  m_VolumeSampler->SetShapeToTorus();
+
+  // Voxel coverage is also computed from the shape parameters.
+  m_PartialVolumeSource = vtkSmartPointer<vtkAnalyticPartialVolumeSource>::New();
+  m_PartialVolumeSource->SetShapeToTorus();
+
   // Set up properties
   AddProperty(new ModelObjectProperty(CROSS_SECTION_RADIUS_PROP, 100.0, "nanometers"));
   AddProperty(new ModelObjectProperty(RING_RADIUS_PROP, 500.0, "nanometers"));
 
   AddProperty(new SurfaceUniformFluorophoreProperty
-              (SURFACE_FLUOR_PROP, surfaceFilter));
+              (SURFACE_FLUOR_PROP, m_SurfaceSampler));
   AddProperty(new VolumeUniformFluorophoreProperty
-              (VOLUME_FLUOR_PROP, m_TorusSource));
+              (VOLUME_FLUOR_PROP, m_VolumeSampler));
   AddProperty(new GridBasedFluorophoreProperty
-              (GRID_FLUOR_PROP, m_TorusSource));
+              (GRID_FLUOR_PROP, m_PartialVolumeSource));
 
   // Must call this after setting up properties
   Update();
@@ -66,6 +77,21 @@ TorusModelObject
   m_TorusSource->SetCrossSectionRadius(GetProperty(CROSS_SECTION_RADIUS_PROP)->GetDoubleValue());
   m_TorusSource->SetRingRadius(GetProperty(RING_RADIUS_PROP)->GetDoubleValue());
 
+  vtkAnalyticUniformPointSampler* samplers[2] = {m_SurfaceSampler, m_VolumeSampler};
+  for (int i = 0; i < 2; i++) {
+    samplers[i]->SetCrossSectionRadius(GetProperty(CROSS_SECTION_RADIUS_PROP)->GetDoubleValue());
+    samplers[i]->SetRingRadius(GetProperty(RING_RADIUS_PROP)->GetDoubleValue());
+  }
+  m_PartialVolumeSource->SetCrossSectionRadius(GetProperty(CROSS_SECTION_RADIUS_PROP)->GetDoubleValue());
+  m_PartialVolumeSource->SetRingRadius(GetProperty(RING_RADIUS_PROP)->GetDoubleValue());
+
+  // Facet the geometry relative to the voxels of the grid fluorophore
+  // model, so objects that are small compared to the sample spacing get
+  // few facets.
+  GridBasedFluorophoreProperty* gridProperty =
+    dynamic_cast<GridBasedFluorophoreProperty*>(GetProperty(GRID_FLUOR_PROP));
+  m_TorusSource->SetMaximumError(gridProperty->GetMaximumGeometricError());
+
   // Call superclass update method
   ModelObject::Update();
 }
@@ -4,6 +4,8 @@
 #include <ModelObject.h>
 #include <vtkSmartPointer.h>
 
+class vtkAnalyticPartialVolumeSource;
+class vtkAnalyticUniformPointSampler;
 class vtkPolyDataNormals;
 class vtkVolumetricTorusSource;
 
@@ -30,6 +32,9 @@ class TorusModelObject : public ModelObject {
 
   vtkSmartPointer<vtkVolumetricTorusSource> m_TorusSource;
   vtkSmartPointer<vtkPolyDataNormals>       m_GeometrySource;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_SurfaceSampler;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_VolumeSampler;
+  vtkSmartPointer<vtkAnalyticPartialVolumeSource> m_PartialVolumeSource;
 
 };
 
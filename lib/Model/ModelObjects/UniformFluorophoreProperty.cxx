@@ -2,12 +2,8 @@
 
 
 #include <vtkPointRingSource.h>
-#include <vtkMath.h>
-#include <vtkMinimalStandardRandomSequence.h>
 #include <vtkPassThrough.h>
-#include <vtkProgrammableGlyphFilter.h>
-#include <vtkTransform.h>
-#include <vtkTransformPolyDataFilter.h>
+#include <vtkPatternExpansionFilter.h>
 #include <vtkUniformPointSampler.h>
 
 
@@ -22,6 +18,9 @@ const char* UniformFluorophoreProperty::POINT_RING_VALUE = "pointRing";
 const char* UniformFluorophoreProperty::NUMBER_OF_RING_FLUOROPHORES_ATT = "numberOfRingFluorophores";
 const char* UniformFluorophoreProperty::RING_RADIUS_ATT = "ringRadius";
 const char* UniformFluorophoreProperty::RANDOMIZE_PATTERN_ORIENTATIONS_ATT = "randomizePatternOrientations";
+const char* UniformFluorophoreProperty::RANDOM_SEED_ATT = "randomSeed";
+const char* UniformFluorophoreProperty::COMPACT_OUTPUT_ATT = "compactOutput";
+const char* UniformFluorophoreProperty::LOW_DISCREPANCY_ATT = "lowDiscrepancy";
 
 
 UniformFluorophoreProperty::
@@ -30,26 +29,16 @@ UniformFluorophoreProperty(const std::string& name,
   : FluorophoreModelObjectProperty(name, editable, optimizable) {
 
   // Subclasses need to set up specific samplers and connect them to
-  // the point ring glypher and the set it as the fluorophore output.
+  // the pattern expander and the set it as the fluorophore output.
   m_PointRingRadius = 10.0;
-  m_RandomizePatternOrientations = false;
 
   m_PointRingSource = vtkSmartPointer<vtkPointRingSource>::New();
   m_PointRingSource->SetRadius(10.0);
   m_PointRingSource->SetNumberOfPoints(2);
 
-  m_Transform = vtkSmartPointer<vtkTransform>::New();
-  m_Transform->Identity();
-
-  m_TransformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
-  m_TransformFilter->SetTransform(m_Transform);
-  m_TransformFilter->SetInputConnection(m_PointRingSource->GetOutputPort());
-
-  m_Glypher = vtkSmartPointer<vtkProgrammableGlyphFilter>::New();
-  m_Glypher->SetGlyphMethod(GlyphFunction, (void*) this);
-  m_Glypher->SetSourceData(m_TransformFilter->GetOutput());
-
-  m_RandomSequence = vtkSmartPointer<vtkMinimalStandardRandomSequence>::New();
+  m_PatternExpander = vtkSmartPointer<vtkPatternExpansionFilter>::New();
+  m_PatternExpander->SetPatternConnection(m_PointRingSource->GetOutputPort());
+  m_PatternExpander->RandomizeOrientationsOff();
 
   m_PassThroughFilter = vtkSmartPointer<vtkPassThrough>::New();
 
@@ -102,7 +91,11 @@ void
 UniformFluorophoreProperty
 ::SetDensity(double density) {
   m_Sampler->SetDensity(density * GetDensityScale());
-  RegenerateFluorophores(); // Ensure resampling is performed no matter what
+
+  // Ensure the sampler runs no matter what. Existing fluorophores are
+  // kept; only the difference in number is added or dropped.
+  m_Sampler->Modified();
+  m_Sampler->Update();
 }
 
 
@@ -136,8 +129,7 @@ UniformFluorophoreProperty
   if (m_SamplePattern == SINGLE_POINT) {
     m_PassThroughFilter->SetInputConnection(m_Sampler->GetOutputPort());
   } else if (m_SamplePattern == POINT_RING) {
-    //m_PassThroughFilter->SetInputConnection(m_PointRingGlypher->GetOutputPort());
-    m_PassThroughFilter->SetInputConnection(m_Glypher->GetOutputPort());
+    m_PassThroughFilter->SetInputConnection(m_PatternExpander->GetOutputPort());
   }
 }
 
@@ -194,7 +186,7 @@ UniformFluorophoreProperty
 void
 UniformFluorophoreProperty
 ::SetRandomizePatternOrientations(bool enabled) {
-  m_RandomizePatternOrientations = enabled;
+  m_PatternExpander->SetRandomizeOrientations(enabled ? 1 : 0);
 }
 
 
@@ -215,79 +207,57 @@ UniformFluorophoreProperty
 bool
 UniformFluorophoreProperty
 ::GetRandomizePatternOrientations() {
-  return m_RandomizePatternOrientations;
+  return m_PatternExpander->GetRandomizeOrientations() != 0;
 }
 
 
-vtkTransform*
+void
 UniformFluorophoreProperty
-::GetGlyphTransform() {
-  return m_Transform;
+::SetRandomSeed(unsigned int seed) {
+  m_Sampler->SetSeed(seed);
+  m_PatternExpander->SetSeed(seed);
 }
 
 
-vtkProgrammableGlyphFilter*
+unsigned int
 UniformFluorophoreProperty
-::GetGlypher() {
-  return m_Glypher;
+::GetRandomSeed() {
+  return m_Sampler->GetSeed();
 }
 
 
-vtkMinimalStandardRandomSequence*
+void
 UniformFluorophoreProperty
-::GetRandomSequence() {
-  return m_RandomSequence;
+::SetCompactOutput(bool compact) {
+  m_Sampler->SetCompactOutput(compact ? 1 : 0);
 }
 
 
-void UniformFluorophoreProperty::GlyphFunction(void* arg) {
-  UniformFluorophoreProperty* property = 
-    reinterpret_cast<UniformFluorophoreProperty*>(arg);
-  if (!property) {
-    std::cout << "UniformFluorophoreProperty not set in GlyphFunction" << std::endl;
-    return;
-  }
+bool
+UniformFluorophoreProperty
+::GetCompactOutput() {
+  return m_Sampler->GetCompactOutput() != 0;
+}
 
-  vtkProgrammableGlyphFilter* glypher = property->GetGlypher();
-
-  vtkTransform* transform = property->GetGlyphTransform();
-  
-  // Generate random quaternion here
-  vtkMinimalStandardRandomSequence* randomSequence = property->GetRandomSequence();
-  double u1 = randomSequence->GetValue();
-  randomSequence->Next();
-  double u2 = randomSequence->GetValue();
-  randomSequence->Next();
-  double u3 = randomSequence->GetValue();
-  randomSequence->Next();
-
-  transform->Identity();
-  transform->Translate(glypher->GetPoint());
-
-  if (property->GetRandomizePatternOrientations()) {
-
-    // This is from http://planning.cs.uiuc.edu/node198.html
-    double twoPi = 2.0 * vtkMath::Pi();
-    double q1 = sqrt(1.0-u1) * sin(twoPi*u2);
-    double q2 = sqrt(1.0-u1) * cos(twoPi*u2);
-    double q3 = sqrt(u1)     * sin(twoPi*u3);
-    double q4 = sqrt(u1)     * cos(twoPi*u3);
-    
-    // Convert quaternion to rotation and vector
-    double theta = vtkMath::DegreesFromRadians(2.0 * acos(q1));
-    double v1    = q2 / sin(0.5 * theta);
-    double v2    = q3 / sin(0.5 * theta);
-    double v3    = q4 / sin(0.5 * theta);
-
-    transform->RotateWXYZ(theta, v1, v2, v3);
-  }
+
+void
+UniformFluorophoreProperty
+::SetLowDiscrepancySampling(bool enabled) {
+  m_Sampler->SetLowDiscrepancy(enabled ? 1 : 0);
+}
+
+
+bool
+UniformFluorophoreProperty
+::GetLowDiscrepancySampling() {
+  return m_Sampler->GetLowDiscrepancy() != 0;
 }
 
 
 void
 UniformFluorophoreProperty
 ::RegenerateFluorophores() {
-  m_Sampler->Modified();
+  SetRandomSeed(GetRandomSeed() + 1);
   m_Sampler->Update();
 }
 
@@ -324,6 +294,19 @@ UniformFluorophoreProperty
     xmlNewProp(root, BAD_CAST RANDOMIZE_PATTERN_ORIENTATIONS_ATT, BAD_CAST "true");
   else
     xmlNewProp(root, BAD_CAST RANDOMIZE_PATTERN_ORIENTATIONS_ATT, BAD_CAST "false");
+
+  sprintf(value, "%u", GetRandomSeed());
+  xmlNewProp(root, BAD_CAST RANDOM_SEED_ATT, BAD_CAST value);
+
+  if (GetCompactOutput())
+    xmlNewProp(root, BAD_CAST COMPACT_OUTPUT_ATT, BAD_CAST "true");
+  else
+    xmlNewProp(root, BAD_CAST COMPACT_OUTPUT_ATT, BAD_CAST "false");
+
+  if (GetLowDiscrepancySampling())
+    xmlNewProp(root, BAD_CAST LOW_DISCREPANCY_ATT, BAD_CAST "true");
+  else
+    xmlNewProp(root, BAD_CAST LOW_DISCREPANCY_ATT, BAD_CAST "false");
 }
 
 
@@ -332,13 +315,7 @@ UniformFluorophoreProperty
 ::RestoreFromXML(xmlNodePtr root) {
   FluorophoreModelObjectProperty::RestoreFromXML(root);
 
-  char* value = (char*) xmlGetProp(root, BAD_CAST DENSITY_ATT);
-  if (value) {
-    double density = atof(value);
-    SetDensity(density);
-  }
-
-  value = (char*) xmlGetProp(root, BAD_CAST NUMBER_OF_FLUOROPHORES_ATT);
+  char* value = (char*) xmlGetProp(root, BAD_CAST NUMBER_OF_FLUOROPHORES_ATT);
   if (value) {
     int numFluorophores = atoi(value);
     SetNumberOfFluorophores(numFluorophores);
@@ -381,4 +358,27 @@ UniformFluorophoreProperty
     else 
       RandomizePatternOrientationsOff();
   }
+
+  value = (char*) xmlGetProp(root, BAD_CAST RANDOM_SEED_ATT);
+  if (value) {
+    SetRandomSeed(static_cast<unsigned int>(strtoul(value, NULL, 10)));
+  }
+
+  value = (char*) xmlGetProp(root, BAD_CAST COMPACT_OUTPUT_ATT);
+  if (value) {
+    SetCompactOutput(std::string(value) == "true");
+  }
+
+  value = (char*) xmlGetProp(root, BAD_CAST LOW_DISCREPANCY_ATT);
+  if (value) {
+    SetLowDiscrepancySampling(std::string(value) == "true");
+  }
+
+  // Setting the density samples the geometry, so restore it last to
+  // sample only once with the restored settings.
+  value = (char*) xmlGetProp(root, BAD_CAST DENSITY_ATT);
+  if (value) {
+    double density = atof(value);
+    SetDensity(density);
+  }
 }
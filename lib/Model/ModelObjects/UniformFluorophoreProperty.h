@@ -3,12 +3,9 @@
 
 #include <FluorophoreModelObjectProperty.h>
 
-class vtkMinimalStandardRandomSequence;
 class vtkPassThrough;
+class vtkPatternExpansionFilter;
 class vtkPointRingSource;
-class vtkProgrammableGlyphFilter;
-class vtkTransform;
-class vtkTransformPolyDataFilter;
 class vtkUniformPointSampler;
 
 
@@ -27,6 +24,9 @@ class UniformFluorophoreProperty : public FluorophoreModelObjectProperty {
   static const char* NUMBER_OF_RING_FLUOROPHORES_ATT;
   static const char* RING_RADIUS_ATT;
   static const char* RANDOMIZE_PATTERN_ORIENTATIONS_ATT;
+  static const char* RANDOM_SEED_ATT;
+  static const char* COMPACT_OUTPUT_ATT;
+  static const char* LOW_DISCREPANCY_ATT;
 
   typedef enum {
     FIXED_DENSITY,
@@ -70,6 +70,23 @@ class UniformFluorophoreProperty : public FluorophoreModelObjectProperty {
   void RandomizePatternOrientationsOff();
   bool GetRandomizePatternOrientations();
 
+  // The same seed reproduces the same fluorophore positions.
+  void         SetRandomSeed(unsigned int seed);
+  unsigned int GetRandomSeed();
+
+  // Stores fluorophores as single-precision points with no vertex cells.
+  // Applies to the single point pattern; patterns are glyphed into
+  // regular poly data.
+  void SetCompactOutput(bool compact);
+  bool GetCompactOutput();
+
+  // Places fluorophores along a randomly shifted Sobol sequence instead
+  // of independently, which reduces sampling noise in simulated images
+  // for a given number of fluorophores.
+  void SetLowDiscrepancySampling(bool enabled);
+  bool GetLowDiscrepancySampling();
+
+  // Draws a new set of fluorophores by advancing the random seed.
   void RegenerateFluorophores();
  
   virtual void GetXMLConfiguration(xmlNodePtr root);
@@ -86,26 +103,14 @@ class UniformFluorophoreProperty : public FluorophoreModelObjectProperty {
 
   SamplePattern_t m_SamplePattern;
 
-  vtkSmartPointer<vtkTransform>               m_Transform;
-  vtkSmartPointer<vtkTransformPolyDataFilter> m_TransformFilter;
-
   double                              m_PointRingRadius;
   vtkSmartPointer<vtkPointRingSource> m_PointRingSource;
 
-  vtkSmartPointer<vtkProgrammableGlyphFilter> m_Glypher;
-
-  bool m_RandomizePatternOrientations;
-
-  vtkSmartPointer<vtkMinimalStandardRandomSequence> m_RandomSequence;
+  // Places the point ring at every sample.
+  vtkSmartPointer<vtkPatternExpansionFilter> m_PatternExpander;
 
   virtual double GetDensityScale() = 0;
 
-  static void GlyphFunction(void* arg);
-
-  vtkTransform*                     GetGlyphTransform();
-  vtkProgrammableGlyphFilter*       GetGlypher();
-  vtkMinimalStandardRandomSequence* GetRandomSequence();
-
 };
 
 #endif // _UNIFORM_FLUOROPHORE_PROPERTY_H_
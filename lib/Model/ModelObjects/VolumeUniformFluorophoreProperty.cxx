@@ -1,8 +1,8 @@
 #include <VolumeUniformFluorophoreProperty.h>
 
-#include <vtkGlyph3D.h>
+#include <vtkAnalyticUniformPointSampler.h>
+#include <vtkPatternExpansionFilter.h>
 #include <vtkPolyDataToTetrahedralGrid.h>
-#include <vtkProgrammableGlyphFilter.h>
 #include <vtkUnstructuredGridAlgorithm.h>
 #include <vtkVolumeUniformPointSampler.h>
 
@@ -19,7 +19,25 @@ VolumeUniformFluorophoreProperty(const std::string& name,
   m_VolumeSampler->SetInputConnection(m_GridSource->GetOutputPort());
   m_Sampler = m_VolumeSampler;
 
-  m_Glypher->SetInputConnection(m_Sampler->GetOutputPort());
+  m_PatternExpander->SetInputConnection(m_Sampler->GetOutputPort());
+
+  SetDensity(100.0);
+  SetSamplingModeToFixedDensity();
+  SetSamplePatternToSinglePoint();
+}
+
+
+VolumeUniformFluorophoreProperty::
+VolumeUniformFluorophoreProperty(const std::string& name,
+                                 vtkAnalyticUniformPointSampler* analyticSampler,
+                                 bool editable, bool optimizable)
+  : UniformFluorophoreProperty(name, editable, optimizable) {
+
+  m_AnalyticSampler = analyticSampler;
+  m_AnalyticSampler->SampleVolumeOn();
+  m_Sampler = m_AnalyticSampler;
+
+  m_PatternExpander->SetInputConnection(m_Sampler->GetOutputPort());
 
   SetDensity(100.0);
   SetSamplingModeToFixedDensity();
@@ -35,6 +53,8 @@ VolumeUniformFluorophoreProperty::
 double
 VolumeUniformFluorophoreProperty
 ::GetGeometryVolume() {
+  if (m_AnalyticSampler)
+    return m_AnalyticSampler->ComputeVolume() * 1.0e-9;
   return m_VolumeSampler->GetVolume() * 1.0e-9;
 }
 
@@ -3,6 +3,7 @@
 
 #include <UniformFluorophoreProperty.h>
 
+class vtkAnalyticUniformPointSampler;
 class vtkUnstructuredGridAlgorithm;
 class vtkVolumeUniformPointSampler;
 
@@ -14,6 +15,14 @@ class VolumeUniformFluorophoreProperty : public UniformFluorophoreProperty {
                                     vtkUnstructuredGridAlgorithm* gridSource,
                                     bool editable = false,
                                     bool optimizable = true);
+
+  // Samples the interior of a primitive shape directly from the given
+  // analytic sampler, which the owner keeps up to date with the shape
+  // parameters.
+  VolumeUniformFluorophoreProperty(const std::string& name,
+                                    vtkAnalyticUniformPointSampler* analyticSampler,
+                                    bool editable = false,
+                                    bool optimizable = true);
   virtual ~VolumeUniformFluorophoreProperty();
 
   double GetGeometryVolume();
@@ -25,6 +34,7 @@ class VolumeUniformFluorophoreProperty : public UniformFluorophoreProperty {
 
   vtkSmartPointer<vtkUnstructuredGridAlgorithm> m_GridSource;
   vtkSmartPointer<vtkVolumeUniformPointSampler> m_VolumeSampler;
+  vtkSmartPointer<vtkAnalyticUniformPointSampler> m_AnalyticSampler;
 };
 
 
@@ -20,11 +20,12 @@
 #include "vtkImplicitPolyData.h"
 
 #include "vtkObjectFactory.h"
-#include "vtkPolygon.h"
 #include "vtkPointData.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
-#include "vtkGenericCell.h"
+#include "vtkPoints.h"
+#include "vtkTriangle.h"
+#include "vtkTriangleBVH.h"
 
 #include "vtkMath.h"
 
@@ -32,22 +33,33 @@
 // from David.Pont@ForestResearch.co.nz, but slowly changed the class to the current
 // version, which uses a different approach. It should probably be renamed ...
 
-vtkCxxRevisionMacro(vtkImplicitPolyData, "$Revision: 1.1 $");
 vtkStandardNewMacro(vtkImplicitPolyData);
 
+struct vtkImplicitPolyDataThreadInfo
+{
+   vtkImplicitPolyData *Self;
+   vtkPoints           *Points;
+   vtkDataArray        *Values;
+};
+
 // Constructor
 vtkImplicitPolyData::vtkImplicitPolyData()
 {
-	this->NoGradient[0] = 0.0;
-	this->NoGradient[1] = 0.0;
-	this->NoGradient[2] = 1.0;
+   this->NoGradient[0] = 0.0;
+   this->NoGradient[1] = 0.0;
+   this->NoGradient[2] = 1.0;
+
+   this->NoValue = 0.0;
 
-	this->tri = NULL;
-	this->input = NULL;
+   this->tri = NULL;
+   this->input = NULL;
    this->locator = NULL;
    this->EvaluateBoundsSet=0;
    this->ReverseBias = 0;
    this->Tolerance = -1;
+
+   this->Threader = vtkMultiThreader::New();
+   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
 }
 
 void vtkImplicitPolyData::SetInput(vtkPolyData* input)
@@ -61,11 +73,11 @@ void vtkImplicitPolyData::SetInput(vtkPolyData* input)
       // polygons which are required by this algorithm for cell normals
       if (this->tri == NULL)
       {
-		   this->tri = vtkTriangleFilter::New();
-		   this->tri->PassVertsOff();
-		   this->tri->PassLinesOff();
+         this->tri = vtkTriangleFilter::New();
+         this->tri->PassVertsOff();
+         this->tri->PassLinesOff();
       }
-      this->tri->SetInput(input);
+      this->tri->SetInputData(input);
       this->tri->Update();
 
       this->input = this->tri->GetOutput();
@@ -73,15 +85,12 @@ void vtkImplicitPolyData::SetInput(vtkPolyData* input)
       this->input->BuildLinks();
       this->NoValue = this->input->GetLength();
       if (this->Tolerance < 0)
-	      this->Tolerance = this->NoValue * 1e-12;
+         this->Tolerance = this->NoValue * 1e-12;
 
-      if (this->locator != NULL) this->locator->Delete();
-      this->locator = vtkCellLocator::New();
+      // the hierarchy finds the closest triangle directly, instead of
+      // searching buckets of cells
+      if (this->locator == NULL) this->locator = vtkTriangleBVH::New();
       this->locator->SetDataSet(this->input);
-      this->locator->SetTolerance(this->Tolerance);
-      this->locator->SetNumberOfCellsPerBucket(10);
-      this->locator->CacheCellBoundsOn();
-      this->locator->AutomaticOn();
       this->locator->BuildLocator();
    }
 }
@@ -96,14 +105,13 @@ void vtkImplicitPolyData::SetEvaluateBounds(double eBounds[6])
    this->EvaluateBoundsSet = 1;
 }
 
-unsigned long vtkImplicitPolyData::GetMTime()
+vtkMTimeType vtkImplicitPolyData::GetMTime()
 {
-   unsigned long mTime=this->vtkImplicitFunction::GetMTime();
-   unsigned long inputMTime;
+   vtkMTimeType mTime=this->vtkImplicitFunction::GetMTime();
+   vtkMTimeType inputMTime;
 
    if (this->input != NULL)
    {
-      this->input->Update();
       inputMTime = this->input->GetMTime();
       mTime = (inputMTime > mTime ? inputMTime : mTime);
    }
@@ -113,139 +121,195 @@ unsigned long vtkImplicitPolyData::GetMTime()
 
 vtkImplicitPolyData::~vtkImplicitPolyData()
 {
-   if (this->tri     != NULL) this->tri->Delete();
-   if (this->locator != NULL) this->locator->Delete();
+   if (this->tri      != NULL) this->tri->Delete();
+   if (this->locator  != NULL) this->locator->Delete();
+   if (this->Threader != NULL) this->Threader->Delete();
 }
 
 double vtkImplicitPolyData::EvaluateFunction(double x[3])
 {
-	double n[3];
-	return sharedEvaluate(x, n);	// get distance value returned, normal not used
+   double n[3];
+   return sharedEvaluate(x, n);   // get distance value returned, normal not used
 }
 
 void vtkImplicitPolyData::EvaluateGradient(double x[3], double n[3])
 {
-	sharedEvaluate(x, n);	// get normal, returned distance value not used
+   sharedEvaluate(x, n);   // get normal, returned distance value not used
 }
 
-double vtkImplicitPolyData::sharedEvaluate(double x[3], double n[3])
+VTK_THREAD_RETURN_TYPE vtkImplicitPolyData::ThreadedEvaluate(void *arg)
 {
-   int i;
-	double ret=this->NoValue;
-   for( i=0; i<3; i++ ) n[i] = this->NoGradient[i];
+   int threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
+   int threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
+   vtkImplicitPolyDataThreadInfo *userData = (vtkImplicitPolyDataThreadInfo *)
+      (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
+
+   // contiguous block of points for this thread
+   vtkIdType numPts = userData->Points->GetNumberOfPoints();
+   vtkIdType begin = (numPts * threadId) / threadCount;
+   vtkIdType end   = (numPts * (threadId+1)) / threadCount;
+
+   vtkIdList* idList = vtkIdList::New();
+   for (vtkIdType i = begin; i < end; i++)
+   {
+      double x[3], n[3];
+      userData->Points->GetPoint(i, x);
+      userData->Values->SetComponent(i, 0, userData->Self->SignedDistance(x, n, idList));
+   }
+   idList->Delete();
+
+   return VTK_THREAD_RETURN_VALUE;
+}
 
-	// See if data set with polygons has been specified
-	if (this->input == NULL || input->GetNumberOfCells() == 0)
+void vtkImplicitPolyData::EvaluatePoints(vtkPoints* points, vtkDataArray* values)
+{
+   vtkIdType numPts = points->GetNumberOfPoints();
+   values->SetNumberOfComponents(1);
+   values->SetNumberOfTuples(numPts);
+
+   if (this->input == NULL || input->GetNumberOfCells() == 0)
+   {
+      vtkErrorMacro(<<"No polygons to evaluate function!");
+      for (vtkIdType i = 0; i < numPts; i++) values->SetComponent(i, 0, this->NoValue);
+      return;
+   }
+   if (numPts == 0) return;
+
+   vtkImplicitPolyDataThreadInfo info;
+   info.Self   = this;
+   info.Points = points;
+   info.Values = values;
+
+   int numThreads = this->NumberOfThreads;
+   if (numThreads > numPts) numThreads = static_cast<int>(numPts);
+   this->Threader->SetNumberOfThreads(numThreads);
+   this->Threader->SetSingleMethod(vtkImplicitPolyData::ThreadedEvaluate, &info);
+   this->Threader->SingleMethodExecute();
+}
+
+double vtkImplicitPolyData::sharedEvaluate(double x[3], double n[3])
+{
+   // See if data set with polygons has been specified
+   if (this->input == NULL || input->GetNumberOfCells() == 0)
    {
+      for (int i = 0; i < 3; i++) n[i] = this->NoGradient[i];
       vtkErrorMacro(<<"No polygons to evaluate function!");
-    	return ret;
+      return this->NoValue;
    }
 
-   double p[3];
-   vtkIdType cellId;
-   int subId;
+   vtkIdList* idList = vtkIdList::New();
+   double ret = this->SignedDistance(x, n, idList);
+   idList->Delete();
+
+   return ret;
+}
+
+void vtkImplicitPolyData::ComputeCellNormal(vtkIdType cellId, vtkDataArray* cnorms, double n[3])
+{
+   if (cnorms)
+   {
+      cnorms->GetTuple(cellId, n);
+      return;
+   }
+
+   vtkIdType npts, *pts;
+   double p0[3], p1[3], p2[3];
+   this->input->GetCellPoints(cellId, npts, pts);
+   this->input->GetPoint(pts[0], p0);
+   this->input->GetPoint(pts[1], p1);
+   this->input->GetPoint(pts[2], p2);
+   vtkTriangle::ComputeNormal(p0, p1, p2, n);
+}
+
+double vtkImplicitPolyData::SignedDistance(double x[3], double n[3], vtkIdList* idList)
+{
+   int i;
+   double ret=this->NoValue;
+   for( i=0; i<3; i++ ) n[i] = this->NoGradient[i];
+
+   double p[3], weights[3];
    double vlen2;
 
    vtkDataArray* cnorms = 0;
    if (this->input->GetCellData() && this->input->GetCellData()->GetNormals())
       cnorms = this->input->GetCellData()->GetNormals();
 
-   vtkGenericCell* cell = vtkGenericCell::New();
-   // get point id of closest point in data set
-	this->locator->FindClosestPoint(x, p, cell, cellId, subId, vlen2);
+   // get closest point on the surface, and where on its triangle it lies
+   vtkIdType cellId = this->locator->FindClosestPoint(x, p, weights, vlen2);
 
-	if (cellId != -1)	// point located
+   if (cellId != -1)   // point located
    {
       // dist = | point - x |
       ret = sqrt(vlen2);
       // grad = (point - x) / dist
-      for (int i = 0; i < 3; i++) n[i] = (p[i] - x[i]) / (ret == 0. ? 1. : ret);
+      for (i = 0; i < 3; i++) n[i] = (p[i] - x[i]) / (ret == 0. ? 1. : ret);
 
-      double dist2, weights[3], pcoords[3], awnorm[3] = {0, 0, 0};
-      cell->EvaluatePosition(p, 0, subId, pcoords, dist2, weights);
+      vtkIdType npts, *pts;
+      this->input->GetCellPoints(cellId, npts, pts);
 
-      vtkIdList* idList = vtkIdList::New();
+      double awnorm[3] = {0, 0, 0};
       int count = 0;
-      for (int i = 0; i < 3; i++) count += pcoords[i] == 0;
-      // if pcoords contains no 0s
+      for (i = 0; i < 3; i++) count += weights[i] == 0;
+      // if the weights contain no 0s
       if (count == 0)
       {
          // ... one face ... easy, use face normal
-         if (cnorms)
-         {
-            cnorms->GetTuple(cellId, awnorm);
-         }
-         else
-         {
-            vtkPolygon::ComputeNormal(cell->Points, awnorm);
-         }
+         this->ComputeCellNormal(cellId, cnorms, awnorm);
       }
-      // if pcoords contains 1 0s
+      // if the weights contain 1 0
       else if (count == 1)
       {
-      // ... edge ... get two adjacent faces, compute average normal
-         int a, b;
-         if (pcoords[0] == 0)
+         // ... edge ... get the faces on both sides, compute average normal
+         vtkIdType a, b;
+         if (weights[0] == 0)
          {
-            a = cell->PointIds->GetId(1);
-            b = cell->PointIds->GetId(2);
+            a = pts[1];
+            b = pts[2];
          }
-         else if (pcoords[1] == 0)
+         else if (weights[1] == 0)
          {
-            a = cell->PointIds->GetId(0);
-            b = cell->PointIds->GetId(2);
+            a = pts[0];
+            b = pts[2];
          }
          else
          {
-            a = cell->PointIds->GetId(0);
-            b = cell->PointIds->GetId(1);
+            a = pts[0];
+            b = pts[1];
          }
-         this->input->GetCellEdgeNeighbors(0, a, b, idList);
-         for (int i = 0; i < idList->GetNumberOfIds(); i++)
+         this->input->GetCellEdgeNeighbors(-1, a, b, idList);
+         for (i = 0; i < idList->GetNumberOfIds(); i++)
          {
             double norm[3];
-            if (cnorms)
-            {
-               cnorms->GetTuple(idList->GetId(i), norm);
-            }
-            else
-            {
-               vtkPolygon::ComputeNormal(this->input->GetCell(idList->GetId(i))->GetPoints(), norm);
-            }
+            this->ComputeCellNormal(idList->GetId(i), cnorms, norm);
             awnorm[0] += norm[0];
             awnorm[1] += norm[1];
             awnorm[2] += norm[2];
          }
          vtkMath::Normalize(awnorm);
       }
-      // if pcoords contains 2 0s
-      else if (count == 2)
+      // if the weights contain 2 0s
+      else
       {
-      // ... vertex ... this is the expensive case, get all adjacent faces and compute sum(a_i * n_i)
-      // Angle-Weighted Pseudo Normals, J. Andreas Brentzen and Henrik Aans
-         int a;
-         for (int i = 0; i < 3; i++)
-            if (pcoords[i] == 1)
-               a = cell->PointIds->GetId(i);
+         // ... vertex ... this is the expensive case, get all adjacent faces and compute sum(a_i * n_i)
+         // Angle-Weighted Pseudo Normals, J. Andreas Brentzen and Henrik Aans
+         vtkIdType a = pts[0];
+         for (i = 0; i < 3; i++)
+            if (weights[i] != 0)
+               a = pts[i];
          this->input->GetPointCells(a, idList);
-         for (int i = 0; i < idList->GetNumberOfIds(); i++)
+         for (i = 0; i < idList->GetNumberOfIds(); i++)
          {
             double norm[3];
-            if (cnorms)
-            {
-               cnorms->GetTuple(idList->GetId(i), norm);
-            }
-            else
-            {
-               vtkPolygon::ComputeNormal(this->input->GetCell(idList->GetId(i))->GetPoints(), norm);
-            }
+            this->ComputeCellNormal(idList->GetId(i), cnorms, norm);
+
             // compute angle at point a
-            int b = this->input->GetCell(idList->GetId(i))->GetPointId(0),
-                c = this->input->GetCell(idList->GetId(i))->GetPointId(1);
+            vtkIdType nadj, *adj;
+            this->input->GetCellPoints(idList->GetId(i), nadj, adj);
+            vtkIdType b = adj[0], c = adj[1];
             if (a == b)
-               b = this->input->GetCell(idList->GetId(i))->GetPointId(2);
+               b = adj[2];
             else if (a == c)
-               c = this->input->GetCell(idList->GetId(i))->GetPointId(2);
+               c = adj[2];
 
             double pa[3], pb[3], pc[3];
             this->input->GetPoint(a, pa);
@@ -261,14 +325,12 @@ double vtkImplicitPolyData::sharedEvaluate(double x[3], double n[3])
          }
          vtkMath::Normalize(awnorm);
       }
-      idList->Delete();
 
       // sign(dist) = dot(grad, cell normal)
-      if (ret == 0) for (int i = 0; i < 3; i++) n[i] = awnorm[i];
+      if (ret == 0) for (i = 0; i < 3; i++) n[i] = awnorm[i];
       ret *= (vtkMath::Dot(n, awnorm) < 0.) ? 1. : -1.;
-      if (ret > 0.) for (int i = 0; i < 3; i++) n[i] = -n[i];
+      if (ret > 0.) for (i = 0; i < 3; i++) n[i] = -n[i];
    }
-   cell->Delete();
 
    return ret;
 }
@@ -280,6 +342,7 @@ void vtkImplicitPolyData::PrintSelf(ostream& os, vtkIndent indent)
    os << indent << "No polydata Value: " << this->NoValue << "\n";
    os << indent << "No polydata Gradient: (" << this->NoGradient[0] << ", "
       << this->NoGradient[1] << ", " << this->NoGradient[2] << ")\n";
+   os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
 
    if (this->input)
    {
@@ -290,4 +353,3 @@ void vtkImplicitPolyData::PrintSelf(ostream& os, vtkIndent indent)
       os << indent << "Input : (none)\n";
    }
 }
-
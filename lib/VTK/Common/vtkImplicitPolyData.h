@@ -20,23 +20,22 @@ MODIFICATIONS.
 #ifndef __vtkImplicitPolyData_h
 #define __vtkImplicitPolyData_h
 
-#include <math.h>
-#include "vtkDataSetToImageFilter.h"
 #include "vtkPolyData.h"
 #include "vtkImplicitFunction.h"
 #include "vtkTriangleFilter.h"
 #include "vtkIdList.h"
+#include "vtkMultiThreader.h"
 
-#include "vtkCellLocator.h"
-#include "vtkOBBTree.h"
+class vtkDataArray;
+class vtkPoints;
+class vtkTriangleBVH;
 
 
 class vtkImplicitPolyData : public vtkImplicitFunction
 {
 public:
-  vtkTypeRevisionMacro(vtkImplicitPolyData,vtkImplicitFunction);
+  vtkTypeMacro(vtkImplicitPolyData,vtkImplicitFunction);
   static vtkImplicitPolyData *New();
-  const char *GetClassName() {return "vtkImplicitPolyData";};
   void PrintSelf(ostream& os, vtkIndent indent);
 
   vtkImplicitPolyData();
@@ -44,18 +43,24 @@ public:
 
   // Description:
   // Return the MTime also considering the Input dependency.
-  unsigned long GetMTime();
+  vtkMTimeType GetMTime();
 
   void SetEvaluateBounds( double eBounds[6] );
 
   // Description:
   // Evaluate plane equation of nearest triangle to point x[3].
+  using vtkImplicitFunction::EvaluateFunction;
   double EvaluateFunction(double x[3]);
 
   // Description:
   // Evaluate function gradient of nearest triangle to point x[3].
   void EvaluateGradient(double x[3], double g[3]);
 
+  // Description:
+  // Evaluate the function at each of the points into values, splitting
+  // the points among threads.
+  void EvaluatePoints(vtkPoints *points, vtkDataArray *values);
+
   //BTX
   inline double Evaluate(double x[3], double g[3]) { return sharedEvaluate(x, g); }
   //ETX
@@ -90,7 +95,10 @@ protected:
 
   vtkTriangleFilter *tri;
   vtkPolyData *input;
-  vtkCellLocator *locator;
+  vtkTriangleBVH *locator;
+
+  vtkMultiThreader *Threader;
+  int NumberOfThreads;
 
   double EvaluateBounds[6];
   int EvaluateBoundsSet;
@@ -99,6 +107,18 @@ protected:
 
   double sharedEvaluate( double x[3], double n[3] );
 
+  // Description:
+  // Signed distance and gradient at x. Only reads the input and the
+  // locator, so threads may call it at once, each with its own idList.
+  double SignedDistance( double x[3], double n[3], vtkIdList *idList );
+
+  // Description:
+  // Normal of a triangle of the input, from its cell normals if it has
+  // them.
+  void ComputeCellNormal( vtkIdType cellId, vtkDataArray *cnorms, double n[3] );
+
+  static VTK_THREAD_RETURN_TYPE ThreadedEvaluate( void *arg );
+
 private:
   vtkImplicitPolyData(const vtkImplicitPolyData&);  // Not implemented.
   void operator=(const vtkImplicitPolyData&);  // Not implemented.
@@ -0,0 +1,618 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTriangleBVH.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTriangleBVH.h"
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+
+#include <algorithm>
+
+vtkStandardNewMacro(vtkTriangleBVH);
+
+// The tree is never deeper than this, so queries can keep the nodes
+// left to visit on a fixed stack.
+#define VTK_TRIANGLE_BVH_MAX_DEPTH 64
+
+// Number of bins the centroids are sorted into to choose a split.
+#define VTK_TRIANGLE_BVH_NUMBER_OF_BINS 16
+
+//----------------------------------------------------------------------------
+// Orders triangles by the coordinate of their centroid along one axis.
+struct vtkTriangleBVHCentroidLess
+{
+  const double *Centroids;
+  int           Axis;
+
+  bool operator()(vtkIdType a, vtkIdType b) const
+  {
+    return this->Centroids[3*a + this->Axis] < this->Centroids[3*b + this->Axis];
+  }
+};
+
+//----------------------------------------------------------------------------
+// Bin of the centroid of a triangle along one axis.
+struct vtkTriangleBVHBinOf
+{
+  const double *Centroids;
+  int           Axis;
+  double        Minimum;
+  double        Scale;
+
+  int operator()(vtkIdType t) const
+  {
+    int b = static_cast<int>((this->Centroids[3*t + this->Axis] - this->Minimum) *
+                             this->Scale);
+    return (b < VTK_TRIANGLE_BVH_NUMBER_OF_BINS - 1 ?
+            b : VTK_TRIANGLE_BVH_NUMBER_OF_BINS - 1);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Whether the centroid of a triangle lies at or before a bin.
+struct vtkTriangleBVHBinAtOrBefore
+{
+  vtkTriangleBVHBinOf BinOf;
+  int                 Split;
+
+  bool operator()(vtkIdType t) const
+  {
+    return this->BinOf(t) <= this->Split;
+  }
+};
+
+//----------------------------------------------------------------------------
+static inline void vtkTriangleBVHEmptyBounds(double bounds[6])
+{
+  bounds[0] = bounds[2] = bounds[4] =  VTK_DOUBLE_MAX;
+  bounds[1] = bounds[3] = bounds[5] = -VTK_DOUBLE_MAX;
+}
+
+//----------------------------------------------------------------------------
+static inline void vtkTriangleBVHAddBounds(double bounds[6],
+                                           const double other[6])
+{
+  for (int i = 0; i < 3; i++)
+    {
+    bounds[2*i]   = std::min(bounds[2*i],   other[2*i]);
+    bounds[2*i+1] = std::max(bounds[2*i+1], other[2*i+1]);
+    }
+}
+
+//----------------------------------------------------------------------------
+static inline void vtkTriangleBVHAddTriangle(double bounds[6],
+                                             const double *v)
+{
+  for (int i = 0; i < 3; i++)
+    {
+    for (int j = 0; j < 3; j++)
+      {
+      bounds[2*i]   = std::min(bounds[2*i],   v[3*j + i]);
+      bounds[2*i+1] = std::max(bounds[2*i+1], v[3*j + i]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Half the surface area of the box, or zero if it is empty.
+static inline double vtkTriangleBVHHalfArea(const double bounds[6])
+{
+  if (bounds[0] > bounds[1])
+    {
+    return 0.0;
+    }
+  double dx = bounds[1] - bounds[0];
+  double dy = bounds[3] - bounds[2];
+  double dz = bounds[5] - bounds[4];
+  return dx*dy + dy*dz + dz*dx;
+}
+
+//----------------------------------------------------------------------------
+static inline bool vtkTriangleBVHOverlap(const double a[6], const double b[6])
+{
+  return a[0] <= b[1] && b[0] <= a[1] &&
+         a[2] <= b[3] && b[2] <= a[3] &&
+         a[4] <= b[5] && b[4] <= a[5];
+}
+
+//----------------------------------------------------------------------------
+// Squared distance from x to the box.
+static inline double vtkTriangleBVHBoxDistance2(const double bounds[6],
+                                                const double x[3])
+{
+  double dist2 = 0.0;
+  for (int i = 0; i < 3; i++)
+    {
+    double d = 0.0;
+    if (x[i] < bounds[2*i])
+      {
+      d = bounds[2*i] - x[i];
+      }
+    else if (x[i] > bounds[2*i+1])
+      {
+      d = x[i] - bounds[2*i+1];
+      }
+    dist2 += d*d;
+    }
+  return dist2;
+}
+
+//----------------------------------------------------------------------------
+// Closest point to p on the triangle with vertices v, and its barycentric
+// weights, by the Voronoi regions of the triangle's vertices and edges.
+// Weights outside the closest feature are exactly zero.
+static void vtkTriangleBVHClosestPoint(const double p[3], const double *v,
+                                       double closest[3], double w[3])
+{
+  const double *a = v, *b = v + 3, *c = v + 6;
+  double ab[3], ac[3], ap[3], bp[3], cp[3];
+  for (int i = 0; i < 3; i++)
+    {
+    ab[i] = b[i] - a[i];
+    ac[i] = c[i] - a[i];
+    ap[i] = p[i] - a[i];
+    bp[i] = p[i] - b[i];
+    cp[i] = p[i] - c[i];
+    }
+
+  double d1 = ab[0]*ap[0] + ab[1]*ap[1] + ab[2]*ap[2];
+  double d2 = ac[0]*ap[0] + ac[1]*ap[1] + ac[2]*ap[2];
+  double d3 = ab[0]*bp[0] + ab[1]*bp[1] + ab[2]*bp[2];
+  double d4 = ac[0]*bp[0] + ac[1]*bp[1] + ac[2]*bp[2];
+  double d5 = ab[0]*cp[0] + ab[1]*cp[1] + ab[2]*cp[2];
+  double d6 = ac[0]*cp[0] + ac[1]*cp[1] + ac[2]*cp[2];
+
+  double va = d3*d6 - d5*d4;
+  double vb = d5*d2 - d1*d6;
+  double vc = d1*d4 - d3*d2;
+
+  if (d1 <= 0.0 && d2 <= 0.0)
+    {
+    w[0] = 1.0; w[1] = 0.0; w[2] = 0.0;
+    }
+  else if (d3 >= 0.0 && d4 <= d3)
+    {
+    w[0] = 0.0; w[1] = 1.0; w[2] = 0.0;
+    }
+  else if (d6 >= 0.0 && d5 <= d6)
+    {
+    w[0] = 0.0; w[1] = 0.0; w[2] = 1.0;
+    }
+  else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+    {
+    double t = d1 / (d1 - d3);
+    w[0] = 1.0 - t; w[1] = t; w[2] = 0.0;
+    }
+  else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+    {
+    double t = d2 / (d2 - d6);
+    w[0] = 1.0 - t; w[1] = 0.0; w[2] = t;
+    }
+  else if (va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0)
+    {
+    double t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+    w[0] = 0.0; w[1] = 1.0 - t; w[2] = t;
+    }
+  else if (va + vb + vc > 0.0)
+    {
+    double denom = 1.0 / (va + vb + vc);
+    w[1] = vb * denom;
+    w[2] = vc * denom;
+    w[0] = 1.0 - w[1] - w[2];
+    }
+  else
+    {
+    // Degenerate triangle that none of the regions above claimed.
+    w[0] = 1.0; w[1] = 0.0; w[2] = 0.0;
+    }
+
+  for (int i = 0; i < 3; i++)
+    {
+    closest[i] = w[0]*a[i] + w[1]*b[i] + w[2]*c[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkTriangleBVH::vtkTriangleBVH()
+{
+  this->DataSet = NULL;
+  this->NumberOfCellsPerNode = 4;
+}
+
+//----------------------------------------------------------------------------
+vtkTriangleBVH::~vtkTriangleBVH()
+{
+  this->SetDataSet(NULL);
+}
+
+//----------------------------------------------------------------------------
+vtkCxxSetObjectMacro(vtkTriangleBVH, DataSet, vtkPolyData);
+
+//----------------------------------------------------------------------------
+void vtkTriangleBVH::BuildLocator()
+{
+  if (!this->DataSet)
+    {
+    vtkErrorMacro(<< "No data set to build the tree from");
+    return;
+    }
+
+  if (this->BuildTime > this->GetMTime() &&
+      this->BuildTime > this->DataSet->GetMTime())
+    {
+    return;
+    }
+
+  this->Nodes.clear();
+  this->CellIds.clear();
+  this->Vertices.clear();
+
+  // Gather the triangles with their bounds and centroids.
+  vtkPolyData *input = this->DataSet;
+  vtkIdType numCells = input->GetNumberOfCells();
+  std::vector<vtkIdType> cellIds;
+  std::vector<double>    vertices;
+  std::vector<double>    centroids;
+  cellIds.reserve(numCells);
+  vertices.reserve(9*numCells);
+  centroids.reserve(3*numCells);
+
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    if (input->GetCellType(cellId) != VTK_TRIANGLE)
+      {
+      continue;
+      }
+    vtkIdType npts, *pts;
+    input->GetCellPoints(cellId, npts, pts);
+
+    double centroid[3] = {0.0, 0.0, 0.0};
+    for (int j = 0; j < 3; j++)
+      {
+      double x[3];
+      input->GetPoint(pts[j], x);
+      for (int i = 0; i < 3; i++)
+        {
+        vertices.push_back(x[i]);
+        centroid[i] += x[i] / 3.0;
+        }
+      }
+    centroids.push_back(centroid[0]);
+    centroids.push_back(centroid[1]);
+    centroids.push_back(centroid[2]);
+    cellIds.push_back(cellId);
+    }
+
+  vtkIdType numTriangles = static_cast<vtkIdType>(cellIds.size());
+  std::vector<vtkIdType> order(numTriangles);
+  for (vtkIdType t = 0; t < numTriangles; t++)
+    {
+    order[t] = t;
+    }
+
+  // Split the nodes depth first. Each entry on the stack is a node to
+  // split and its depth.
+  if (numTriangles > 0)
+    {
+    Node root;
+    root.First = 0;
+    root.Count = numTriangles;
+    this->Nodes.push_back(root);
+    }
+
+  std::vector<std::pair<vtkIdType, int> > stack;
+  if (numTriangles > 0)
+    {
+    stack.push_back(std::make_pair(static_cast<vtkIdType>(0), 0));
+    }
+
+  while (!stack.empty())
+    {
+    vtkIdType nodeId = stack.back().first;
+    int       depth  = stack.back().second;
+    stack.pop_back();
+
+    vtkIdType first = this->Nodes[nodeId].First;
+    vtkIdType count = this->Nodes[nodeId].Count;
+
+    double bounds[6], centroidBounds[6];
+    vtkTriangleBVHEmptyBounds(bounds);
+    vtkTriangleBVHEmptyBounds(centroidBounds);
+    for (vtkIdType t = first; t < first + count; t++)
+      {
+      const double *c = &centroids[3*order[t]];
+      vtkTriangleBVHAddTriangle(bounds, &vertices[9*order[t]]);
+      for (int i = 0; i < 3; i++)
+        {
+        centroidBounds[2*i]   = std::min(centroidBounds[2*i],   c[i]);
+        centroidBounds[2*i+1] = std::max(centroidBounds[2*i+1], c[i]);
+        }
+      }
+    std::copy(bounds, bounds + 6, this->Nodes[nodeId].Bounds);
+
+    int axis = 0;
+    for (int i = 1; i < 3; i++)
+      {
+      if (centroidBounds[2*i+1] - centroidBounds[2*i] >
+          centroidBounds[2*axis+1] - centroidBounds[2*axis])
+        {
+        axis = i;
+        }
+      }
+
+    // Leave the node a leaf if it is small enough, too deep, or its
+    // triangles all have the same centroid.
+    if (count <= this->NumberOfCellsPerNode ||
+        depth >= VTK_TRIANGLE_BVH_MAX_DEPTH - 1 ||
+        centroidBounds[2*axis+1] <= centroidBounds[2*axis])
+      {
+      continue;
+      }
+
+    // Bin the centroids along the axis and split between the bins where
+    // the surface area heuristic, the areas of the children weighted by
+    // their number of triangles, is lowest.
+    vtkIdType binCounts[VTK_TRIANGLE_BVH_NUMBER_OF_BINS];
+    double    binBounds[VTK_TRIANGLE_BVH_NUMBER_OF_BINS][6];
+    for (int b = 0; b < VTK_TRIANGLE_BVH_NUMBER_OF_BINS; b++)
+      {
+      binCounts[b] = 0;
+      vtkTriangleBVHEmptyBounds(binBounds[b]);
+      }
+
+    vtkTriangleBVHBinOf binOf;
+    binOf.Centroids = &centroids[0];
+    binOf.Axis = axis;
+    binOf.Minimum = centroidBounds[2*axis];
+    binOf.Scale = VTK_TRIANGLE_BVH_NUMBER_OF_BINS /
+      (centroidBounds[2*axis+1] - centroidBounds[2*axis]);
+    for (vtkIdType t = first; t < first + count; t++)
+      {
+      int b = binOf(order[t]);
+      binCounts[b]++;
+      vtkTriangleBVHAddTriangle(binBounds[b], &vertices[9*order[t]]);
+      }
+
+    double    rightArea[VTK_TRIANGLE_BVH_NUMBER_OF_BINS];
+    vtkIdType rightCount[VTK_TRIANGLE_BVH_NUMBER_OF_BINS];
+    double    accumulated[6];
+    vtkIdType accumulatedCount = 0;
+    vtkTriangleBVHEmptyBounds(accumulated);
+    for (int b = VTK_TRIANGLE_BVH_NUMBER_OF_BINS - 1; b > 0; b--)
+      {
+      vtkTriangleBVHAddBounds(accumulated, binBounds[b]);
+      accumulatedCount += binCounts[b];
+      rightArea[b]  = vtkTriangleBVHHalfArea(accumulated);
+      rightCount[b] = accumulatedCount;
+      }
+
+    int    bestBin  = -1;
+    double bestCost = VTK_DOUBLE_MAX;
+    vtkTriangleBVHEmptyBounds(accumulated);
+    accumulatedCount = 0;
+    for (int b = 0; b < VTK_TRIANGLE_BVH_NUMBER_OF_BINS - 1; b++)
+      {
+      vtkTriangleBVHAddBounds(accumulated, binBounds[b]);
+      accumulatedCount += binCounts[b];
+      if (accumulatedCount == 0 || rightCount[b+1] == 0)
+        {
+        continue;
+        }
+      double cost = vtkTriangleBVHHalfArea(accumulated)*accumulatedCount +
+        rightArea[b+1]*rightCount[b+1];
+      if (cost < bestCost)
+        {
+        bestCost = cost;
+        bestBin  = b;
+        }
+      }
+
+    vtkIdType half;
+    if (bestBin >= 0)
+      {
+      vtkTriangleBVHBinAtOrBefore atOrBefore;
+      atOrBefore.BinOf = binOf;
+      atOrBefore.Split = bestBin;
+      half = std::partition(order.begin() + first, order.begin() + first + count,
+                            atOrBefore) - (order.begin() + first);
+      }
+    else
+      {
+      // The bins could not separate the centroids; split at the median.
+      half = count / 2;
+      vtkTriangleBVHCentroidLess less;
+      less.Centroids = &centroids[0];
+      less.Axis = axis;
+      std::nth_element(order.begin() + first, order.begin() + first + half,
+                       order.begin() + first + count, less);
+      }
+
+    Node left, right;
+    left.First  = first;
+    left.Count  = half;
+    right.First = first + half;
+    right.Count = count - half;
+
+    vtkIdType leftId = static_cast<vtkIdType>(this->Nodes.size());
+    this->Nodes[nodeId].First = leftId;
+    this->Nodes[nodeId].Count = 0;
+    this->Nodes.push_back(left);
+    this->Nodes.push_back(right);
+
+    stack.push_back(std::make_pair(leftId + 1, depth + 1));
+    stack.push_back(std::make_pair(leftId, depth + 1));
+    }
+
+  // Store the triangles in leaf order so each leaf reads a contiguous run.
+  this->CellIds.resize(numTriangles);
+  this->Vertices.resize(9*numTriangles);
+  for (vtkIdType t = 0; t < numTriangles; t++)
+    {
+    this->CellIds[t] = cellIds[order[t]];
+    std::copy(&vertices[9*order[t]], &vertices[9*order[t]] + 9,
+              &this->Vertices[9*t]);
+    }
+
+  this->BuildTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkTriangleBVH::FindClosestPoint(const double x[3],
+                                           double closest[3],
+                                           double weights[3],
+                                           double& dist2)
+{
+  vtkIdType closestCell = -1;
+  dist2 = VTK_DOUBLE_MAX;
+  if (this->Nodes.empty())
+    {
+    return closestCell;
+    }
+
+  vtkIdType stack[VTK_TRIANGLE_BVH_MAX_DEPTH + 1];
+  int top = 0;
+  stack[top++] = 0;
+
+  while (top > 0)
+    {
+    const Node& node = this->Nodes[stack[--top]];
+    if (vtkTriangleBVHBoxDistance2(node.Bounds, x) >= dist2)
+      {
+      continue;
+      }
+
+    if (node.Count > 0)
+      {
+      for (vtkIdType t = node.First; t < node.First + node.Count; t++)
+        {
+        double p[3], w[3];
+        vtkTriangleBVHClosestPoint(x, &this->Vertices[9*t], p, w);
+        double d2 = (p[0]-x[0])*(p[0]-x[0]) + (p[1]-x[1])*(p[1]-x[1]) +
+          (p[2]-x[2])*(p[2]-x[2]);
+        if (d2 < dist2)
+          {
+          dist2 = d2;
+          closestCell = this->CellIds[t];
+          for (int i = 0; i < 3; i++)
+            {
+            closest[i] = p[i];
+            weights[i] = w[i];
+            }
+          }
+        }
+      continue;
+      }
+
+    // Visit the nearer child first by pushing it last.
+    vtkIdType nearChild = node.First, farChild = node.First + 1;
+    double nearDist2 = vtkTriangleBVHBoxDistance2(this->Nodes[nearChild].Bounds, x);
+    double farDist2  = vtkTriangleBVHBoxDistance2(this->Nodes[farChild].Bounds, x);
+    if (farDist2 < nearDist2)
+      {
+      std::swap(nearChild, farChild);
+      std::swap(nearDist2, farDist2);
+      }
+    if (farDist2 < dist2)
+      {
+      stack[top++] = farChild;
+      }
+    if (nearDist2 < dist2)
+      {
+      stack[top++] = nearChild;
+      }
+    }
+
+  return closestCell;
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleBVH::FindOverlappingTriangles(
+  vtkTriangleBVH *other, std::vector<std::pair<vtkIdType, vtkIdType> >& pairs)
+{
+  pairs.clear();
+  if (this->Nodes.empty() || other->Nodes.empty())
+    {
+    return;
+    }
+
+  std::vector<std::pair<vtkIdType, vtkIdType> > stack;
+  stack.push_back(std::make_pair(static_cast<vtkIdType>(0),
+                                 static_cast<vtkIdType>(0)));
+
+  while (!stack.empty())
+    {
+    vtkIdType a = stack.back().first;
+    vtkIdType b = stack.back().second;
+    stack.pop_back();
+
+    const Node& nodeA = this->Nodes[a];
+    const Node& nodeB = other->Nodes[b];
+    if (!vtkTriangleBVHOverlap(nodeA.Bounds, nodeB.Bounds))
+      {
+      continue;
+      }
+
+    if (nodeA.Count > 0 && nodeB.Count > 0)
+      {
+      for (vtkIdType ta = nodeA.First; ta < nodeA.First + nodeA.Count; ta++)
+        {
+        double boundsA[6];
+        vtkTriangleBVHEmptyBounds(boundsA);
+        vtkTriangleBVHAddTriangle(boundsA, &this->Vertices[9*ta]);
+        if (!vtkTriangleBVHOverlap(boundsA, nodeB.Bounds))
+          {
+          continue;
+          }
+        for (vtkIdType tb = nodeB.First; tb < nodeB.First + nodeB.Count; tb++)
+          {
+          double boundsB[6];
+          vtkTriangleBVHEmptyBounds(boundsB);
+          vtkTriangleBVHAddTriangle(boundsB, &other->Vertices[9*tb]);
+          if (vtkTriangleBVHOverlap(boundsA, boundsB))
+            {
+            pairs.push_back(std::make_pair(this->CellIds[ta],
+                                           other->CellIds[tb]));
+            }
+          }
+        }
+      }
+    // Descend the larger of the two nodes, or the one that is not a leaf.
+    else if (nodeB.Count > 0 ||
+             (nodeA.Count == 0 &&
+              vtkTriangleBVHHalfArea(nodeA.Bounds) >=
+              vtkTriangleBVHHalfArea(nodeB.Bounds)))
+      {
+      stack.push_back(std::make_pair(nodeA.First + 1, b));
+      stack.push_back(std::make_pair(nodeA.First, b));
+      }
+    else
+      {
+      stack.push_back(std::make_pair(a, nodeB.First + 1));
+      stack.push_back(std::make_pair(a, nodeB.First));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkTriangleBVH::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "DataSet: " << this->DataSet << "\n";
+  os << indent << "NumberOfCellsPerNode: " << this->NumberOfCellsPerNode << "\n";
+  os << indent << "Number Of Triangles: " << this->CellIds.size() << "\n";
+  os << indent << "Number Of Nodes: " << this->Nodes.size() << "\n";
+}
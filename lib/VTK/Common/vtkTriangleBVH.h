@@ -0,0 +1,125 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTriangleBVH.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkTriangleBVH - bounding volume hierarchy over the triangles of
+// a polygonal data set
+// .SECTION Description
+// vtkTriangleBVH stores the triangles of a vtkPolyData in a binary tree
+// of axis-aligned bounding boxes. Each node is split along the longest
+// axis of its triangles' centroids, at the plane that minimizes the
+// surface area heuristic, until at most NumberOfCellsPerNode remain.
+//
+// FindClosestPoint visits the nodes nearest first and skips those whose
+// box is farther than the closest triangle found so far, so each query
+// touches only a few leaves. The tree is only read by queries, so once
+// BuildLocator has been called they may be made from several threads at
+// once.
+//
+// Cells other than triangles are ignored; pass the data set through
+// vtkTriangleFilter first if it has other polygons.
+// .SECTION see also
+// vtkCellLocator vtkOBBTree vtkImplicitPolyData
+
+#ifndef __vtkTriangleBVH_h
+#define __vtkTriangleBVH_h
+
+#include "vtkObject.h"
+
+#include <utility>
+#include <vector>
+
+class vtkPolyData;
+
+class vtkTriangleBVH : public vtkObject
+{
+public:
+  static vtkTriangleBVH *New();
+  vtkTypeMacro(vtkTriangleBVH,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set the data set whose triangles are stored.
+  virtual void SetDataSet(vtkPolyData *dataSet);
+  vtkGetObjectMacro(DataSet, vtkPolyData);
+
+  // Description:
+  // Largest number of triangles in a leaf of the tree. Default is 4.
+  vtkSetClampMacro(NumberOfCellsPerNode, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfCellsPerNode, int);
+
+  // Description:
+  // Build the tree if the data set or the settings changed since it was
+  // last built.
+  void BuildLocator();
+
+  // Description:
+  // Find the point on the triangles closest to x. Returns the id of the
+  // cell it lies on, or -1 if there are no triangles. The weights are the
+  // barycentric coordinates of the closest point with respect to the
+  // points of the cell, and are exactly zero for the points that are not
+  // on the closest vertex or edge.
+  vtkIdType FindClosestPoint(const double x[3], double closest[3],
+                             double weights[3], double& dist2);
+
+  // Description:
+  // Find the pairs of triangles, one from this tree and one from the
+  // other, whose bounding boxes overlap, by descending both trees at
+  // once. The pairs are cell ids of this tree's and the other tree's
+  // data sets.
+  //BTX
+  void FindOverlappingTriangles(
+    vtkTriangleBVH *other,
+    std::vector<std::pair<vtkIdType, vtkIdType> >& pairs);
+  //ETX
+
+  // Description:
+  // Number of triangles in the tree.
+  vtkIdType GetNumberOfTriangles()
+    {return static_cast<vtkIdType>(this->CellIds.size());};
+
+protected:
+  vtkTriangleBVH();
+  ~vtkTriangleBVH();
+
+  //BTX
+  // A node is a leaf if Count is positive, in which case its triangles
+  // start at First. Otherwise its children are the nodes First and
+  // First+1.
+  struct Node
+  {
+    double    Bounds[6];
+    vtkIdType First;
+    vtkIdType Count;
+  };
+  //ETX
+
+  vtkPolyData *DataSet;
+  int          NumberOfCellsPerNode;
+  vtkTimeStamp BuildTime;
+
+  // Description:
+  // Nodes of the tree, with the root first, and the cell ids and the
+  // x, y, z of the three points of each triangle in leaf order.
+  //BTX
+  std::vector<Node>      Nodes;
+  //ETX
+  std::vector<vtkIdType> CellIds;
+  std::vector<double>    Vertices;
+
+private:
+  vtkTriangleBVH(const vtkTriangleBVH&);  // Not implemented.
+  void operator=(const vtkTriangleBVH&);  // Not implemented.
+};
+
+#endif
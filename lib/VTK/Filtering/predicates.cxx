@@ -374,6 +374,10 @@ static REAL ccwerrboundA, ccwerrboundB, ccwerrboundC;
 static REAL o3derrboundA, o3derrboundB, o3derrboundC;
 static REAL iccerrboundA, iccerrboundB, iccerrboundC;
 static REAL isperrboundA, isperrboundB, isperrboundC;
+/* Nonzero once the variables above have been set.  They are only written */
+/*   the first time exactinit() is called, so that later calls may run    */
+/*   while other threads use them.                                         */
+static int exactinitialized = 0;
 
 /*****************************************************************************/
 /*                                                                           */
@@ -658,12 +662,17 @@ float uniformfloatrand()
 /*                                                                           */
 /*  Don't change this routine unless you fully understand it.                */
 /*                                                                           */
+/*  The variables are computed into locals and only published by the first  */
+/*  call, so that callers running TetGen on several threads can call this   */
+/*  once before starting them and let later calls leave the values alone.   */
+/*                                                                           */
 /*****************************************************************************/
 
 REAL exactinit()
 {
   REAL half;
   REAL check, lastcheck;
+  REAL eps, split;
   int every_other;
 #ifdef LINUX
   int cword;
@@ -687,10 +696,14 @@ REAL exactinit()
   _FPU_SETCW(cword);
 #endif /* LINUX */
 
+  if (exactinitialized) {
+    return epsilon;
+  }
+
   every_other = 1;
   half = 0.5;
-  epsilon = 1.0;
-  splitter = 1.0;
+  eps = 1.0;
+  split = 1.0;
   check = 1.0;
   /* Repeatedly divide `epsilon' by two until it is too small to add to    */
   /*   one without causing roundoff.  (Also check if the sum is equal to   */
@@ -698,14 +711,17 @@ REAL exactinit()
   /*   rounding.  Not that this library will work on such machines anyway. */
   do {
     lastcheck = check;
-    epsilon *= half;
+    eps *= half;
     if (every_other) {
-      splitter *= 2.0;
+      split *= 2.0;
     }
     every_other = !every_other;
-    check = 1.0 + epsilon;
+    check = 1.0 + eps;
   } while ((check != 1.0) && (check != lastcheck));
-  splitter += 1.0;
+  split += 1.0;
+
+  epsilon = eps;
+  splitter = split;
 
   /* Error bounds for orientation and incircle tests. */
   resulterrbound = (3.0 + 8.0 * epsilon) * epsilon;
@@ -722,6 +738,8 @@ REAL exactinit()
   isperrboundB = (5.0 + 72.0 * epsilon) * epsilon;
   isperrboundC = (71.0 + 1408.0 * epsilon) * epsilon * epsilon;
 
+  exactinitialized = 1;
+
   return epsilon; /* Added by H. Si 30 Juli, 2004. */
 }
 
@@ -0,0 +1,341 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkAnalyticUniformPointSampler.cxx,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAnalyticUniformPointSampler.h"
+
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+
+#include <cmath>
+
+vtkStandardNewMacro(vtkAnalyticUniformPointSampler);
+
+// Rejection sampling gives up and accepts the last candidate after this
+// many blocks of random words. The acceptance probability is at least
+// one half for all but very eccentric shapes, so this is never reached
+// in practice.
+static const vtkTypeUInt32 MAX_REJECTION_BLOCKS = 64;
+
+// Number of quadrature intervals per direction used to integrate the
+// surface area of an ellipsoid.
+static const int ELLIPSOID_AREA_INTERVALS = 256;
+
+//----------------------------------------------------------------------------
+vtkAnalyticUniformPointSampler::vtkAnalyticUniformPointSampler()
+{
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+  this->Shape = ELLIPSOID;
+  this->SampleVolume = 0;
+  this->Radii[0] = this->Radii[1] = this->Radii[2] = 1.0;
+  this->Radius = 1.0;
+  this->InnerRadius = 0.5;
+  this->OuterRadius = 1.0;
+  this->Height = 1.0;
+  this->RingRadius = 1.0;
+  this->CrossSectionRadius = 0.25;
+  this->Volume = 0.0;
+}
+
+//----------------------------------------------------------------------------
+vtkAnalyticUniformPointSampler::~vtkAnalyticUniformPointSampler()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkAnalyticUniformPointSampler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Shape: " << this->Shape << "\n";
+  os << indent << "SampleVolume: " << this->SampleVolume << "\n";
+  os << indent << "Radii: (" << this->Radii[0] << ", " << this->Radii[1]
+     << ", " << this->Radii[2] << ")\n";
+  os << indent << "Radius: " << this->Radius << "\n";
+  os << indent << "InnerRadius: " << this->InnerRadius << "\n";
+  os << indent << "OuterRadius: " << this->OuterRadius << "\n";
+  os << indent << "Height: " << this->Height << "\n";
+  os << indent << "RingRadius: " << this->RingRadius << "\n";
+  os << indent << "CrossSectionRadius: " << this->CrossSectionRadius << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkAnalyticUniformPointSampler::RequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector),
+  vtkInformationVector* outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  output->Initialize();
+
+  // Changing the number of samples keeps the existing samples, but any
+  // change to the shape moves all of them.
+  std::vector<double> parameters;
+  this->GetShapeParameters(parameters);
+  if (parameters != this->SampledParameters) {
+    this->InvalidateSampleCache();
+    this->SampledParameters = parameters;
+    this->DistributionHash = vtkCacheFileUtilities::
+      HashBytes(&parameters[0], parameters.size()*sizeof(double));
+  }
+
+  this->SurfaceArea = this->ComputeSurfaceArea();
+  this->Volume = this->ComputeVolume();
+
+  double measure = this->SampleVolume ? this->Volume : this->SurfaceArea;
+  int numPoints = this->NumberOfSamples;
+  if (!this->UseFixedNumberOfSamples)
+    numPoints = this->ComputeNumberOfSamples(measure, this->Density);
+  if (measure <= 0.0)
+    numPoints = 0;
+
+  this->GenerateSamplePoints(numPoints, output);
+
+  this->ComputedTime = this->GetMTime();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkAnalyticUniformPointSampler::GetShapeParameters(std::vector<double>& parameters) {
+  parameters.clear();
+  parameters.push_back(this->Shape);
+  parameters.push_back(this->SampleVolume);
+  parameters.insert(parameters.end(), this->Radii, this->Radii + 3);
+  parameters.push_back(this->Radius);
+  parameters.push_back(this->InnerRadius);
+  parameters.push_back(this->OuterRadius);
+  parameters.push_back(this->Height);
+  parameters.push_back(this->RingRadius);
+  parameters.push_back(this->CrossSectionRadius);
+}
+
+//----------------------------------------------------------------------------
+double vtkAnalyticUniformPointSampler::ComputeSurfaceArea() {
+  double pi = vtkMath::Pi();
+
+  switch (this->Shape) {
+  case ELLIPSOID: {
+    // Mapping the unit sphere to the ellipsoid scales area by
+    // abc*g(u), where g(u) = |diag(1/a, 1/b, 1/c) u|. Integrate g over
+    // the sphere with the midpoint rule in z and azimuth, which is
+    // uniform in area on the sphere.
+    double a = this->Radii[0], b = this->Radii[1], c = this->Radii[2];
+    if (a <= 0.0 || b <= 0.0 || c <= 0.0)
+      return 0.0;
+    if (a == b && b == c)
+      return 4.0*pi*a*a;
+
+    int n = ELLIPSOID_AREA_INTERVALS;
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+      double z = -1.0 + (2.0*i + 1.0) / n;
+      double rho = sqrt(1.0 - z*z);
+      for (int j = 0; j < n; j++) {
+        double phi = 2.0*pi*(j + 0.5) / n;
+        double x = rho*cos(phi), y = rho*sin(phi);
+        sum += sqrt(x*x/(a*a) + y*y/(b*b) + z*z/(c*c));
+      }
+    }
+    return a*b*c * sum * (2.0 / n) * (2.0*pi / n);
+  }
+
+  case CYLINDER: {
+    double r = this->Radius;
+    return 2.0*pi*r*this->Height + 2.0*pi*r*r;
+  }
+
+  case HOLLOW_CYLINDER: {
+    double ri = this->InnerRadius, ro = this->OuterRadius;
+    if (ro <= ri)
+      return 0.0;
+    return 2.0*pi*(ro + ri)*this->Height + 2.0*pi*(ro*ro - ri*ri);
+  }
+
+  case DISK:
+    return pi*this->Radius*this->Radius;
+
+  case TORUS:
+    return 4.0*pi*pi*this->RingRadius*this->CrossSectionRadius;
+  }
+
+  return 0.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkAnalyticUniformPointSampler::ComputeVolume() {
+  double pi = vtkMath::Pi();
+
+  switch (this->Shape) {
+  case ELLIPSOID:
+    return (4.0/3.0)*pi*this->Radii[0]*this->Radii[1]*this->Radii[2];
+
+  case CYLINDER:
+    return pi*this->Radius*this->Radius*this->Height;
+
+  case HOLLOW_CYLINDER: {
+    double ri = this->InnerRadius, ro = this->OuterRadius;
+    if (ro <= ri)
+      return 0.0;
+    return pi*(ro*ro - ri*ri)*this->Height;
+  }
+
+  case DISK:
+    return 0.0;
+
+  case TORUS: {
+    double r = this->CrossSectionRadius;
+    return 2.0*pi*pi*this->RingRadius*r*r;
+  }
+  }
+
+  return 0.0;
+}
+
+//----------------------------------------------------------------------------
+void vtkAnalyticUniformPointSampler::ComputeSamplePoint(vtkIdType sample,
+                                                        double pt[3]) {
+  double twoPi = 2.0*vtkMath::Pi();
+  vtkTypeUInt32 words[4];
+  double u[4];
+
+  pt[0] = pt[1] = pt[2] = 0.0;
+
+  switch (this->Shape) {
+  case ELLIPSOID: {
+    double a = this->Radii[0], b = this->Radii[1], c = this->Radii[2];
+    if (this->SampleVolume) {
+      // Uniform point in the unit ball, stretched onto the ellipsoid.
+      this->SampleUniforms(sample, 3, u);
+      double z = 1.0 - 2.0*u[0];
+      double phi = twoPi*u[1];
+      double rho = sqrt(1.0 - z*z);
+      double s = pow(u[2], 1.0/3.0);
+      pt[0] = s*a*rho*cos(phi);
+      pt[1] = s*b*rho*sin(phi);
+      pt[2] = s*c*z;
+      return;
+    }
+
+    // Uniform direction on the unit sphere, accepted with probability
+    // proportional to the area scale factor of the mapping onto the
+    // ellipsoid.
+    double ia2 = 1.0/(a*a), ib2 = 1.0/(b*b), ic2 = 1.0/(c*c);
+    double gMax = sqrt(vtkMath::Max(ia2, vtkMath::Max(ib2, ic2)));
+    double x = 0.0, y = 0.0, z = 0.0;
+    for (vtkTypeUInt32 block = 0; block < MAX_REJECTION_BLOCKS; block++) {
+      this->RandomWords(sample, block, words);
+      z = 1.0 - 2.0*UniformFromWord(words[0]);
+      double phi = twoPi*UniformFromWord(words[1]);
+      double rho = sqrt(1.0 - z*z);
+      x = rho*cos(phi);
+      y = rho*sin(phi);
+      double g = sqrt(x*x*ia2 + y*y*ib2 + z*z*ic2);
+      if (UniformFromWord(words[2])*gMax <= g)
+        break;
+    }
+    pt[0] = a*x;
+    pt[1] = b*y;
+    pt[2] = c*z;
+    return;
+  }
+
+  case CYLINDER:
+  case HOLLOW_CYLINDER: {
+    // Cylinders have their axis along y. A solid cylinder is a hollow
+    // cylinder with zero inner radius.
+    double ri = 0.0, ro = this->Radius;
+    if (this->Shape == HOLLOW_CYLINDER) {
+      ri = this->InnerRadius;
+      ro = this->OuterRadius;
+    }
+    double h = this->Height;
+
+    this->SampleUniforms(sample, 4, u);
+
+    double theta = twoPi*u[1];
+    if (this->SampleVolume) {
+      double r = sqrt(ri*ri + u[2]*(ro*ro - ri*ri));
+      pt[0] = r*cos(theta);
+      pt[1] = (u[3] - 0.5)*h;
+      pt[2] = r*sin(theta);
+      return;
+    }
+
+    // Choose the outer wall, inner wall, or one of the two caps by area.
+    double outer = twoPi*ro*h;
+    double inner = twoPi*ri*h;
+    double cap   = 0.5*twoPi*(ro*ro - ri*ri);
+    double s = u[0]*(outer + inner + 2.0*cap);
+    if (s < outer + inner) {
+      double r = (s < outer) ? ro : ri;
+      pt[0] = r*cos(theta);
+      pt[1] = (u[2] - 0.5)*h;
+      pt[2] = r*sin(theta);
+    } else {
+      double r = sqrt(ri*ri + u[2]*(ro*ro - ri*ri));
+      pt[0] = r*cos(theta);
+      pt[1] = (s < outer + inner + cap) ? 0.5*h : -0.5*h;
+      pt[2] = r*sin(theta);
+    }
+    return;
+  }
+
+  case DISK: {
+    this->SampleUniforms(sample, 2, u);
+    double r = this->Radius*sqrt(u[0]);
+    double theta = twoPi*u[1];
+    pt[0] = r*cos(theta);
+    pt[1] = r*sin(theta);
+    return;
+  }
+
+  case TORUS: {
+    // The area (or volume) element of the torus at tube angle phi and
+    // tube radius rho is proportional to R + rho*cos(phi), so tube
+    // positions are accepted with that weight.
+    double R = this->RingRadius;
+    double r = this->CrossSectionRadius;
+    double rho = r, phi = 0.0;
+    for (vtkTypeUInt32 block = 0; block < MAX_REJECTION_BLOCKS; block++) {
+      this->RandomWords(sample, block, words);
+      for (int i = 0; i < 4; i++)
+        u[i] = UniformFromWord(words[i]);
+      phi = twoPi*u[0];
+      rho = this->SampleVolume ? r*sqrt(u[1]) : r;
+      if (u[2]*(R + r) <= fabs(R + rho*cos(phi)))
+        break;
+    }
+    double theta = twoPi*u[3];
+    double a = R + rho*cos(phi);
+    pt[0] = a*cos(theta);
+    pt[1] = a*sin(theta);
+    pt[2] = rho*sin(phi);
+    return;
+  }
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkAnalyticUniformPointSampler::ComputeNumberOfSamples(double measure, double density) {
+  double doublePoints = measure * density;
+  int numPoints = static_cast<int>(doublePoints + 0.5);
+  return numPoints;
+}
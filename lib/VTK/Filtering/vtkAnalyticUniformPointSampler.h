@@ -0,0 +1,156 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkAnalyticUniformPointSampler.h,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkAnalyticUniformPointSampler - Uniform point sampling of primitive shapes
+// .SECTION Description
+
+// vtkAnalyticUniformPointSampler creates a uniform sampling of points on
+// the surface or in the interior of a primitive shape directly from the
+// shape's parameters, without tessellating it. The shapes are placed the
+// same way as the corresponding volumetric sources: ellipsoids (and
+// spheres) and tori are centered at the origin with the torus ring in
+// the x-y plane, cylinders and hollow cylinders are centered at the
+// origin along the y axis, and disks lie in the x-y plane.
+//
+// Ellipsoid surfaces and tori are rejection sampled, so they ignore
+// LowDiscrepancy and always use independent random numbers.
+
+#ifndef __vtkAnalyticUniformPointSampler_h
+#define __vtkAnalyticUniformPointSampler_h
+
+#include "vtkUniformPointSampler.h"
+
+#include <vector>
+
+class vtkAnalyticUniformPointSampler : public vtkUniformPointSampler
+{
+public:
+  static vtkAnalyticUniformPointSampler *New();
+  vtkTypeMacro(vtkAnalyticUniformPointSampler,vtkUniformPointSampler);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum {
+    ELLIPSOID = 0,
+    CYLINDER,
+    HOLLOW_CYLINDER,
+    DISK,
+    TORUS
+  };
+
+  // Description:
+  // Shape to sample.
+  vtkSetClampMacro(Shape, int, ELLIPSOID, TORUS);
+  vtkGetMacro(Shape, int);
+  void SetShapeToEllipsoid()      {this->SetShape(ELLIPSOID);};
+  void SetShapeToCylinder()       {this->SetShape(CYLINDER);};
+  void SetShapeToHollowCylinder() {this->SetShape(HOLLOW_CYLINDER);};
+  void SetShapeToDisk()           {this->SetShape(DISK);};
+  void SetShapeToTorus()          {this->SetShape(TORUS);};
+
+  // Description:
+  // Sample the interior of the shape instead of its surface. Disks have
+  // no interior.
+  vtkSetMacro(SampleVolume, int);
+  vtkGetMacro(SampleVolume, int);
+  vtkBooleanMacro(SampleVolume, int);
+
+  // Description:
+  // Semi-axis lengths of the ellipsoid.
+  vtkSetVector3Macro(Radii, double);
+  vtkGetVector3Macro(Radii, double);
+
+  // Description:
+  // Radius of the cylinder and disk.
+  vtkSetClampMacro(Radius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Radius, double);
+
+  // Description:
+  // Radii of the hollow cylinder.
+  vtkSetClampMacro(InnerRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(InnerRadius, double);
+  vtkSetClampMacro(OuterRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(OuterRadius, double);
+
+  // Description:
+  // Height of the cylinder and hollow cylinder.
+  vtkSetClampMacro(Height, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Height, double);
+
+  // Description:
+  // Radii of the torus.
+  vtkSetClampMacro(RingRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(RingRadius, double);
+  vtkSetClampMacro(CrossSectionRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(CrossSectionRadius, double);
+
+  // Description:
+  // Get volume of the shape as of the last update.
+  vtkGetMacro(Volume, double);
+
+  // Description:
+  // Surface area and volume of the shape from its current parameters.
+  virtual double ComputeSurfaceArea();
+  virtual double ComputeVolume();
+
+  // Description:
+  // Get number of sample points for the given area or volume and density.
+  int ComputeNumberOfSamples(double measure, double density);
+
+protected:
+  vtkAnalyticUniformPointSampler();
+  virtual ~vtkAnalyticUniformPointSampler();
+
+  int    Shape;
+  int    SampleVolume;
+  double Radii[3];
+  double Radius;
+  double InnerRadius;
+  double OuterRadius;
+  double Height;
+  double RingRadius;
+  double CrossSectionRadius;
+
+  // Description:
+  // Volume of the shape.
+  double Volume;
+
+  // Description:
+  // Shape parameters the sample cache was generated with.
+  std::vector<double> SampledParameters;
+
+  // Description:
+  // Gets every parameter that the sample positions depend on.
+  void GetShapeParameters(std::vector<double>& parameters);
+
+  // Description:
+  // Computes sample point number sample.
+  virtual void ComputeSamplePoint(vtkIdType sample, double pt[3]);
+
+  // Description:
+  // Samples are computed directly from the shape's parameters about as
+  // fast as they could be read back, so they are not stored on disk.
+  virtual std::string GetSampleCacheFileName() { return std::string(); }
+
+  // Description:
+  // Usual data generation method.
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+private:
+  vtkAnalyticUniformPointSampler(const vtkAnalyticUniformPointSampler&);  // Not implemented.
+  void operator=(const vtkAnalyticUniformPointSampler&);  // Not implemented.
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "vtkCacheFileUtilities.h"
+
+#include <vtksys/Directory.hxx>
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Largest number of bytes of cache files kept in a cache directory.
+static vtkTypeInt64 vtkCacheFileUtilitiesCacheSizeLimit =
+  static_cast<vtkTypeInt64>(2) << 30;
+
+// Extensions of the files the limit applies to.
+static const char *vtkCacheFileUtilitiesExtensions[] = {".samples", ".tets"};
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 vtkCacheFileUtilities::HashBytes(const void *data, size_t length,
+                                               vtkTypeUInt64 hash)
+{
+  const unsigned char *bytes = static_cast<const unsigned char *>(data);
+  for (size_t i = 0; i < length; i++)
+    {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+    }
+  return hash;
+}
+
+//----------------------------------------------------------------------------
+void vtkCacheFileUtilities::SetCacheSizeLimit(vtkTypeInt64 bytes)
+{
+  vtkCacheFileUtilitiesCacheSizeLimit = bytes < 0 ? 0 : bytes;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkCacheFileUtilities::GetCacheSizeLimit()
+{
+  return vtkCacheFileUtilitiesCacheSizeLimit;
+}
+
+//----------------------------------------------------------------------------
+static bool vtkCacheFileUtilitiesIsCacheFile(const std::string& name)
+{
+  for (size_t e = 0; e < sizeof(vtkCacheFileUtilitiesExtensions)/sizeof(char *); e++)
+    {
+    const std::string extension(vtkCacheFileUtilitiesExtensions[e]);
+    if (name.size() > extension.size() &&
+        name.compare(name.size() - extension.size(), extension.size(), extension) == 0)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkCacheFileUtilities::PruneCacheDirectory(const char *fileName,
+                                                vtkTypeInt64 bytes)
+{
+  vtkTypeInt64 limit = GetCacheSizeLimit();
+  if (bytes > limit)
+    {
+    return false;
+    }
+
+  std::string directory = vtksys::SystemTools::GetFilenamePath(fileName);
+  std::string replaced = vtksys::SystemTools::GetFilenameName(fileName);
+  vtksys::Directory dir;
+  if (!dir.Load(directory.c_str()))
+    {
+    return true;
+    }
+
+  // Cache files by the time they were last used, leaving out the file
+  // about to be replaced.
+  std::vector<std::pair<long, std::string> > files;
+  vtkTypeInt64 total = 0;
+  for (unsigned long i = 0; i < dir.GetNumberOfFiles(); i++)
+    {
+    std::string name(dir.GetFile(i));
+    if (name == replaced || !vtkCacheFileUtilitiesIsCacheFile(name))
+      {
+      continue;
+      }
+
+    std::string path = directory + "/" + name;
+    total += static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(path.c_str()));
+    files.push_back(std::make_pair(vtksys::SystemTools::ModifiedTime(path.c_str()), path));
+    }
+  std::sort(files.begin(), files.end());
+
+  for (size_t i = 0; i < files.size() && total + bytes > limit; i++)
+    {
+    total -= static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(files[i].second.c_str()));
+    remove(files[i].second.c_str());
+    }
+  return true;
+}
@@ -0,0 +1,39 @@
+// .NAME vtkCacheFileUtilities - helpers shared by the filters that keep
+// results in a cache directory
+// .SECTION Description
+// vtkCacheFileUtilities holds the hashing and the size limit used by
+// vtkUniformPointSampler and vtkPolyDataToTetrahedralGrid, which may
+// share a cache directory. The limit applies to the cache files of both.
+
+
+#ifndef __vtkCacheFileUtilities_h
+#define __vtkCacheFileUtilities_h
+
+#include "vtkType.h"
+
+#include <cstddef>
+
+class vtkCacheFileUtilities
+{
+public:
+  // Description:
+  // 64-bit FNV-1a hash of length bytes, continuing from hash.
+  static vtkTypeUInt64 HashBytes(const void *data, size_t length,
+                                 vtkTypeUInt64 hash = 14695981039346656037ULL);
+
+  // Description:
+  // Largest number of bytes of cache files kept in a cache directory.
+  // Default is 2 GiB.
+  static void SetCacheSizeLimit(vtkTypeInt64 bytes);
+  static vtkTypeInt64 GetCacheSizeLimit();
+
+  // Description:
+  // Removes the least recently used cache files in the directory of
+  // fileName until bytes more would fit within the cache size limit.
+  // Sample (.samples) and tetrahedral mesh (.tets) files count toward
+  // the limit. Returns false if bytes alone go over the limit, in which
+  // case the file should not be written.
+  static bool PruneCacheDirectory(const char *fileName, vtkTypeInt64 bytes);
+};
+
+#endif
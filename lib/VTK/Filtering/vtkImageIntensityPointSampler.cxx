@@ -0,0 +1,225 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkImageIntensityPointSampler.cxx,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkImageIntensityPointSampler.h"
+
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+
+#include <cmath>
+
+vtkStandardNewMacro(vtkImageIntensityPointSampler);
+
+//----------------------------------------------------------------------------
+vtkImageIntensityPointSampler::vtkImageIntensityPointSampler()
+{
+  this->SetNumberOfInputPorts(1);
+  this->SetNumberOfOutputPorts(1);
+  this->BackgroundIntensity = 0.0;
+  this->TableBackgroundIntensity = 0.0;
+  this->WeightedVolume = 0.0;
+  for (int i = 0; i < 3; i++)
+    {
+    this->Dimensions[i] = 0;
+    this->Origin[i] = 0.0;
+    this->Spacing[i] = 1.0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkImageIntensityPointSampler::~vtkImageIntensityPointSampler()
+{
+}
+
+//----------------------------------------------------------------------------
+int vtkImageIntensityPointSampler::FillInputPortInformation(int port, vtkInformation *info) {
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkImageData");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageIntensityPointSampler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Background Intensity: " << this->BackgroundIntensity << "\n";
+  os << indent << "Weighted Volume: " << this->WeightedVolume << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkImageIntensityPointSampler::RequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  vtkImageData *input = vtkImageData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  output->Initialize();
+
+  // The cell weights depend only on the image and the background, so
+  // they are reused until either changes.
+  if (input->GetMTime() > this->AliasTableTime.GetMTime() ||
+      this->BackgroundIntensity != this->TableBackgroundIntensity ||
+      this->VoxelWeights.empty()) {
+    this->ComputeCellWeights(input);
+  }
+
+  int numPoints = this->NumberOfSamples;
+  if (!this->UseFixedNumberOfSamples)
+    numPoints = this->ComputeNumberOfSamples(this->WeightedVolume, this->Density);
+  if (this->WeightedVolume <= 0.0 || this->AliasProbability.empty())
+    numPoints = 0;
+
+  this->GenerateSamplePoints(numPoints, output);
+
+  this->ComputedTime = this->GetMTime();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkImageIntensityPointSampler::ComputeCellWeights(vtkImageData* input) {
+  input->GetDimensions(this->Dimensions);
+  input->GetOrigin(this->Origin);
+  input->GetSpacing(this->Spacing);
+  this->TableBackgroundIntensity = this->BackgroundIntensity;
+
+  int *dim = this->Dimensions;
+  vtkIdType numVoxels = static_cast<vtkIdType>(dim[0])*dim[1]*dim[2];
+  vtkDataArray *scalars = input->GetPointData()->GetScalars();
+
+  this->VoxelWeights.assign(numVoxels, 0.0f);
+  this->CellIds.clear();
+  this->WeightedVolume = 0.0;
+  if (!scalars || numVoxels == 0) {
+    this->BuildAliasTable(std::vector<double>());
+    this->AliasTableTime.Modified();
+    return;
+  }
+
+  for (vtkIdType i = 0; i < numVoxels; i++) {
+    double weight = scalars->GetComponent(i, 0) - this->BackgroundIntensity;
+    this->VoxelWeights[i] = weight > 0.0 ? static_cast<float>(weight) : 0.0f;
+  }
+
+  // Cells span neighboring voxel centers. Along an axis with a single
+  // voxel, cells are flat and both corners are that voxel.
+  int cells[3], step[3];
+  double cellSize = 1.0;
+  for (int a = 0; a < 3; a++) {
+    cells[a] = dim[a] > 1 ? dim[a] - 1 : 1;
+    step[a]  = dim[a] > 1 ? 1 : 0;
+    if (dim[a] > 1)
+      cellSize *= fabs(this->Spacing[a]);
+  }
+
+  // The integral of the trilinear interpolant over a cell is the cell
+  // size times the mean of its corner values.
+  std::vector<double> weights;
+  const float *w = &this->VoxelWeights[0];
+  vtkIdType sliceSize = static_cast<vtkIdType>(dim[0])*dim[1];
+  for (int k = 0; k < cells[2]; k++) {
+    for (int j = 0; j < cells[1]; j++) {
+      for (int i = 0; i < cells[0]; i++) {
+        vtkIdType v = i + j*dim[0] + k*sliceSize;
+        vtkIdType dx = step[0], dy = step[1]*dim[0], dz = step[2]*sliceSize;
+        double sum = w[v] + w[v+dx] + w[v+dy] + w[v+dx+dy] +
+          w[v+dz] + w[v+dx+dz] + w[v+dy+dz] + w[v+dx+dy+dz];
+        if (sum > 0.0) {
+          weights.push_back(sum);
+          this->CellIds.push_back(v);
+          this->WeightedVolume += 0.125 * sum * cellSize;
+        }
+      }
+    }
+  }
+
+  this->BuildAliasTable(weights);
+  this->HashDistribution(this->Dimensions, sizeof(this->Dimensions));
+  this->HashDistribution(this->Origin, sizeof(this->Origin));
+  this->HashDistribution(this->Spacing, sizeof(this->Spacing));
+  this->HashDistribution(&this->VoxelWeights[0],
+                         this->VoxelWeights.size()*sizeof(float));
+  this->AliasTableTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkImageIntensityPointSampler::ComputeSamplePoint(vtkIdType sample,
+                                                       double pt[3]) {
+  double u[5];
+  this->SampleUniforms(sample, 5, u);
+
+  const int *dim = this->Dimensions;
+  vtkIdType sliceSize = static_cast<vtkIdType>(dim[0])*dim[1];
+  vtkIdType v = this->CellIds[this->SampleCell(u[0])];
+  int index[3];
+  index[2] = static_cast<int>(v / sliceSize);
+  index[1] = static_cast<int>((v % sliceSize) / dim[0]);
+  index[0] = static_cast<int>(v % dim[0]);
+
+  vtkIdType offset[3];
+  offset[0] = dim[0] > 1 ? 1 : 0;
+  offset[1] = dim[1] > 1 ? dim[0] : 0;
+  offset[2] = dim[2] > 1 ? sliceSize : 0;
+
+  // Pick a corner in proportion to its weight.
+  const float *w = &this->VoxelWeights[0];
+  double corner[8], sum = 0.0;
+  for (int c = 0; c < 8; c++) {
+    corner[c] = w[v + ((c & 1) ? offset[0] : 0) + ((c & 2) ? offset[1] : 0) +
+                  ((c & 4) ? offset[2] : 0)];
+    sum += corner[c];
+  }
+  double target = u[1] * sum;
+  int c = 0;
+  for (; c < 7; c++) {
+    if (target < corner[c])
+      break;
+    target -= corner[c];
+  }
+  while (corner[c] == 0.0 && c > 0) {
+    // Round-off ran past the last corner with positive weight.
+    c--;
+  }
+
+  // Along each axis the corner's density rises linearly from the
+  // opposite face, so the coordinate is the square root of a uniform
+  // number measured from that face.
+  for (int a = 0; a < 3; a++) {
+    double t = sqrt(u[2+a]);
+    if (!(c & (1 << a)))
+      t = 1.0 - t;
+    if (dim[a] <= 1)
+      t = 0.0;
+    pt[a] = this->Origin[a] + (index[a] + t) * this->Spacing[a];
+  }
+}
+
+//----------------------------------------------------------------------------
+int vtkImageIntensityPointSampler::ComputeNumberOfSamples(double weightedVolume, double density) {
+  double doublePoints = weightedVolume * density;
+  int numPoints = static_cast<int>(doublePoints + 0.5);
+  return numPoints;
+}
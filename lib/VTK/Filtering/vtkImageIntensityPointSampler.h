@@ -0,0 +1,106 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkImageIntensityPointSampler.h,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkImageIntensityPointSampler - Samples points in proportion to image intensity
+// .SECTION Description
+
+// vtkImageIntensityPointSampler creates random points distributed with
+// a density proportional to the intensity of a vtkImageData, less a
+// background intensity. The density between voxel centers is the
+// trilinear interpolation of the voxel values, and it is sampled
+// exactly: a cell between eight voxel centers is picked from an alias
+// table over the cells with positive weight, then a corner is picked
+// in proportion to its weight, and the point is drawn from the product
+// of linear densities that rise toward that corner.
+//
+// Density is given in points per unit volume at unit intensity above
+// the background.
+
+#ifndef __vtkImageIntensityPointSampler_h
+#define __vtkImageIntensityPointSampler_h
+
+#include "vtkUniformPointSampler.h"
+
+#include <vector>
+
+class vtkImageData;
+
+class vtkImageIntensityPointSampler : public vtkUniformPointSampler
+{
+public:
+  static vtkImageIntensityPointSampler *New();
+  vtkTypeMacro(vtkImageIntensityPointSampler,vtkUniformPointSampler);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Intensity subtracted from every voxel. Voxels at or below it get
+  // no points.
+  vtkSetMacro(BackgroundIntensity, double);
+  vtkGetMacro(BackgroundIntensity, double);
+
+  // Description:
+  // Get the intensity-weighted volume of the image, the integral of
+  // the interpolated intensity above the background.
+  vtkGetMacro(WeightedVolume, double);
+
+  // Description:
+  // Get number of sample points for the given intensity-weighted volume
+  // and density.
+  int ComputeNumberOfSamples(double weightedVolume, double density);
+
+protected:
+  vtkImageIntensityPointSampler();
+  virtual ~vtkImageIntensityPointSampler();
+
+  double BackgroundIntensity;
+  double WeightedVolume;
+
+  // Description:
+  // Background intensity the tables were built with.
+  double TableBackgroundIntensity;
+
+  // Description:
+  // Voxel weights (intensity above background), image geometry, and
+  // the cells with positive weight in the same order as the alias
+  // table.
+  std::vector<float>     VoxelWeights;
+  std::vector<vtkIdType> CellIds;
+  int                    Dimensions[3];
+  double                 Origin[3];
+  double                 Spacing[3];
+
+  // Description:
+  // Overridden to specify that input is required to be vtkImageData.
+  virtual int FillInputPortInformation(int port, vtkInformation *info);
+
+  // Description:
+  // Reads the voxel weights and builds the alias table over cells.
+  void ComputeCellWeights(vtkImageData* input);
+
+  // Description:
+  // Computes sample point number sample.
+  virtual void ComputeSamplePoint(vtkIdType sample, double pt[3]);
+
+  // Description:
+  // Usual data generation method.
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+private:
+  vtkImageIntensityPointSampler(const vtkImageIntensityPointSampler&);  // Not implemented.
+  void operator=(const vtkImageIntensityPointSampler&);  // Not implemented.
+};
+
+#endif
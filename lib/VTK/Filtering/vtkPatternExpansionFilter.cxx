@@ -0,0 +1,211 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkPatternExpansionFilter.cxx,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPatternExpansionFilter.h"
+
+#include "vtkCellArray.h"
+#include "vtkFloatArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUniformPointSampler.h"
+
+vtkStandardNewMacro(vtkPatternExpansionFilter);
+
+// Random block used for the rotations, far from the blocks used by
+// vtkUniformPointSampler for sampling.
+static const vtkTypeUInt32 ORIENTATION_BLOCK = 0x40000000u;
+
+//----------------------------------------------------------------------------
+struct vtkPatternExpansionFilterThreadInfo
+{
+  vtkPatternExpansionFilter *Filter;
+  vtkPoints                 *Sites;
+  vtkIdType                  NumberOfSites;
+  const double              *Pattern;
+  vtkIdType                  PatternSize;
+  float                     *Output;
+};
+
+//----------------------------------------------------------------------------
+vtkPatternExpansionFilter::vtkPatternExpansionFilter()
+{
+  this->SetNumberOfInputPorts(2);
+  this->SetNumberOfOutputPorts(1);
+  this->RandomizeOrientations = 0;
+  this->Seed = 0;
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+}
+
+//----------------------------------------------------------------------------
+vtkPatternExpansionFilter::~vtkPatternExpansionFilter()
+{
+  if (this->Threader)
+    {
+    this->Threader->Delete();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkPatternExpansionFilter::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Randomize Orientations: " << this->RandomizeOrientations << "\n";
+  os << indent << "Seed: " << this->Seed << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkPatternExpansionFilter::SetPatternConnection(vtkAlgorithmOutput* algOutput) {
+  this->SetInputConnection(1, algOutput);
+}
+
+//----------------------------------------------------------------------------
+int vtkPatternExpansionFilter::FillInputPortInformation(int port, vtkInformation *info) {
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkPointSet");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkPatternExpansionFilter::ComputeRotation(vtkIdType i, double rotation[3][3]) {
+  if (!this->RandomizeOrientations) {
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) {
+        rotation[r][c] = (r == c) ? 1.0 : 0.0;
+      }
+    }
+    return;
+  }
+
+  vtkTypeUInt32 words[4];
+  vtkUniformPointSampler::GenerateRandomWords(this->Seed, i, ORIENTATION_BLOCK, words);
+  double u1 = vtkUniformPointSampler::UniformFromWord(words[0]);
+  double u2 = vtkUniformPointSampler::UniformFromWord(words[1]);
+  double u3 = vtkUniformPointSampler::UniformFromWord(words[2]);
+
+  // Uniformly random unit quaternion, from
+  // http://planning.cs.uiuc.edu/node198.html
+  double twoPi = 2.0 * vtkMath::Pi();
+  double quaternion[4];
+  quaternion[0] = sqrt(1.0-u1) * sin(twoPi*u2);
+  quaternion[1] = sqrt(1.0-u1) * cos(twoPi*u2);
+  quaternion[2] = sqrt(u1)     * sin(twoPi*u3);
+  quaternion[3] = sqrt(u1)     * cos(twoPi*u3);
+
+  vtkMath::QuaternionToMatrix3x3(quaternion, rotation);
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkPatternExpansionFilter::ThreadedExpandPattern(void *arg) {
+  int threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
+  int threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
+  vtkPatternExpansionFilterThreadInfo *userData = (vtkPatternExpansionFilterThreadInfo *)
+    (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
+
+  vtkIdType numSites = userData->NumberOfSites;
+  vtkIdType start = (numSites * threadId) / threadCount;
+  vtkIdType end   = (numSites * (threadId + 1)) / threadCount;
+
+  vtkIdType patternSize = userData->PatternSize;
+  const double *pattern = userData->Pattern;
+  float *out = userData->Output + 3*patternSize*start;
+  for (vtkIdType i = start; i < end; i++) {
+    double site[3], rotation[3][3];
+    userData->Sites->GetPoint(i, site);
+    userData->Filter->ComputeRotation(i, rotation);
+
+    const double *p = pattern;
+    for (vtkIdType j = 0; j < patternSize; j++, p += 3) {
+      for (int c = 0; c < 3; c++) {
+        *out++ = static_cast<float>(site[c] + rotation[c][0]*p[0] +
+                                    rotation[c][1]*p[1] + rotation[c][2]*p[2]);
+      }
+    }
+  }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+int vtkPatternExpansionFilter::RequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *patternInfo = inputVector[1]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  vtkPointSet *input = vtkPointSet::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkPointSet *patternData = patternInfo ? vtkPointSet::SafeDownCast(
+    patternInfo->Get(vtkDataObject::DATA_OBJECT())) : NULL;
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  output->Initialize();
+
+  vtkIdType numSites = input->GetNumberOfPoints();
+  vtkIdType patternSize = patternData ? patternData->GetNumberOfPoints() : 0;
+  if (numSites == 0 || patternSize == 0) {
+    return 1;
+  }
+
+  // Template coordinates, read once rather than through the data array
+  // for every copy.
+  std::vector<double> pattern(3*patternSize);
+  for (vtkIdType j = 0; j < patternSize; j++) {
+    patternData->GetPoint(j, &pattern[3*j]);
+  }
+
+  vtkIdType numPoints = numSites * patternSize;
+  vtkPoints *newPoints = vtkPoints::New(VTK_FLOAT);
+  newPoints->SetNumberOfPoints(numPoints);
+
+  vtkPatternExpansionFilterThreadInfo info;
+  info.Filter = this;
+  info.Sites = input->GetPoints();
+  info.NumberOfSites = numSites;
+  info.Pattern = &pattern[0];
+  info.PatternSize = patternSize;
+  info.Output = vtkFloatArray::SafeDownCast(newPoints->GetData())->GetPointer(0);
+
+  int numThreads = this->NumberOfThreads;
+  if (numThreads > numSites)
+    numThreads = static_cast<int>(numSites);
+  this->Threader->SetNumberOfThreads(numThreads);
+  this->Threader->SetSingleMethod(vtkPatternExpansionFilter::ThreadedExpandPattern,
+                                  &info);
+  this->Threader->SingleMethodExecute();
+
+  output->SetPoints(newPoints);
+  newPoints->Delete();
+
+  // One vertex cell per point
+  vtkCellArray *verts = vtkCellArray::New();
+  vtkIdType *cells = verts->WritePointer(numPoints, 2*numPoints);
+  for (vtkIdType i = 0; i < numPoints; i++) {
+    *cells++ = 1;
+    *cells++ = i;
+  }
+  output->SetVerts(verts);
+  verts->Delete();
+
+  return 1;
+}
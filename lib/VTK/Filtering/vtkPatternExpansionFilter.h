@@ -0,0 +1,91 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkPatternExpansionFilter.h,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPatternExpansionFilter - Replicates a point pattern at each input point
+// .SECTION Description
+
+// vtkPatternExpansionFilter places a copy of the points of a template
+// (the second input, e.g. the output of vtkPointRingSource or any
+// cluster of points) at every point of the first input, optionally
+// rotated by a uniformly random rotation per input point. The output
+// holds only points and one vertex cell per point. Copies are written
+// in parallel; the rotation of input point i depends only on Seed and
+// i, so the output does not depend on the number of threads.
+
+#ifndef __vtkPatternExpansionFilter_h
+#define __vtkPatternExpansionFilter_h
+
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkMultiThreader.h"
+
+#include <vector>
+
+class vtkPatternExpansionFilter : public vtkPolyDataAlgorithm
+{
+public:
+  static vtkPatternExpansionFilter *New();
+  vtkTypeMacro(vtkPatternExpansionFilter,vtkPolyDataAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set the pattern template. The template is placed with its origin at
+  // each input point.
+  void SetPatternConnection(vtkAlgorithmOutput* algOutput);
+
+  // Description:
+  // Rotate each copy of the pattern randomly.
+  vtkSetMacro(RandomizeOrientations, int);
+  vtkGetMacro(RandomizeOrientations, int);
+  vtkBooleanMacro(RandomizeOrientations, int);
+
+  // Description:
+  // Seed of the random rotations. The rotations draw on a range of
+  // vtkUniformPointSampler random blocks that sampling never uses, so a
+  // sampler and this filter can share a seed.
+  vtkSetMacro(Seed, unsigned int);
+  vtkGetMacro(Seed, unsigned int);
+
+  // Description:
+  // Number of threads used to expand the pattern.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+protected:
+  vtkPatternExpansionFilter();
+  virtual ~vtkPatternExpansionFilter();
+
+  int RandomizeOrientations;
+  unsigned int Seed;
+
+  vtkMultiThreader *Threader;
+  int               NumberOfThreads;
+
+  // Description:
+  // Computes the rotation matrix of the copy at input point i.
+  void ComputeRotation(vtkIdType i, double rotation[3][3]);
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExpandPattern(void *arg);
+
+  virtual int FillInputPortInformation(int port, vtkInformation *info);
+
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+private:
+  vtkPatternExpansionFilter(const vtkPatternExpansionFilter&);  // Not implemented.
+  void operator=(const vtkPatternExpansionFilter&);  // Not implemented.
+};
+
+#endif
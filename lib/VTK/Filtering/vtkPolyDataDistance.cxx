@@ -34,7 +34,8 @@
 
 #include "vtkImplicitPolyData.h"
 
-vtkCxxRevisionMacro(vtkPolyDataDistance, "$Revision: 1.1 $");
+#include <cmath>
+
 vtkStandardNewMacro(vtkPolyDataDistance);
 
 vtkPolyDataDistance::vtkPolyDataDistance() : vtkPolyDataAlgorithm()
@@ -62,13 +63,14 @@ int vtkPolyDataDistance::RequestData(vtkInformation*        vtkNotUsed(request),
    vtkInformation* inInfo0 = inputVector[0]->GetInformationObject(0);
    vtkInformation* inInfo1 = inputVector[1]->GetInformationObject(0);
    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+   vtkInformation* outInfo1 = outputVector->GetInformationObject(1);
 
-   if (!inInfo0 || !inInfo1 || !outInfo) return 0;
+   if (!inInfo0 || !inInfo1 || !outInfo || !outInfo1) return 0;
 
    vtkPolyData *input0 = vtkPolyData::SafeDownCast(inInfo0->Get(vtkDataObject::DATA_OBJECT()));
    vtkPolyData *input1 = vtkPolyData::SafeDownCast(inInfo1->Get(vtkDataObject::DATA_OBJECT()));
    vtkPolyData* output0 = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
-   vtkPolyData* output1 = this->GetSecondDistanceOutput();
+   vtkPolyData* output1 = vtkPolyData::SafeDownCast(outInfo1->Get(vtkDataObject::DATA_OBJECT()));
 
    if (!input0 || !input1 || !output0 || !output1) return 0;
 
@@ -112,15 +114,13 @@ void vtkPolyDataDistance::GetPolyDataDistance(vtkPolyData* mesh, vtkPolyData* sr
       return;
    }
 
-   int numPts = mesh->GetNumberOfPoints();
+   vtkIdType numPts = mesh->GetNumberOfPoints();
 
    vtkDoubleArray* da = vtkDoubleArray::New();
    da->SetName("Distance");
    da->SetNumberOfComponents(1);
    da->SetNumberOfTuples(numPts);
 
-   double* dist = da->GetPointer(0);
-
    double bound0[6], bound1[6], bounds[6];
    src->GetBounds(bound0);
    mesh->GetBounds(bound1);
@@ -136,11 +136,13 @@ void vtkPolyDataDistance::GetPolyDataDistance(vtkPolyData* mesh, vtkPolyData* sr
    imp->SetReverseBias(InvertDistance);
    imp->SetEvaluateBounds(bounds);
 
-   for (int i = 0; i < numPts; i++)
+   // evaluate all the points at once, so the threads share the work
+   imp->EvaluatePoints(mesh->GetPoints(), da);
+
+   double* dist = da->GetPointer(0);
+   for (vtkIdType i = 0; i < numPts; i++)
    {
-      double pt[3];
-      mesh->GetPoint(i, pt);
-      double val = imp->EvaluateFunction(pt);
+      double val = dist[i];
       dist[i] = SignedDistance ? (InvertDistance ? -val : val) : fabs(val);
    }
 
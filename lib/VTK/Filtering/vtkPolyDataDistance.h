@@ -24,7 +24,7 @@
 
 class vtkPolyDataDistance : public vtkPolyDataAlgorithm {
    public:
-      vtkTypeRevisionMacro(vtkPolyDataDistance, vtkPolyDataAlgorithm);
+      vtkTypeMacro(vtkPolyDataDistance, vtkPolyDataAlgorithm);
       void PrintSelf(ostream& os, vtkIndent indent);
 
       static vtkPolyDataDistance *New();
@@ -34,27 +34,56 @@
 #include <vtkDoubleArray.h>
 #include <vtkFloatArray.h>
 #include <vtkCellArray.h>
-#include <vtkOBBTree.h>
 #include <vtkDelaunay2D.h>
 #include <vtkCleanPolyData.h>
 #include <vtkCellDataToPointData.h>
-#include <vtkMatrix4x4.h>
 #include <vtkMergePoints.h>
-
+#include <vtkMath.h>
+
+// tri_tri_overlap.h is third-party code; leave it as it is and keep its
+// unused parameter from warning here.
+#if defined(_MSC_VER)
+#pragma warning(push)
+#pragma warning(disable: 4100)
+#elif defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
 #include "tri_tri_overlap.h"
+#if defined(_MSC_VER)
+#pragma warning(pop)
+#elif defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#include "vtkTriangleBVH.h"
 
+#include <algorithm>
 #include <queue>
 #include <vector>
 #include <map>
 
-vtkCxxRevisionMacro(vtkPolyDataIntersection, "$Revision: 1.2 $");
 vtkStandardNewMacro(vtkPolyDataIntersection);
 
+struct vtkPolyDataIntersectionThreadInfo
+{
+   vtkPolyDataIntersection* Self;
+   const std::pair<vtkIdType, vtkIdType>* Candidates;
+   vtkIdType NumberOfCandidates;
+   char* Hits;
+   double* Segments;
+};
+
 vtkPolyDataIntersection::vtkPolyDataIntersection() : vtkPolyDataAlgorithm()
 {
    this->pdA = 0;
    this->pdB = 0;
 
+   this->bvhA = vtkTriangleBVH::New();
+   this->bvhB = vtkTriangleBVH::New();
+
+   this->Threader = vtkMultiThreader::New();
+   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+
    this->SplitFirstMesh = 1;
    this->SplitSecondMesh = 1;
 
@@ -72,24 +101,27 @@ vtkPolyDataIntersection::vtkPolyDataIntersection() : vtkPolyDataAlgorithm()
 
 vtkPolyDataIntersection::~vtkPolyDataIntersection()
 {
+   this->bvhA->Delete();
+   this->bvhB->Delete();
+   this->Threader->Delete();
 }
 
 #define COPY_INPUT_TO_OUTPUT_MACRO(IN,OUT) \
 {\
       vtkCleanPolyData* clean = vtkCleanPolyData::New();\
-      clean->SetInput(IN);\
+      clean->SetInputData(IN);\
       clean->ConvertLinesToPointsOff();\
       clean->ConvertPolysToLinesOff();\
       clean->ConvertStripsToPolysOff();\
       clean->PointMergingOn();\
       clean->SetAbsoluteTolerance(0);\
       clean->ToleranceIsAbsoluteOn();\
-      clean->GetOutput()->ReleaseDataFlagOn();\
+      clean->ReleaseDataFlagOn();\
 \
       vtkCellDataToPointData* cd2pd = vtkCellDataToPointData::New();\
-      cd2pd->SetInput(clean->GetOutput());\
+      cd2pd->SetInputConnection(clean->GetOutputPort());\
       cd2pd->PassCellDataOn();\
-      cd2pd->GetOutput()->ReleaseDataFlagOn();\
+      cd2pd->ReleaseDataFlagOn();\
       cd2pd->Update();\
 \
       OUT->CopyStructure(cd2pd->GetOutput());\
@@ -108,17 +140,19 @@ int vtkPolyDataIntersection::RequestData(vtkInformation*        vtkNotUsed(reque
    vtkInformation* inInfo0 = inputVector[0]->GetInformationObject(0);
    vtkInformation* inInfo1 = inputVector[1]->GetInformationObject(0);
    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+   vtkInformation* outInfo1 = outputVector->GetInformationObject(1);
+   vtkInformation* outInfo2 = outputVector->GetInformationObject(2);
 
-   if (!inInfo0 || !inInfo1 || !outInfo) return 0;
+   if (!inInfo0 || !inInfo1 || !outInfo || !outInfo1 || !outInfo2) return 0;
 
    vtkPolyData* input0 = vtkPolyData::SafeDownCast(inInfo0->Get(vtkDataObject::DATA_OBJECT()));
    vtkPolyData* input1 = vtkPolyData::SafeDownCast(inInfo1->Get(vtkDataObject::DATA_OBJECT()));
    vtkPolyData* output = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-   vtkPolyData* firstMeshOutput = this->GetFirstMeshOutput();
-   vtkPolyData* secondMeshOutput = this->GetSecondMeshOutput();
+   vtkPolyData* firstMeshOutput = vtkPolyData::SafeDownCast(outInfo1->Get(vtkDataObject::DATA_OBJECT()));
+   vtkPolyData* secondMeshOutput = vtkPolyData::SafeDownCast(outInfo2->Get(vtkDataObject::DATA_OBJECT()));
 
-   if (!input0 || !input1 || !output) return 0;
+   if (!input0 || !input1 || !output || !firstMeshOutput || !secondMeshOutput) return 0;
 
    vtkPolyData* temp0 = vtkPolyData::New();
    temp0->Allocate(input0);
@@ -197,56 +231,57 @@ void vtkPolyDataIntersection::IntersectTriangles(vtkPolyData* out0, vtkPolyData*
    this->pdA = in0;
    this->pdB = in1;
 
-   vtkOBBTree* obbA = vtkOBBTree::New();
-   obbA->SetDataSet(in0);
-   obbA->SetNumberOfCellsPerNode(10);
-   obbA->SetMaxLevel(1e6);// that's a lot of levels, should give 1 cell/bucket typically
-   obbA->SetTolerance(1e-6);
-   obbA->AutomaticOn();
-   obbA->BuildLocator();
-
-   this->obbB = vtkOBBTree::New();
-   this->obbB->SetDataSet(in1);
-   this->obbB->SetNumberOfCellsPerNode(10);
-   this->obbB->SetMaxLevel(1e6);
-   this->obbB->SetTolerance(1e-6);
-   this->obbB->AutomaticOn();
-   this->obbB->BuildLocator();
-
-   this->potIntMap.clear();
-
-   obbA->IntersectWithOBBTree(this->obbB, 0, this->TestAndMark, this);
-
-   obbA->Delete();
-   this->obbB->Delete();
+   // only rebuilt if the input changed since the last execution
+   this->bvhA->SetDataSet(in0);
+   this->bvhA->BuildLocator();
+   this->bvhB->SetDataSet(in1);
+   this->bvhB->BuildLocator();
+
+   // pairs of triangles whose bounds overlap, in order of the first
+   // triangle so the output is the same from run to run
+   std::vector<std::pair<vtkIdType, vtkIdType> > candidates;
+   this->bvhA->FindOverlappingTriangles(this->bvhB, candidates);
+   std::sort(candidates.begin(), candidates.end());
+
+   // test the pairs in parallel, each thread filling in the results of
+   // its own block of pairs. the hierarchies only hold triangles, and
+   // building them built the cells of both inputs, so the threads only
+   // read them.
+   vtkIdType numCandidates = static_cast<vtkIdType>(candidates.size());
+   std::vector<char> hits(numCandidates, 0);
+   std::vector<double> segments(6*numCandidates);
+   if (numCandidates > 0)
+   {
+      vtkPolyDataIntersectionThreadInfo info;
+      info.Self = this;
+      info.Candidates = &candidates[0];
+      info.NumberOfCandidates = numCandidates;
+      info.Hits = &hits[0];
+      info.Segments = &segments[0];
+
+      int numThreads = this->NumberOfThreads;
+      if (numThreads > numCandidates) numThreads = static_cast<int>(numCandidates);
+      this->Threader->SetNumberOfThreads(numThreads);
+      this->Threader->SetSingleMethod(vtkPolyDataIntersection::ThreadedFindIntersections, &info);
+      this->Threader->SingleMethodExecute();
+   }
 
    this->intIndMap[0].clear();
    this->intIndMap[1].clear();
 
    vtkPoints* points = vtkPoints::New();
    vtkCellArray* lines = vtkCellArray::New();
-   mapIter it1 = this->potIntMap.begin();
-   mapIter it2;
-   while (it1 != this->potIntMap.end())
+   for (vtkIdType i = 0; i < numCandidates; i++)
    {
-      it2 = this->potIntMap.upper_bound(it1->first);
-      double pt0[3], pt1[3];
-
-      //for ( ; it1 != it2; it1++)
-      while (it1 != it2)
+      if (hits[i])
       {
-         if (FindIntersection(it1->first, it1->second, pt0, pt1))
-         {
-            int ind = points->GetNumberOfPoints();
-            lines->InsertNextCell(2);
-            lines->InsertCellPoint(points->InsertNextPoint(pt0));
-            lines->InsertCellPoint(points->InsertNextPoint(pt1));
+         int ind = static_cast<int>(points->GetNumberOfPoints());
+         lines->InsertNextCell(2);
+         lines->InsertCellPoint(points->InsertNextPoint(&segments[6*i]));
+         lines->InsertCellPoint(points->InsertNextPoint(&segments[6*i+3]));
 
-            this->intIndMap[0].insert(std::make_pair(it1->first, ind));
-            this->intIndMap[1].insert(std::make_pair(it1->second, ind));
-         }
-         if (it1 != this->potIntMap.end())
-            it1++;
+         this->intIndMap[0].insert(std::make_pair(static_cast<int>(candidates[i].first), ind));
+         this->intIndMap[1].insert(std::make_pair(static_cast<int>(candidates[i].second), ind));
       }
    }
 //   points->Squeeze();
@@ -258,8 +293,6 @@ void vtkPolyDataIntersection::IntersectTriangles(vtkPolyData* out0, vtkPolyData*
    lines->Delete();
    inter->Squeeze();
 
-   this->potIntMap.clear();
-
    if (this->SplitFirstMesh) SplitTriangles(in0, out0, inter, 0);
    this->intIndMap[0].clear();
 
@@ -295,12 +328,10 @@ void vtkPolyDataIntersection::SplitTriangles(vtkPolyData* in, vtkPolyData* out,
 
    vtkMergePoints* merge = vtkMergePoints::New();
 
-   int split = 0, splits = 0;
    it1 = this->intIndMap[AorB].begin();
    while (it1 != this->intIndMap[AorB].end())
    {
       it2 = this->intIndMap[AorB].upper_bound(it1->first);
-      split++;
       int first = it1->first;
 
       // make a polydata containing the intersection points as line segments
@@ -345,13 +376,13 @@ void vtkPolyDataIntersection::SplitTriangles(vtkPolyData* in, vtkPolyData* out,
 //#define USE_TRIGEN
 #ifdef USE_TRIGEN
       vtkTriGen* del = vtkTriGen::New();
-      del->SetInput(0, pd);
-      del->SetInput(1, pd);
+      del->SetInputData(0, pd);
+      del->SetInputData(1, pd);
       del->Update();
 #else
       vtkDelaunay2D* del = vtkDelaunay2D::New();
-      del->SetInput(pd);
-      del->SetSource(pd);
+      del->SetInputData(pd);
+      del->SetSourceData(pd);
       del->SetTolerance(0.);
       del->SetAlpha(0.);
       del->SetOffset(1e6);
@@ -369,7 +400,7 @@ void vtkPolyDataIntersection::SplitTriangles(vtkPolyData* in, vtkPolyData* out,
       else
       {
          in->GetCellPoints(first, npts, pts);
-         vtkTriangle::ComputeNormal(in->GetPoints(), npts, pts, n0);
+         vtkTriangle::ComputeNormal(in->GetPoints(), static_cast<int>(npts), pts, n0);
       }
       vtkFloatArray* norm = vtkFloatArray::New();
       norm->SetName("Normals");
@@ -381,7 +412,7 @@ void vtkPolyDataIntersection::SplitTriangles(vtkPolyData* in, vtkPolyData* out,
          {
             toCopy->InsertNextId(i);
             temp->GetCellPoints(i, npts, pts);
-            vtkTriangle::ComputeNormal(temp->GetPoints(), npts, pts, n1);
+            vtkTriangle::ComputeNormal(temp->GetPoints(), static_cast<int>(npts), pts, n1);
             if (vtkMath::Dot(n0, n1) < 0.)
             {
                temp->ReverseCell(i);
@@ -401,9 +432,6 @@ void vtkPolyDataIntersection::SplitTriangles(vtkPolyData* in, vtkPolyData* out,
       }
       // would be nice if this copied all the point data instead of just creating normals
 
-      splits += toCopy->GetNumberOfIds();
-      //if (splits < 3)
-      //   std::cerr << "vtkPDI: cell # " << first << " split into " << toCopy->GetNumberOfIds() << " cells" << std::endl;
       out->CopyCells(temp, toCopy, 0);
       //std::cerr << "vtkPDI: " << out->GetNumberOfCells() << " cells in output" << std::endl;
 
@@ -412,14 +440,6 @@ void vtkPolyDataIntersection::SplitTriangles(vtkPolyData* in, vtkPolyData* out,
 
       out->Squeeze();
    }
-   //std::cerr << "vtkPDI: sanity check!" << std::endl
-      //<< "in    : " << in->GetNumberOfCells() << std::endl
-      //<< "copy  : " << copied << std::endl
-      //<< "split : " << split << std::endl
-      //<< "in = copy + split ? " << in->GetNumberOfCells() << " : " << (copied + split) << std::endl
-      //<< "splits: " << splits << std::endl
-      //<< "out   : " << out->GetNumberOfCells() << std::endl
-      //<< "out = copy + splits ? " << out->GetNumberOfCells() << " : " << (copied + splits) << std::endl;
 
    toCopy->Delete();
    lines->Delete();
@@ -430,45 +450,26 @@ void vtkPolyDataIntersection::SplitTriangles(vtkPolyData* in, vtkPolyData* out,
    out->Squeeze();
 }
 
-int vtkPolyDataIntersection::TestAndMark(vtkOBBNode* nodeA, vtkOBBNode* nodeB,
-                                         vtkMatrix4x4* xform, void* arg)
+VTK_THREAD_RETURN_TYPE vtkPolyDataIntersection::ThreadedFindIntersections(void* arg)
 {
-   vtkPolyDataIntersection* self = reinterpret_cast<vtkPolyDataIntersection*>(arg);
+   int threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
+   int threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
+   vtkPolyDataIntersectionThreadInfo* userData = (vtkPolyDataIntersectionThreadInfo *)
+      (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
 
-   int numCellsA = nodeA->Cells->GetNumberOfIds();
-   int numCellsB = nodeB->Cells->GetNumberOfIds();
-   int retval = 0;
+   vtkIdType begin = (userData->NumberOfCandidates * threadId) / threadCount;
+   vtkIdType end   = (userData->NumberOfCandidates * (threadId+1)) / threadCount;
 
-   for (int i = 0; i < numCellsA; i++)
+   for (vtkIdType i = begin; i < end; i++)
    {
-      int cellIdA = nodeA->Cells->GetId(i),
-          typeA = self->pdA->GetCellType(cellIdA);
-
-      if (typeA == VTK_TRIANGLE)
-      {
-         vtkIdType nPts;
-         vtkIdType* aPts;
-         self->pdA->GetCellPoints(cellIdA, nPts, aPts);
-         double aPt[3][3];
-         self->pdA->GetPoint(aPts[0], aPt[0]);
-         self->pdA->GetPoint(aPts[1], aPt[1]);
-         self->pdA->GetPoint(aPts[2], aPt[2]);
-
-         if (self->obbB->TriangleIntersectsNode(nodeB, aPt[0], aPt[1], aPt[2], xform))
-            for (int j = 0; j < numCellsB; j++)
-            {
-               int cellIdB = nodeB->Cells->GetId(j),
-                     typeB = self->pdB->GetCellType(cellIdB);
-
-               if (typeB == VTK_TRIANGLE)
-               {
-                  self->potIntMap.insert(std::make_pair(cellIdA, cellIdB));
-                  retval++;
-               }
-            }
-      }
+      double* segment = userData->Segments + 6*i;
+      userData->Hits[i] = userData->Self->FindIntersection(
+         static_cast<int>(userData->Candidates[i].first),
+         static_cast<int>(userData->Candidates[i].second),
+         segment, segment + 3) ? 1 : 0;
    }
-   return retval;
+
+   return VTK_THREAD_RETURN_VALUE;
 }
 
 int vtkPolyDataIntersection::FindIntersection(int cellIdA, int cellIdB, double pt0[3], double pt1[3])
@@ -499,7 +500,7 @@ int vtkPolyDataIntersection::FindIntersection(int cellIdA, int cellIdB, double p
                                             bPt[0], bPt[1], bPt[2],
                                             &coplanar, pt0, pt1);
 
-   if (coplanar) vtkDebugMacro("Coplanar!? Unhandled!");
+   if (coplanar) vtkDebugMacro(<<"Coplanar!? Unhandled!");
    // so, the intersection routine is pretty robust, and can detect coplanar cases
    // (to within some error tollerances). but it doesn't return the intersection of
    // two overlapping, coplanar triangles, it just sets a flag. the data i had while
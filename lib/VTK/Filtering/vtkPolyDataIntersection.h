@@ -21,17 +21,16 @@
 #define __vtkPolyDataIntersection_h
 
 #include <vtkPolyDataAlgorithm.h>
+#include <vtkMultiThreader.h>
 
 #include <map>
 
-class vtkOBBTree;
-class vtkOBBNode;
-class vtkMatrix4x4;
+class vtkTriangleBVH;
 
 class vtkPolyDataIntersection : public vtkPolyDataAlgorithm
 {
    public:
-      vtkTypeRevisionMacro(vtkPolyDataIntersection, vtkPolyDataAlgorithm);
+      vtkTypeMacro(vtkPolyDataIntersection, vtkPolyDataAlgorithm);
       void PrintSelf(ostream& os, vtkIndent indent);
 
       vtkGetMacro(SplitFirstMesh, int);
@@ -56,7 +55,7 @@ class vtkPolyDataIntersection : public vtkPolyDataAlgorithm
       int FillInputPortInformation(int, vtkInformation*);
 
       void IntersectTriangles(vtkPolyData*, vtkPolyData*, vtkPolyData*, vtkPolyData*, vtkPolyData*);
-      static int TestAndMark(vtkOBBNode*, vtkOBBNode*, vtkMatrix4x4*, void*);
+      static VTK_THREAD_RETURN_TYPE ThreadedFindIntersections(void*);
       int FindIntersection(int, int, double[3], double[3]);
       void SplitTriangles(vtkPolyData*, vtkPolyData*, vtkPolyData*, int);
 
@@ -65,9 +64,15 @@ class vtkPolyDataIntersection : public vtkPolyDataAlgorithm
 
       vtkPolyData* pdA;
       vtkPolyData* pdB;
-      vtkOBBTree* obbB;
 
-      std::multimap<int, int> potIntMap;
+      // the hierarchies over the two inputs are kept between executions,
+      // and only rebuilt when their input has changed
+      vtkTriangleBVH* bvhA;
+      vtkTriangleBVH* bvhB;
+
+      vtkMultiThreader* Threader;
+      int NumberOfThreads;
+
       std::multimap<int, int> intIndMap[2];
       typedef std::multimap<int, int>::iterator mapIter;
       //ETX
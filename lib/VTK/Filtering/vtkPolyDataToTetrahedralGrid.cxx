@@ -14,8 +14,12 @@
 =========================================================================*/
 #include "vtkPolyDataToTetrahedralGrid.h"
 
+#include "vtkAbstractTransform.h"
+#include "vtkCacheFileUtilities.h"
 #include "vtkCellArray.h"
+#include "vtkCriticalSection.h"
 #include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
@@ -27,7 +31,100 @@
 #include "vtkUnstructuredGrid.h"
 #include "tetgen.h"
 
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
 vtkStandardNewMacro(vtkPolyDataToTetrahedralGrid);
+vtkCxxSetObjectMacro(vtkPolyDataToTetrahedralGrid, Transform, vtkAbstractTransform);
+
+//----------------------------------------------------------------------------
+// Cache directory for instances that do not set one.
+static std::string vtkPolyDataToTetrahedralGridGlobalCacheDirectory;
+
+// Identifies mesh cache files. Change the version when the way meshes are
+// generated changes, so that old files are no longer used.
+static const char vtkPolyDataToTetrahedralGridCacheMagic[8] =
+  {'M', 'S', 'I', 'M', 'T', 'E', 'T', '1'};
+
+//----------------------------------------------------------------------------
+// Polygons of one or more components of the input that are tetrahedralized
+// together, with their points numbered from 0, and the resulting mesh.
+struct vtkPolyDataToTetrahedralGridPiece
+{
+  enum {
+    MESHED = 0,
+    OVERLAPPING,
+    DETECTION_FAILED,
+    MESHING_FAILED
+  };
+
+  std::vector<double> InputPoints;
+  std::vector<int>    PolygonSizes;
+  std::vector<int>    PolygonPoints;
+
+  std::vector<double> Points;
+  std::vector<int>    Tetrahedra;
+  int                 Status;
+};
+
+struct vtkPolyDataToTetrahedralGridThreadInfo
+{
+  vtkPolyDataToTetrahedralGrid                   *Filter;
+  std::vector<vtkPolyDataToTetrahedralGridPiece> *Pieces;
+
+  const char                                     *Switches;
+
+  // Pieces in the order the threads take them, largest first.
+  std::vector<size_t>                             Order;
+};
+
+//----------------------------------------------------------------------------
+// Orders pieces by decreasing number of polygons.
+struct vtkPolyDataToTetrahedralGridLargerPiece
+{
+  const std::vector<vtkPolyDataToTetrahedralGridPiece> *Pieces;
+  bool operator()(size_t a, size_t b) const
+  {
+    return (*Pieces)[a].PolygonSizes.size() > (*Pieces)[b].PolygonSizes.size();
+  }
+};
+
+//----------------------------------------------------------------------------
+// Orders components by the lower x bound of their boxes.
+struct vtkPolyDataToTetrahedralGridLowerBound
+{
+  const std::vector<double> *Bounds;
+  bool operator()(vtkIdType a, vtkIdType b) const
+  {
+    return (*Bounds)[6*a] < (*Bounds)[6*b];
+  }
+};
+
+//----------------------------------------------------------------------------
+static vtkIdType vtkPolyDataToTetrahedralGridFindRoot(std::vector<vtkIdType>& parent,
+                                                      vtkIdType i) {
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+//----------------------------------------------------------------------------
+static void vtkPolyDataToTetrahedralGridJoin(std::vector<vtkIdType>& parent,
+                                             vtkIdType a, vtkIdType b) {
+  a = vtkPolyDataToTetrahedralGridFindRoot(parent, a);
+  b = vtkPolyDataToTetrahedralGridFindRoot(parent, b);
+  if (a < b) {
+    parent[b] = a;
+  } else if (b < a) {
+    parent[a] = b;
+  }
+}
 
 //----------------------------------------------------------------------------
 vtkPolyDataToTetrahedralGrid::vtkPolyDataToTetrahedralGrid()
@@ -36,17 +133,53 @@ vtkPolyDataToTetrahedralGrid::vtkPolyDataToTetrahedralGrid()
   // subclasses that deviate should modify this setting
   this->SetNumberOfInputPorts(1);
   this->SetNumberOfOutputPorts(1);
+
+  this->Switches = NULL;
+  this->SetSwitches("pQ");
+  this->CacheDirectory = NULL;
+  this->Transform = NULL;
+
+  this->MeshHash = 0;
+  this->MeshValid = 0;
+
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+  this->PieceMutex = new vtkSimpleCriticalSection;
+  this->NextPiece = 0;
 }
 
 //----------------------------------------------------------------------------
 vtkPolyDataToTetrahedralGrid::~vtkPolyDataToTetrahedralGrid()
 {
+  this->SetSwitches(NULL);
+  this->SetCacheDirectory(NULL);
+  this->SetTransform(NULL);
+  this->Threader->Delete();
+  delete this->PieceMutex;
 }
 
 //----------------------------------------------------------------------------
 void vtkPolyDataToTetrahedralGrid::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Switches: "
+     << (this->Switches ? this->Switches : "(none)") << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+  os << indent << "Cache Directory: "
+     << (this->CacheDirectory ? this->CacheDirectory : "(none)") << "\n";
+  os << indent << "Transform: " << this->Transform << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkPolyDataToTetrahedralGrid::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Transform) {
+    vtkMTimeType transformMTime = this->Transform->GetMTime();
+    mTime = (transformMTime > mTime ? transformMTime : mTime);
+  }
+  return mTime;
 }
 
 
@@ -57,41 +190,161 @@ int vtkPolyDataToTetrahedralGrid::FillInputPortInformation(int port, vtkInformat
 }
 
 //----------------------------------------------------------------------------
-tetgenio* vtkPolyDataToTetrahedralGridCreateTetgenio(vtkPolyData *polyData) {
+void vtkPolyDataToTetrahedralGrid::SetGlobalCacheDirectory(const char *directory) {
+  vtkPolyDataToTetrahedralGridGlobalCacheDirectory = directory ? directory : "";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkPolyDataToTetrahedralGrid::GetGlobalCacheDirectory() {
+  if (vtkPolyDataToTetrahedralGridGlobalCacheDirectory.empty())
+    return NULL;
+  return vtkPolyDataToTetrahedralGridGlobalCacheDirectory.c_str();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkPolyDataToTetrahedralGrid::GetCacheFileName(vtkTypeUInt64 hash) {
+  const char *directory = this->CacheDirectory;
+  if (!directory || directory[0] == '\0')
+    directory = GetGlobalCacheDirectory();
+  if (!directory)
+    return std::string();
+
+  char name[256];
+  sprintf(name, "%s-%016llx.tets", this->GetClassName(),
+          static_cast<unsigned long long>(hash));
+
+  std::string fileName(directory);
+  fileName.append("/");
+  fileName.append(name);
+  return fileName;
+}
+
+//----------------------------------------------------------------------------
+// Cache files hold the magic string, the numbers of points and tetrahedra
+// as 64-bit integers, the points as interleaved double-precision
+// coordinates, and the four point ids of each tetrahedron as 64-bit
+// integers, all in native byte order.
+bool vtkPolyDataToTetrahedralGrid::ReadCacheFile(const char *fileName,
+                                                 std::vector<double>& points,
+                                                 std::vector<vtkTypeInt64>& tetrahedra) {
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  if (!file)
+    return false;
+
+  char magic[8];
+  vtkTypeInt64 numPoints = 0, numTetrahedra = 0;
+  file.read(magic, 8);
+  file.read(reinterpret_cast<char *>(&numPoints), sizeof(numPoints));
+  file.read(reinterpret_cast<char *>(&numTetrahedra), sizeof(numTetrahedra));
+  if (!file || memcmp(magic, vtkPolyDataToTetrahedralGridCacheMagic, 8) != 0 ||
+      numPoints < 0 || numTetrahedra < 0) {
+    return false;
+  }
+
+  // Check the size before allocating so a damaged header does not
+  // trigger a huge allocation.
+  std::streampos dataStart = file.tellg();
+  file.seekg(0, std::ios::end);
+  std::streampos dataEnd = file.tellg();
+  if (static_cast<vtkTypeInt64>(dataEnd - dataStart) !=
+      numPoints * 3 * static_cast<vtkTypeInt64>(sizeof(double)) +
+      numTetrahedra * 4 * static_cast<vtkTypeInt64>(sizeof(vtkTypeInt64))) {
+    return false;
+  }
+  file.seekg(dataStart);
+
+  points.resize(3*numPoints);
+  tetrahedra.resize(4*numTetrahedra);
+  if (numPoints > 0)
+    file.read(reinterpret_cast<char *>(&points[0]), 3*numPoints*sizeof(double));
+  if (numTetrahedra > 0)
+    file.read(reinterpret_cast<char *>(&tetrahedra[0]),
+              4*numTetrahedra*sizeof(vtkTypeInt64));
+  if (!file)
+    return false;
+
+  for (size_t i = 0; i < tetrahedra.size(); i++) {
+    if (tetrahedra[i] < 0 || tetrahedra[i] >= numPoints)
+      return false;
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPolyDataToTetrahedralGrid::WriteCacheFile(const char *fileName,
+                                                  const std::vector<double>& points,
+                                                  const std::vector<vtkTypeInt64>& tetrahedra) {
+  std::string directory = vtksys::SystemTools::GetFilenamePath(fileName);
+  if (!directory.empty() && !vtksys::SystemTools::MakeDirectory(directory.c_str()))
+    return false;
+
+  std::string tempName(fileName);
+  char suffix[64];
+  sprintf(suffix, ".%p.tmp", static_cast<const void *>(&points));
+  tempName.append(suffix);
+
+  std::ofstream file(tempName.c_str(), std::ios::out | std::ios::binary);
+  if (!file)
+    return false;
+
+  vtkTypeInt64 numPoints = static_cast<vtkTypeInt64>(points.size() / 3);
+  vtkTypeInt64 numTetrahedra = static_cast<vtkTypeInt64>(tetrahedra.size() / 4);
+  file.write(vtkPolyDataToTetrahedralGridCacheMagic, 8);
+  file.write(reinterpret_cast<const char *>(&numPoints), sizeof(numPoints));
+  file.write(reinterpret_cast<const char *>(&numTetrahedra), sizeof(numTetrahedra));
+  if (numPoints > 0)
+    file.write(reinterpret_cast<const char *>(&points[0]),
+               points.size()*sizeof(double));
+  if (numTetrahedra > 0)
+    file.write(reinterpret_cast<const char *>(&tetrahedra[0]),
+               tetrahedra.size()*sizeof(vtkTypeInt64));
+  file.close();
+  if (!file) {
+    remove(tempName.c_str());
+    return false;
+  }
+
+  // rename() does not replace existing files on every platform.
+  remove(fileName);
+  if (rename(tempName.c_str(), fileName) != 0) {
+    remove(tempName.c_str());
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+tetgenio* vtkPolyDataToTetrahedralGridCreateTetgenio(
+  const vtkPolyDataToTetrahedralGridPiece& piece) {
   tetgenio *out = new tetgenio();
-  
+
   // All indices start from 0.
   out->firstnumber = 0;
 
-  out->numberofpoints = polyData->GetNumberOfPoints();
+  out->numberofpoints = static_cast<int>(piece.InputPoints.size() / 3);
   out->pointlist = new REAL[out->numberofpoints * 3];
-  double inputPoints[3];
-  for (int i = 0; i < out->numberofpoints; i++) {
-    polyData->GetPoint(i, inputPoints);
-    out->pointlist[i*3 + 0] = inputPoints[0];
-    out->pointlist[i*3 + 1] = inputPoints[1];
-    out->pointlist[i*3 + 2] = inputPoints[2];
+  for (int i = 0; i < out->numberofpoints * 3; i++) {
+    out->pointlist[i] = piece.InputPoints[i];
   }
 
-  out->numberoffacets = polyData->GetNumberOfPolys();
+  out->numberoffacets = static_cast<int>(piece.PolygonSizes.size());
   out->facetlist = new tetgenio::facet[out->numberoffacets];
   out->facetmarkerlist = NULL;
 
-  vtkCellArray *polys = polyData->GetPolys();
-  int polyId = 0;
-  vtkIdType npts, *pts;
-  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ) {
-    tetgenio::facet *f = &out->facetlist[polyId++];
+  const int *pts = piece.PolygonPoints.empty() ? NULL : &piece.PolygonPoints[0];
+  for (int polyId = 0; polyId < out->numberoffacets; polyId++) {
+    tetgenio::facet *f = &out->facetlist[polyId];
     f->numberofpolygons = 1;
     f->polygonlist = new tetgenio::polygon[f->numberofpolygons];
     f->numberofholes = 0;
     f->holelist = NULL;
 
     tetgenio::polygon *p = &f->polygonlist[0];
-    p->numberofvertices = npts;
+    p->numberofvertices = piece.PolygonSizes[polyId];
     p->vertexlist = new int[p->numberofvertices];
-    for (int i = 0; i < npts; i++) {
-      p->vertexlist[i] = pts[i];
+    for (int i = 0; i < p->numberofvertices; i++) {
+      p->vertexlist[i] = *pts++;
     }
   }
 
@@ -99,80 +352,332 @@ tetgenio* vtkPolyDataToTetrahedralGridCreateTetgenio(vtkPolyData *polyData) {
 }
 
 //----------------------------------------------------------------------------
-// This is the superclasses style of Execute method.  Convert it into
-// an imaging style Execute method.
-int vtkPolyDataToTetrahedralGrid::RequestData(
-  vtkInformation* request,
-  vtkInformationVector** inputVector,
-  vtkInformationVector* outputVector)
-{
-  // get the info objects
-  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
-  vtkInformation *outInfo = outputVector->GetInformationObject(0);
-
-  vtkPolyData *input = vtkPolyData::SafeDownCast(
-    inInfo->Get(vtkDataObject::DATA_OBJECT()));
-  vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
-    outInfo->Get(vtkDataObject::DATA_OBJECT()));
-
+// Tetrahedralizes one piece. Only touches the piece, so pieces may be
+// meshed on several threads at once. The only state TetGen shares between
+// calls is the error bounds of its predicates, which must be set by
+// calling exactinit() before the threads start.
+static void vtkPolyDataToTetrahedralGridMeshPiece(
+  vtkPolyDataToTetrahedralGridPiece& piece, const char *switches) {
   // Create tetrahedral mesh from input closed manifold
   tetgenio *in, *detect, out;
-  in = vtkPolyDataToTetrahedralGridCreateTetgenio(input);
+  in = vtkPolyDataToTetrahedralGridCreateTetgenio(piece);
 
   // First, detect if there are any overlapping polygons in the geometry
+  piece.Status = vtkPolyDataToTetrahedralGridPiece::MESHED;
   detect = new tetgenio();
   detect->numberofpoints = 0;
   try {
     char options[] = "pdQ";
     tetrahedralize(options, in, detect);
   } catch (...) {
-    vtkErrorMacro(<< "Error when testing geometry for overlapping polygons");
+    piece.Status = vtkPolyDataToTetrahedralGridPiece::DETECTION_FAILED;
   }
 
-  if (detect->numberofpoints == 0) { // Geometry passed the test?
+  out.numberofpoints = 0;
+  out.numberoftetrahedra = 0;
+  if (detect->numberofpoints != 0) {
+    piece.Status = vtkPolyDataToTetrahedralGridPiece::OVERLAPPING;
+  } else if (piece.Status == vtkPolyDataToTetrahedralGridPiece::MESHED) {
     // This shouldn't be necessary, but it seems to prevent some
     // crashes when tetrahedralizing some geometries.
     delete in;
-    in = vtkPolyDataToTetrahedralGridCreateTetgenio(input);
+    in = vtkPolyDataToTetrahedralGridCreateTetgenio(piece);
 
+    std::vector<char> options(switches, switches + strlen(switches) + 1);
     try {
-      char options[] = "pQ";
-      tetrahedralize(options, in, &out);
+      tetrahedralize(&options[0], in, &out);
     } catch (...) {
-      vtkErrorMacro(<< "Error when generating Delaunay tetrahedralization of geometry");
+      piece.Status = vtkPolyDataToTetrahedralGridPiece::MESHING_FAILED;
 
       // Initialize output data structure
       out.numberofpoints = 0;
       out.numberoftetrahedra = 0;
     }
-  } else {
-    out.numberofpoints = 0;
-    out.numberoftetrahedra = 0;
   }
 
   delete detect;
   delete in;
 
-  vtkPoints *points = vtkPoints::New();
-  points->SetNumberOfPoints(out.numberofpoints);
-  for (int i = 0; i < out.numberofpoints; i++) {
-    points->InsertPoint(i, i*3 + out.pointlist);
+  piece.Points.assign(out.pointlist, out.pointlist + 3*out.numberofpoints);
+  piece.Tetrahedra.assign(out.tetrahedronlist,
+                          out.tetrahedronlist + 4*out.numberoftetrahedra);
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyDataToTetrahedralGrid::SplitInput(
+  vtkPolyData *input, std::vector<vtkPolyDataToTetrahedralGridPiece>& pieces) {
+  vtkIdType numPoints = input->GetNumberOfPoints();
+  vtkCellArray *polys = input->GetPolys();
+  vtkIdType npts, *pts;
+
+  // Components of points connected by polygons.
+  std::vector<vtkIdType> parent(numPoints);
+  for (vtkIdType i = 0; i < numPoints; i++) {
+    parent[i] = i;
+  }
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ) {
+    for (vtkIdType i = 1; i < npts; i++) {
+      vtkPolyDataToTetrahedralGridJoin(parent, pts[0], pts[i]);
+    }
+  }
+
+  // Number the components and find their bounds.
+  std::vector<vtkIdType> component(numPoints, -1);
+  std::vector<double> bounds;
+  vtkIdType numComponents = 0;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ) {
+    for (vtkIdType i = 0; i < npts; i++) {
+      vtkIdType root = vtkPolyDataToTetrahedralGridFindRoot(parent, pts[i]);
+      if (component[root] < 0) {
+        component[root] = numComponents++;
+        bounds.push_back(VTK_DOUBLE_MAX); bounds.push_back(-VTK_DOUBLE_MAX);
+        bounds.push_back(VTK_DOUBLE_MAX); bounds.push_back(-VTK_DOUBLE_MAX);
+        bounds.push_back(VTK_DOUBLE_MAX); bounds.push_back(-VTK_DOUBLE_MAX);
+      }
+      double *b = &bounds[6*component[root]];
+      double x[3];
+      input->GetPoint(pts[i], x);
+      for (int c = 0; c < 3; c++) {
+        b[2*c]   = std::min(b[2*c],   x[c]);
+        b[2*c+1] = std::max(b[2*c+1], x[c]);
+      }
+    }
+  }
+
+  // Components whose boxes overlap may be nested, and TetGen needs to see
+  // them together to leave cavities alone, so join them. Sweep over the
+  // components in order of their lower x bound so that only those that
+  // overlap in x are compared.
+  std::vector<vtkIdType> sorted(numComponents);
+  std::vector<vtkIdType> group(numComponents);
+  for (vtkIdType i = 0; i < numComponents; i++) {
+    sorted[i] = i;
+    group[i] = i;
+  }
+  vtkPolyDataToTetrahedralGridLowerBound lowerBound;
+  lowerBound.Bounds = &bounds;
+  std::sort(sorted.begin(), sorted.end(), lowerBound);
+  for (vtkIdType i = 0; i < numComponents; i++) {
+    const double *a = &bounds[6*sorted[i]];
+    for (vtkIdType j = i+1; j < numComponents; j++) {
+      const double *b = &bounds[6*sorted[j]];
+      if (b[0] > a[1])
+        break;
+      if (a[2] <= b[3] && b[2] <= a[3] && a[4] <= b[5] && b[4] <= a[5]) {
+        vtkPolyDataToTetrahedralGridJoin(group, sorted[i], sorted[j]);
+      }
+    }
+  }
+
+  // Make a piece for each group, numbered in order of first appearance
+  // so the output does not depend on the sort.
+  std::vector<vtkIdType> pieceOfGroup(numComponents, -1);
+  std::vector<int> localId(numPoints, -1);
+  pieces.clear();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ) {
+    if (npts == 0)
+      continue;
+    vtkIdType root = vtkPolyDataToTetrahedralGridFindRoot(parent, pts[0]);
+    vtkIdType g = vtkPolyDataToTetrahedralGridFindRoot(group, component[root]);
+    if (pieceOfGroup[g] < 0) {
+      pieceOfGroup[g] = static_cast<vtkIdType>(pieces.size());
+      pieces.push_back(vtkPolyDataToTetrahedralGridPiece());
+    }
+
+    vtkPolyDataToTetrahedralGridPiece& piece = pieces[pieceOfGroup[g]];
+    piece.PolygonSizes.push_back(static_cast<int>(npts));
+    for (vtkIdType i = 0; i < npts; i++) {
+      if (localId[pts[i]] < 0) {
+        localId[pts[i]] = static_cast<int>(piece.InputPoints.size() / 3);
+        double x[3];
+        input->GetPoint(pts[i], x);
+        piece.InputPoints.insert(piece.InputPoints.end(), x, x+3);
+      }
+      piece.PolygonPoints.push_back(localId[pts[i]]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkPolyDataToTetrahedralGrid::ThreadedExecute( void *arg )
+{
+  vtkPolyDataToTetrahedralGridThreadInfo *info =
+    (vtkPolyDataToTetrahedralGridThreadInfo *)
+    (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
+  vtkPolyDataToTetrahedralGrid *self = info->Filter;
+
+  // Hand out pieces one at a time, largest first, since their sizes may
+  // differ a lot.
+  while (true) {
+    self->PieceMutex->Lock();
+    size_t next = self->NextPiece++;
+    self->PieceMutex->Unlock();
+
+    if (next >= info->Order.size())
+      break;
+
+    vtkPolyDataToTetrahedralGridMeshPiece((*info->Pieces)[info->Order[next]],
+                                          info->Switches);
+  }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+// This is the superclasses style of Execute method.  Convert it into
+// an imaging style Execute method.
+int vtkPolyDataToTetrahedralGrid::RequestData(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  // get the info objects
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  vtkPolyData *input = vtkPolyData::SafeDownCast(
+    inInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  const char *switches = this->Switches ? this->Switches : "pQ";
+
+  // Hash everything the mesh depends on.
+  vtkTypeUInt64 hash = vtkCacheFileUtilities::HashBytes(switches, strlen(switches));
+  for (vtkIdType i = 0; i < input->GetNumberOfPoints(); i++) {
+    double x[3];
+    input->GetPoint(i, x);
+    hash = vtkCacheFileUtilities::HashBytes(x, sizeof(x), hash);
   }
-  
-  output->Allocate(out.numberoftetrahedra, 100);
-  for (int i = 0; i < out.numberoftetrahedra; i++) {
-    vtkTetra *tetra = vtkTetra::New();
-    tetra->GetPointIds()->SetId(0, out.tetrahedronlist[4*i + 0]);
-    tetra->GetPointIds()->SetId(1, out.tetrahedronlist[4*i + 1]);
-    tetra->GetPointIds()->SetId(2, out.tetrahedronlist[4*i + 2]);
-    tetra->GetPointIds()->SetId(3, out.tetrahedronlist[4*i + 3]);
-    output->InsertNextCell(tetra->GetCellType(), tetra->GetPointIds());
-    tetra->Delete();
+  vtkCellArray *polys = input->GetPolys();
+  vtkIdType npts, *pts;
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ) {
+    vtkTypeInt64 cell[1] = {npts};
+    hash = vtkCacheFileUtilities::HashBytes(cell, sizeof(cell), hash);
+    for (vtkIdType i = 0; i < npts; i++) {
+      cell[0] = pts[i];
+      hash = vtkCacheFileUtilities::HashBytes(cell, sizeof(cell), hash);
+    }
   }
 
+  // Only a change to the transform leaves the hash unchanged, and then
+  // the mesh of the last execution is transformed again.
+  std::vector<double>& points = this->MeshPoints;
+  std::vector<vtkTypeInt64>& tetrahedra = this->MeshTetrahedra;
+  std::string cacheFileName = this->GetCacheFileName(hash);
+  if (this->MeshValid && hash == this->MeshHash) {
+    vtkDebugMacro(<< "Reusing tetrahedral mesh of the last execution");
+  } else if (!cacheFileName.empty() &&
+             ReadCacheFile(cacheFileName.c_str(), points, tetrahedra)) {
+    vtkDebugMacro(<< "Read tetrahedral mesh from " << cacheFileName);
+
+    // Mark the file as recently used so it is removed last.
+    vtksys::SystemTools::Touch(cacheFileName.c_str(), false);
+    this->MeshValid = 1;
+  } else {
+    points.clear();
+    tetrahedra.clear();
+
+    std::vector<vtkPolyDataToTetrahedralGridPiece> pieces;
+    this->SplitInput(input, pieces);
+
+    vtkPolyDataToTetrahedralGridThreadInfo info;
+    info.Filter = this;
+    info.Pieces = &pieces;
+    info.Switches = switches;
+    info.Order.resize(pieces.size());
+    for (size_t i = 0; i < pieces.size(); i++) {
+      info.Order[i] = i;
+    }
+    vtkPolyDataToTetrahedralGridLargerPiece larger;
+    larger.Pieces = &pieces;
+    std::stable_sort(info.Order.begin(), info.Order.end(), larger);
+
+    if (!pieces.empty()) {
+      // Set the predicates' error bounds here, so the calls to exactinit()
+      // made by each tetrahedralize() leave them alone while other threads
+      // use them.
+      exactinit();
+
+      this->NextPiece = 0;
+      this->Threader->SetNumberOfThreads(
+        static_cast<int>(std::min(static_cast<size_t>(this->NumberOfThreads),
+                                  pieces.size())));
+      this->Threader->SetSingleMethod(vtkPolyDataToTetrahedralGrid::ThreadedExecute,
+                                      &info);
+      this->Threader->SingleMethodExecute();
+    }
+
+    // Gather the pieces in order, and report their errors here since the
+    // threads should not.
+    bool meshed = true;
+    for (size_t p = 0; p < pieces.size(); p++) {
+      vtkPolyDataToTetrahedralGridPiece& piece = pieces[p];
+      if (piece.Status == vtkPolyDataToTetrahedralGridPiece::OVERLAPPING) {
+        vtkErrorMacro(<< "Geometry has overlapping polygons, leaving a component "
+                      << "out of the tetrahedralization");
+        meshed = false;
+      } else if (piece.Status == vtkPolyDataToTetrahedralGridPiece::DETECTION_FAILED) {
+        vtkErrorMacro(<< "Error when testing geometry for overlapping polygons");
+        meshed = false;
+      } else if (piece.Status == vtkPolyDataToTetrahedralGridPiece::MESHING_FAILED) {
+        vtkErrorMacro(<< "Error when generating Delaunay tetrahedralization of geometry");
+        meshed = false;
+      }
+
+      vtkTypeInt64 offset = static_cast<vtkTypeInt64>(points.size() / 3);
+      points.insert(points.end(), piece.Points.begin(), piece.Points.end());
+      for (size_t i = 0; i < piece.Tetrahedra.size(); i++) {
+        tetrahedra.push_back(offset + piece.Tetrahedra[i]);
+      }
+    }
+
+    // Only store complete meshes, so that a failed or partial mesh is not
+    // read back in place of a new attempt.
+    if (meshed && !cacheFileName.empty()) {
+      vtkTypeInt64 fileSize = 8 + 2*sizeof(vtkTypeInt64) +
+        static_cast<vtkTypeInt64>(points.size()*sizeof(double)) +
+        static_cast<vtkTypeInt64>(tetrahedra.size()*sizeof(vtkTypeInt64));
+      if (vtkCacheFileUtilities::PruneCacheDirectory(cacheFileName.c_str(), fileSize) &&
+          !WriteCacheFile(cacheFileName.c_str(), points, tetrahedra)) {
+        vtkWarningMacro(<< "Could not write tetrahedral mesh cache file " << cacheFileName);
+      }
+    }
+    this->MeshValid = meshed ? 1 : 0;
+  }
+  this->MeshHash = hash;
+
+  vtkIdType numPoints = static_cast<vtkIdType>(points.size() / 3);
+  vtkPoints *outPoints = vtkPoints::New();
+  outPoints->SetNumberOfPoints(numPoints);
+  for (vtkIdType i = 0; i < numPoints; i++) {
+    if (this->Transform) {
+      double x[3];
+      this->Transform->TransformPoint(&points[3*i], x);
+      outPoints->SetPoint(i, x);
+    } else {
+      outPoints->SetPoint(i, &points[3*i]);
+    }
+  }
+
+  vtkIdType numTetrahedra = static_cast<vtkIdType>(tetrahedra.size() / 4);
+  vtkIdTypeArray *connectivity = vtkIdTypeArray::New();
+  connectivity->SetNumberOfValues(5*numTetrahedra);
+  vtkIdType *conn = numTetrahedra > 0 ? connectivity->GetPointer(0) : NULL;
+  for (vtkIdType i = 0; i < numTetrahedra; i++) {
+    *conn++ = 4;
+    for (int j = 0; j < 4; j++) {
+      *conn++ = static_cast<vtkIdType>(tetrahedra[4*i + j]);
+    }
+  }
+  vtkCellArray *cells = vtkCellArray::New();
+  cells->SetCells(numTetrahedra, connectivity);
+  connectivity->Delete();
 
-  output->SetPoints(points);
-  points->Delete();
+  output->SetPoints(outPoints);
+  output->SetCells(VTK_TETRA, cells);
+  outPoints->Delete();
+  cells->Delete();
 
   return 1;
 }
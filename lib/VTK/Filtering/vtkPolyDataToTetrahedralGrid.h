@@ -30,13 +30,35 @@
 // function. A list of options is available at
 //
 // http://tetgen.berlios.de/switches.html
+//
+// Components of the input whose bounding boxes do not overlap are
+// tetrahedralized separately and at the same time on several threads.
+// Components whose boxes overlap, such as the inner and outer walls of a
+// hollow object, are tetrahedralized together.
+//
+// When a cache directory is set, the mesh is stored in a file named by a
+// hash of the input points, polygons and switches, and later executions
+// with the same input, in this session or another, read it back instead
+// of running TetGen. The files count toward the cache size limit of
+// vtkCacheFileUtilities.
+//
+// An optional transform is applied to the points of the mesh after it
+// is generated, so that scaling or moving the input does not mesh it
+// again.
 
 #ifndef __vtkPolyDataToTetrahedralGrid_h
 #define __vtkPolyDataToTetrahedralGrid_h
 
 #include "vtkUnstructuredGridAlgorithm.h"
+#include "vtkMultiThreader.h"
+
+#include <string>
+#include <vector>
 
+class vtkAbstractTransform;
 class vtkDoubleArray;
+class vtkSimpleCriticalSection;
+struct vtkPolyDataToTetrahedralGridPiece;
 
 class vtkPolyDataToTetrahedralGrid : public vtkUnstructuredGridAlgorithm
 {
@@ -45,11 +67,93 @@ public:
   vtkTypeMacro(vtkPolyDataToTetrahedralGrid,vtkUnstructuredGridAlgorithm);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // Switches passed to TetGen's tetrahedralize() function. Must include
+  // 'p' and should include 'Q', since several components may be meshed
+  // at once. Default is "pQ".
+  vtkSetStringMacro(Switches);
+  vtkGetStringMacro(Switches);
+
+  // Description:
+  // Number of threads used to tetrahedralize separate components.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Directory holding tetrahedral meshes between sessions. When not set,
+  // the global cache directory is used; when neither is set, nothing is
+  // stored.
+  vtkSetStringMacro(CacheDirectory);
+  vtkGetStringMacro(CacheDirectory);
+
+  // Description:
+  // Cache directory shared by all instances that do not set their own.
+  static void SetGlobalCacheDirectory(const char *directory);
+  static const char* GetGlobalCacheDirectory();
+
+  // Description:
+  // Transform applied to the points of the mesh. The mesh and its cache
+  // file depend only on the untransformed input, so changing the
+  // transform reuses the mesh of the last execution. Default is none.
+  virtual void SetTransform(vtkAbstractTransform *transform);
+  vtkGetObjectMacro(Transform, vtkAbstractTransform);
+
+  // Description:
+  // Return the MTime also considering the transform.
+  vtkMTimeType GetMTime();
 
 protected:
   vtkPolyDataToTetrahedralGrid();
   ~vtkPolyDataToTetrahedralGrid();
 
+  char *Switches;
+  char *CacheDirectory;
+
+  vtkAbstractTransform *Transform;
+
+  // Description:
+  // Untransformed mesh of the last execution and the hash of the input
+  // and switches it was generated from. MeshValid is false if the last
+  // execution failed.
+  vtkTypeUInt64 MeshHash;
+  int           MeshValid;
+  //BTX
+  std::vector<double>       MeshPoints;
+  std::vector<vtkTypeInt64> MeshTetrahedra;
+  //ETX
+
+  vtkMultiThreader         *Threader;
+  int                       NumberOfThreads;
+  vtkSimpleCriticalSection *PieceMutex;
+  size_t                    NextPiece;
+
+  // Description:
+  // Splits the polygons of the input into pieces that can be
+  // tetrahedralized separately.
+  //BTX
+  void SplitInput(vtkPolyData *input,
+                  std::vector<vtkPolyDataToTetrahedralGridPiece>& pieces);
+  //ETX
+
+  // Description:
+  // Name of the cache file for the given hash of the input and switches,
+  // or an empty string if no cache directory is set.
+  std::string GetCacheFileName(vtkTypeUInt64 hash);
+
+  // Description:
+  // Read and write the points and tetrahedra of a mesh in a cache file.
+  // Reading returns false if the file does not exist or is not a valid
+  // cache file.
+  //BTX
+  static bool ReadCacheFile(const char *fileName, std::vector<double>& points,
+                            std::vector<vtkTypeInt64>& tetrahedra);
+  static bool WriteCacheFile(const char *fileName,
+                             const std::vector<double>& points,
+                             const std::vector<vtkTypeInt64>& tetrahedra);
+  //ETX
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute( void *arg );
+
   // Description:
   // Fills in input data port information.
   virtual int FillInputPortInformation(int port, vtkInformation* info);
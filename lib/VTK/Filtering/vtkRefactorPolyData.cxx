@@ -40,16 +40,18 @@
 #include "vtkPolyDataIntersection.h"
 #include "vtkPolyDataDistance.h"
 
+#include <cmath>
 #include <set>
 #include <queue>
 
-vtkCxxRevisionMacro(vtkRefactorPolyData, "$Revision: 1.1 $");
 vtkStandardNewMacro(vtkRefactorPolyData);
 
 vtkRefactorPolyData::vtkRefactorPolyData() : vtkPolyDataAlgorithm()
 {
    this->Tolerance = 1e-9;
 
+   this->Intersection = vtkPolyDataIntersection::New();
+
    this->SetNumberOfInputPorts(2);
    this->SetNumberOfOutputPorts(3);
 
@@ -64,6 +66,7 @@ vtkRefactorPolyData::vtkRefactorPolyData() : vtkPolyDataAlgorithm()
 
 vtkRefactorPolyData::~vtkRefactorPolyData()
 {
+   this->Intersection->Delete();
 }
 
 void vtkRefactorPolyData::SortPolyData(vtkPolyData* mesh, vtkPolyData* inter,
@@ -139,7 +142,7 @@ void vtkRefactorPolyData::SortPolyData(vtkPolyData* mesh, vtkPolyData* inter,
       {
          outCount += dist[pts[i]] > 1e-6;
          inCount  += dist[pts[i]] < -1e-6;
-         onCount  += abs(dist[pts[i]]) <= 1e-6;
+         onCount  += fabs(dist[pts[i]]) <= 1e-6;
       }
 
       if (outCount + onCount == npts) label[cid] = 1;
@@ -202,9 +205,7 @@ void vtkRefactorPolyData::SortPolyData(vtkPolyData* mesh, vtkPolyData* inter,
          outList->InsertNextId(i);
       else if (label[i] == 0)
          inList->InsertNextId(i);
-      else
-         // std::cerr << i << " : unlabeled!" << std::endl;
-         ; // unwanted tris
+      // otherwise unlabeled, one of the unwanted tris
    }
 
    delete[] label;
@@ -217,21 +218,23 @@ int vtkRefactorPolyData::RequestData(vtkInformation*        vtkNotUsed(request),
    vtkInformation* inInfo0 = inputVector[0]->GetInformationObject(0);
    vtkInformation* inInfo1 = inputVector[1]->GetInformationObject(0);
    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+   vtkInformation* outInfo1 = outputVector->GetInformationObject(1);
+   vtkInformation* outInfo2 = outputVector->GetInformationObject(2);
 
-   if (!inInfo0 || !inInfo1 || !outInfo) return 0;
+   if (!inInfo0 || !inInfo1 || !outInfo || !outInfo1 || !outInfo2) return 0;
 
    vtkPolyData* input0 = vtkPolyData::SafeDownCast(inInfo0->Get(vtkDataObject::DATA_OBJECT()));
    vtkPolyData* input1 = vtkPolyData::SafeDownCast(inInfo1->Get(vtkDataObject::DATA_OBJECT()));
    vtkPolyData* output0 = vtkPolyData::SafeDownCast(outInfo->Get(vtkDataObject::DATA_OBJECT()));
-   vtkPolyData* output1 = this->GetInsideOutput();
-   vtkPolyData* output2 = this->GetIntersectionOutput();
+   vtkPolyData* output1 = vtkPolyData::SafeDownCast(outInfo1->Get(vtkDataObject::DATA_OBJECT()));
+   vtkPolyData* output2 = vtkPolyData::SafeDownCast(outInfo2->Get(vtkDataObject::DATA_OBJECT()));
 
    if (!input0 || !input1 || !output0 || !output1 || !output2) return 0;
 
    // get intersected versions
-   vtkPolyDataIntersection* pdi = vtkPolyDataIntersection::New();
-   pdi->SetInput(0, input0);
-   pdi->SetInput(1, input1);
+   vtkPolyDataIntersection* pdi = this->Intersection;
+   pdi->SetInputData(0, input0);
+   pdi->SetInputData(1, input1);
    pdi->SplitFirstMeshOn();
    pdi->SplitSecondMeshOn();
    pdi->Update();
@@ -242,11 +245,10 @@ int vtkRefactorPolyData::RequestData(vtkInformation*        vtkNotUsed(request),
 
    // compute distances
    vtkPolyDataDistance* dist = vtkPolyDataDistance::New();
-   dist->SetInput(0, pdi->GetFirstMeshOutput());
-   dist->SetInput(1, pdi->GetSecondMeshOutput());
+   dist->SetInputConnection(0, pdi->GetOutputPort(1));
+   dist->SetInputConnection(1, pdi->GetOutputPort(2));
    dist->ComputeSecondDistanceOn();
    dist->Update();
-   pdi->Delete();
 
    vtkPolyData* pd0 = dist->GetOutput();
    vtkPolyData* pd1 = dist->GetSecondDistanceOutput();
@@ -329,7 +331,7 @@ int vtkRefactorPolyData::RequestData(vtkInformation*        vtkNotUsed(request),
    dist->Delete();
 
    vtkPolyDataNormals* norm0 = vtkPolyDataNormals::New();
-   norm0->SetInput(temp0);
+   norm0->SetInputData(temp0);
    norm0->AutoOrientNormalsOff();
    norm0->ConsistencyOn();
    norm0->SplittingOff();
@@ -343,7 +345,7 @@ int vtkRefactorPolyData::RequestData(vtkInformation*        vtkNotUsed(request),
    norm0->Delete();
 
    vtkPolyDataNormals* norm1 = vtkPolyDataNormals::New();
-   norm1->SetInput(temp1);
+   norm1->SetInputData(temp1);
    norm1->AutoOrientNormalsOff();
    norm1->ConsistencyOn();
    norm1->SplittingOff();
@@ -24,11 +24,12 @@
 
 class vtkIdList;
 class vtkImplicitPolyData;
+class vtkPolyDataIntersection;
 
 class vtkRefactorPolyData : public vtkPolyDataAlgorithm
 {
    public:
-      vtkTypeRevisionMacro(vtkRefactorPolyData, vtkPolyDataAlgorithm);
+      vtkTypeMacro(vtkRefactorPolyData, vtkPolyDataAlgorithm);
       void PrintSelf(ostream& os, vtkIndent indent);
 
       vtkPolyData* GetOutsideOutput();
@@ -46,6 +47,10 @@ class vtkRefactorPolyData : public vtkPolyDataAlgorithm
 
       double Tolerance;
 
+      // kept between executions so the hierarchies it builds over the
+      // inputs are reused while the inputs are unchanged
+      vtkPolyDataIntersection* Intersection;
+
       void SortPolyData(vtkPolyData*, vtkPolyData*, vtkIdList*, vtkIdList*);
 
       int RequestData(vtkInformation*, vtkInformationVector**, vtkInformationVector*);
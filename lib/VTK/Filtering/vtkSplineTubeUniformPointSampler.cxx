@@ -0,0 +1,644 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkSplineTubeUniformPointSampler.cxx,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkSplineTubeUniformPointSampler.h"
+
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkObjectFactory.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+vtkStandardNewMacro(vtkSplineTubeUniformPointSampler);
+
+// Rejection sampling gives up and accepts the last candidate after this
+// many blocks of random words. The acceptance probability is at least
+// one half while the tube is thinner than its radius of curvature.
+static const vtkTypeUInt32 MAX_REJECTION_BLOCKS = 64;
+
+// Intervals are halved at most this many times.
+static const int MAX_SUBDIVISION_DEPTH = 12;
+
+// Nodes and weights of 5-point Gauss-Legendre quadrature on [-1,1].
+static const double GAUSS_NODES[5] = {
+  -0.9061798459386640, -0.5384693101056831, 0.0,
+   0.5384693101056831,  0.9061798459386640
+};
+static const double GAUSS_WEIGHTS[5] = {
+  0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+  0.4786286704993665, 0.2369268850561891
+};
+
+//----------------------------------------------------------------------------
+// Position and first and second derivatives of a segment's cubic.
+static void vtkSplineTubeEvaluate(const double c[3][4], double f, double p[3],
+                                  double d1[3], double d2[3]) {
+  for (int i = 0; i < 3; i++) {
+    p[i]  = c[i][0] + f*(c[i][1] + f*(c[i][2] + f*c[i][3]));
+    d1[i] = c[i][1] + f*(2.0*c[i][2] + f*3.0*c[i][3]);
+    d2[i] = 2.0*c[i][2] + f*6.0*c[i][3];
+  }
+}
+
+//----------------------------------------------------------------------------
+static double vtkSplineTubeSpeed(const double c[3][4], double f) {
+  double p[3], d1[3], d2[3];
+  vtkSplineTubeEvaluate(c, f, p, d1, d2);
+  return vtkMath::Norm(d1);
+}
+
+//----------------------------------------------------------------------------
+// Arc length of a segment between parameters f0 and f1.
+static double vtkSplineTubeLength(const double c[3][4], double f0, double f1) {
+  double half = 0.5*(f1 - f0), mid = 0.5*(f0 + f1);
+  double length = 0.0;
+  for (int i = 0; i < 5; i++) {
+    length += GAUSS_WEIGHTS[i]*vtkSplineTubeSpeed(c, mid + half*GAUSS_NODES[i]);
+  }
+  return length*half;
+}
+
+//----------------------------------------------------------------------------
+// Unit tangent. Where the derivative vanishes, as it does at the ends of
+// a spline with zero end derivatives, the second derivative gives the
+// direction of the curve.
+static void vtkSplineTubeTangent(const double c[3][4], double f, double t[3]) {
+  double p[3], d1[3], d2[3];
+  vtkSplineTubeEvaluate(c, f, p, d1, d2);
+  double speed = vtkMath::Norm(d1);
+  double scale = vtkMath::Norm(d2);
+  if (speed > 1e-9*scale && speed > 0.0) {
+    for (int i = 0; i < 3; i++)
+      t[i] = d1[i] / speed;
+  } else if (scale > 0.0) {
+    double sign = f < 0.5 ? 1.0 : -1.0;
+    for (int i = 0; i < 3; i++)
+      t[i] = sign * d2[i] / scale;
+  } else {
+    t[0] = 1.0; t[1] = 0.0; t[2] = 0.0;
+  }
+}
+
+//----------------------------------------------------------------------------
+static double vtkSplineTubeCurvature(const double c[3][4], double f) {
+  double p[3], d1[3], d2[3], cross[3];
+  vtkSplineTubeEvaluate(c, f, p, d1, d2);
+  double speed = vtkMath::Norm(d1);
+  if (speed <= 0.0)
+    return 0.0;
+  vtkMath::Cross(d1, d2, cross);
+  return vtkMath::Norm(cross) / (speed*speed*speed);
+}
+
+//----------------------------------------------------------------------------
+static double vtkSplineTubeAngle(const double a[3], const double b[3]) {
+  double cross[3];
+  vtkMath::Cross(a, b, cross);
+  return atan2(vtkMath::Norm(cross), vtkMath::Dot(a, b));
+}
+
+//----------------------------------------------------------------------------
+// Two unit vectors perpendicular to n and to each other.
+static void vtkSplineTubePerpendiculars(const double n[3], double e1[3],
+                                        double e2[3]) {
+  double axis[3] = {0.0, 0.0, 0.0};
+  int smallest = 0;
+  for (int i = 1; i < 3; i++) {
+    if (fabs(n[i]) < fabs(n[smallest]))
+      smallest = i;
+  }
+  axis[smallest] = 1.0;
+  vtkMath::Cross(n, axis, e1);
+  vtkMath::Normalize(e1);
+  vtkMath::Cross(n, e1, e2);
+}
+
+//----------------------------------------------------------------------------
+// Appends the ends of the intervals in (f0,f1] to bounds, halving until
+// the tangent turns by at most maxAngle over an interval.
+static void vtkSplineTubeSubdivide(const double c[3][4], double f0, double f1,
+                                   const double t0[3], const double t1[3],
+                                   double maxAngle, int depth,
+                                   std::vector<double>& bounds) {
+  double fm = 0.5*(f0 + f1);
+  double tm[3];
+  vtkSplineTubeTangent(c, fm, tm);
+  double angle = vtkSplineTubeAngle(t0, tm) + vtkSplineTubeAngle(tm, t1);
+  if (angle > maxAngle && depth < MAX_SUBDIVISION_DEPTH) {
+    vtkSplineTubeSubdivide(c, f0, fm, t0, tm, maxAngle, depth+1, bounds);
+    vtkSplineTubeSubdivide(c, fm, f1, tm, t1, maxAngle, depth+1, bounds);
+  } else {
+    bounds.push_back(f1);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Parameter in [f0,f1] at arc length target from f0. Newton's method,
+// falling back to bisection when a step leaves the bracket.
+static double vtkSplineTubeParameterAtLength(const double c[3][4], double f0,
+                                             double f1, double target,
+                                             double length) {
+  if (length <= 0.0)
+    return f0;
+
+  double lo = f0, hi = f1;
+  double f = f0 + (f1 - f0)*(target/length);
+  for (int iteration = 0; iteration < 20; iteration++) {
+    double error = vtkSplineTubeLength(c, f0, f) - target;
+    if (fabs(error) <= 1e-12*length)
+      break;
+    if (error > 0.0)
+      hi = f;
+    else
+      lo = f;
+    double speed = vtkSplineTubeSpeed(c, f);
+    double next = speed > 0.0 ? f - error/speed : lo;
+    if (next <= lo || next >= hi)
+      next = 0.5*(lo + hi);
+    f = next;
+  }
+  return f;
+}
+
+//----------------------------------------------------------------------------
+vtkSplineTubeUniformPointSampler::vtkSplineTubeUniformPointSampler()
+{
+  this->Spline = NULL;
+  this->Capping = 1;
+  this->MaximumTurningAngle = 5.0;
+  this->ReuseTolerance = 1e-3;
+  this->PieceRadius = -1.0;
+  this->PieceSampleVolume = -1;
+  this->PieceCapping = -1;
+  this->PieceTurningAngle = -1.0;
+  this->PieceSeed = 0;
+  this->PieceClosed = 0;
+  this->CenterlineLength = 0.0;
+}
+
+//----------------------------------------------------------------------------
+vtkSplineTubeUniformPointSampler::~vtkSplineTubeUniformPointSampler()
+{
+  this->SetSpline(NULL);
+}
+
+//----------------------------------------------------------------------------
+void vtkSplineTubeUniformPointSampler::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Spline: " << this->Spline << "\n";
+  os << indent << "Capping: " << this->Capping << "\n";
+  os << indent << "MaximumTurningAngle: " << this->MaximumTurningAngle << "\n";
+  os << indent << "ReuseTolerance: " << this->ReuseTolerance << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkSplineTubeUniformPointSampler::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Spline) {
+    mTime = std::max(mTime, this->Spline->GetMTime());
+    if (this->Spline->GetPoints())
+      mTime = std::max(mTime, this->Spline->GetPoints()->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkSplineTubeUniformPointSampler::RequestData(
+  vtkInformation* vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed(inputVector),
+  vtkInformationVector* outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkPolyData *output = vtkPolyData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  output->Initialize();
+
+  this->UpdatePieces();
+  this->SurfaceArea = this->ComputeSurfaceArea();
+  this->Volume = this->ComputeVolume();
+
+  double measure = this->SampleVolume ? this->Volume : this->SurfaceArea;
+  int numPoints = this->NumberOfSamples;
+  if (!this->UseFixedNumberOfSamples)
+    numPoints = this->ComputeNumberOfSamples(measure, this->Density);
+  if (measure <= 0.0)
+    numPoints = 0;
+
+  this->AssignSamples(numPoints);
+
+  // Sample indices move between pieces from one update to the next, so
+  // the superclass cache does not apply; the pieces hold the samples.
+  this->InvalidateSampleCache();
+  this->GenerateSamplePoints(numPoints, output);
+
+  // Keep the newly computed samples of each piece.
+  vtkPoints *points = output->GetPoints();
+  for (size_t j = 0; j < this->Pieces.size(); j++) {
+    Piece& piece = this->Pieces[j];
+    vtkIdType stored = static_cast<vtkIdType>(piece.Points.size() / 3);
+    if (piece.NumberOfSamples <= stored)
+      continue;
+    piece.Points.resize(3*piece.NumberOfSamples);
+    for (vtkIdType k = stored; k < piece.NumberOfSamples; k++) {
+      double pt[3];
+      points->GetPoint(this->PieceOffsets[j] + k, pt);
+      for (int c = 0; c < 3; c++)
+        piece.Points[3*k + c] = static_cast<float>(pt[c]);
+    }
+  }
+
+  this->ComputedTime = this->GetMTime();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+double vtkSplineTubeUniformPointSampler::ComputeSurfaceArea() {
+  this->UpdatePieces();
+  double r = this->Radius;
+  double area = 2.0*vtkMath::Pi()*r*this->CenterlineLength;
+  if (this->Capping && !this->PieceClosed && this->CenterlineLength > 0.0)
+    area += 2.0*vtkMath::Pi()*r*r;
+  return area;
+}
+
+//----------------------------------------------------------------------------
+double vtkSplineTubeUniformPointSampler::ComputeVolume() {
+  this->UpdatePieces();
+  double r = this->Radius;
+  return vtkMath::Pi()*r*r*this->CenterlineLength;
+}
+
+//----------------------------------------------------------------------------
+int vtkSplineTubeUniformPointSampler::ComputeUniformResolution(int maximumPerSegment) {
+  this->UpdatePieces();
+
+  int numSegments = 0;
+  double step = 1.0;
+  for (size_t j = 0; j < this->Pieces.size(); j++) {
+    const Piece& piece = this->Pieces[j];
+    if (piece.IntervalBounds.empty())
+      continue;
+    numSegments++;
+
+    double width = piece.ParameterRange[1] - piece.ParameterRange[0];
+    double narrowest = 1.0;
+    for (size_t m = 1; m < piece.IntervalBounds.size(); m++) {
+      narrowest = std::min(narrowest, piece.IntervalBounds[m] - piece.IntervalBounds[m-1]);
+    }
+    narrowest = std::max(narrowest, 1.0 / maximumPerSegment);
+    step = std::min(step, width*narrowest);
+  }
+
+  if (numSegments == 0 || step <= 0.0)
+    return 1;
+  double resolution = ceil(1.0 / step);
+  return static_cast<int>(std::min(resolution,
+                                   static_cast<double>(maximumPerSegment)*numSegments));
+}
+
+//----------------------------------------------------------------------------
+void vtkSplineTubeUniformPointSampler::UpdatePieces() {
+  if (this->PieceTime.GetMTime() > this->GetMTime())
+    return;
+  this->PieceTime.Modified();
+
+  // Any change that moves every sample discards all pieces.
+  if (this->PieceRadius != this->Radius ||
+      this->PieceSampleVolume != this->SampleVolume ||
+      this->PieceCapping != this->Capping ||
+      this->PieceTurningAngle != this->MaximumTurningAngle ||
+      this->PieceSeed != this->Seed) {
+    this->Pieces.clear();
+    this->PieceRadius = this->Radius;
+    this->PieceSampleVolume = this->SampleVolume;
+    this->PieceCapping = this->Capping;
+    this->PieceTurningAngle = this->MaximumTurningAngle;
+    this->PieceSeed = this->Seed;
+  }
+
+  vtkPoints *controlPoints = this->Spline ? this->Spline->GetPoints() : NULL;
+  vtkIdType numControlPoints = controlPoints ? controlPoints->GetNumberOfPoints() : 0;
+  this->CenterlineLength = 0.0;
+  this->PieceClosed = this->Spline ? this->Spline->GetClosed() : 0;
+  if (numControlPoints < 2) {
+    this->Pieces.clear();
+    return;
+  }
+
+  // Spline parameter of each control point, the way vtkParametricSpline
+  // assigns them: the index, or the length of the control polygon up to
+  // the point. Closed splines have an extra segment back to the start.
+  int closed = this->PieceClosed;
+  vtkIdType numSegments = closed ? numControlPoints : numControlPoints - 1;
+  std::vector<double> knots(numSegments + 1, 0.0);
+  for (vtkIdType j = 1; j <= numSegments; j++) {
+    if (this->Spline->GetParameterizeByLength()) {
+      double p0[3], p1[3];
+      controlPoints->GetPoint(j-1, p0);
+      controlPoints->GetPoint(j % numControlPoints, p1);
+      knots[j] = knots[j-1] + sqrt(vtkMath::Distance2BetweenPoints(p0, p1));
+    } else {
+      knots[j] = static_cast<double>(j);
+    }
+  }
+  if (knots[numSegments] <= 0.0) {
+    this->Pieces.clear();
+    return;
+  }
+
+  std::vector<Piece> oldPieces;
+  oldPieces.swap(this->Pieces);
+  std::vector<Piece*> oldByStream(numSegments, static_cast<Piece*>(NULL));
+  Piece *oldStartCap = NULL, *oldEndCap = NULL;
+  for (size_t j = 0; j < oldPieces.size(); j++) {
+    vtkIdType stream = oldPieces[j].Stream;
+    if (stream == START_CAP)
+      oldStartCap = &oldPieces[j];
+    else if (stream == END_CAP)
+      oldEndCap = &oldPieces[j];
+    else if (stream < numSegments)
+      oldByStream[stream] = &oldPieces[j];
+  }
+
+  double twoPi = 2.0*vtkMath::Pi();
+  double r = this->Radius;
+  this->Pieces.reserve(numSegments + 2);
+  for (vtkIdType j = 0; j < numSegments; j++) {
+    // Each segment is a cubic; fit it through four points.
+    double y[4][3];
+    double u[3] = {0.0, 0.0, 0.0}, du[9];
+    for (int i = 0; i < 4; i++) {
+      double t = knots[j] + (knots[j+1] - knots[j])*i/3.0;
+      u[0] = t / knots[numSegments];
+      this->Spline->Evaluate(u, y[i], du);
+    }
+
+    Piece piece;
+    piece.Stream = j;
+    for (int c = 0; c < 3; c++) {
+      double d1 = y[1][c] - y[0][c];
+      double d2 = y[2][c] - 2.0*y[1][c] + y[0][c];
+      double d3 = y[3][c] - 3.0*y[2][c] + 3.0*y[1][c] - y[0][c];
+      piece.Coefficients[c][0] = y[0][c];
+      piece.Coefficients[c][1] = 3.0*(d1 - 0.5*d2 + d3/3.0);
+      piece.Coefficients[c][2] = 9.0*(0.5*d2 - 0.5*d3);
+      piece.Coefficients[c][3] = 27.0*(d3/6.0);
+    }
+    piece.ParameterRange[0] = knots[j] / knots[numSegments];
+    piece.ParameterRange[1] = knots[j+1] / knots[numSegments];
+
+    // Keep the old segment if no point of it moved by more than the
+    // tolerance.
+    Piece *old = oldByStream[j];
+    if (old && !old->IntervalBounds.empty()) {
+      double deviation2 = 0.0;
+      for (int c = 0; c < 3; c++) {
+        double bound = 0.0;
+        for (int i = 0; i < 4; i++)
+          bound += fabs(piece.Coefficients[c][i] - old->Coefficients[c][i]);
+        deviation2 += bound*bound;
+      }
+      if (sqrt(deviation2) <= this->ReuseTolerance) {
+        old->ParameterRange[0] = piece.ParameterRange[0];
+        old->ParameterRange[1] = piece.ParameterRange[1];
+        std::vector<float> points;
+        points.swap(old->Points);
+        this->Pieces.push_back(*old);
+        this->Pieces.back().Points.swap(points);
+        this->CenterlineLength += old->CumulativeLengths.back();
+        continue;
+      }
+    }
+
+    this->BuildSegment(piece);
+    double length = piece.CumulativeLengths.back();
+    piece.Measure = this->SampleVolume ? 0.5*twoPi*r*r*length : twoPi*r*length;
+    piece.NumberOfSamples = 0;
+    this->Pieces.push_back(piece);
+    this->CenterlineLength += length;
+  }
+
+  if (!this->Capping || this->SampleVolume || closed)
+    return;
+
+  // End disks, facing away from the tube.
+  for (int end = 0; end < 2; end++) {
+    const Piece& segment = this->Pieces[end ? numSegments-1 : 0];
+    double f = end ? 1.0 : 0.0;
+    double p[3], d1[3], d2[3], t[3];
+    vtkSplineTubeEvaluate(segment.Coefficients, f, p, d1, d2);
+    vtkSplineTubeTangent(segment.Coefficients, f, t);
+
+    Piece cap;
+    cap.Stream = end ? END_CAP : START_CAP;
+    for (int c = 0; c < 3; c++) {
+      cap.Coefficients[c][0] = p[c];
+      cap.Coefficients[c][1] = end ? t[c] : -t[c];
+      cap.Coefficients[c][2] = cap.Coefficients[c][3] = 0.0;
+    }
+    cap.ParameterRange[0] = cap.ParameterRange[1] = f;
+    cap.MaximumCurvature = 0.0;
+    cap.Measure = 0.5*twoPi*r*r;
+    cap.NumberOfSamples = 0;
+
+    Piece *old = end ? oldEndCap : oldStartCap;
+    if (old) {
+      double deviation2 = 0.0;
+      for (int c = 0; c < 3; c++) {
+        double bound = fabs(cap.Coefficients[c][0] - old->Coefficients[c][0]) +
+          r*fabs(cap.Coefficients[c][1] - old->Coefficients[c][1]);
+        deviation2 += bound*bound;
+      }
+      if (sqrt(deviation2) <= this->ReuseTolerance) {
+        std::vector<float> points;
+        points.swap(old->Points);
+        this->Pieces.push_back(*old);
+        this->Pieces.back().Points.swap(points);
+        continue;
+      }
+    }
+    this->Pieces.push_back(cap);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSplineTubeUniformPointSampler::BuildSegment(Piece& piece) {
+  const double (*c)[4] = piece.Coefficients;
+  double maxAngle = vtkMath::RadiansFromDegrees(this->MaximumTurningAngle);
+
+  double t0[3], t1[3];
+  vtkSplineTubeTangent(c, 0.0, t0);
+  vtkSplineTubeTangent(c, 1.0, t1);
+  piece.IntervalBounds.assign(1, 0.0);
+  vtkSplineTubeSubdivide(c, 0.0, 1.0, t0, t1, maxAngle, 0, piece.IntervalBounds);
+
+  // The curvature bound is taken at the ends, middle and quadrature
+  // nodes of every interval, with some headroom for the peaks between
+  // them.
+  size_t numIntervals = piece.IntervalBounds.size() - 1;
+  piece.CumulativeLengths.resize(numIntervals);
+  piece.MaximumCurvature = 0.0;
+  double length = 0.0;
+  for (size_t m = 0; m < numIntervals; m++) {
+    double f0 = piece.IntervalBounds[m], f1 = piece.IntervalBounds[m+1];
+    length += vtkSplineTubeLength(c, f0, f1);
+    piece.CumulativeLengths[m] = length;
+
+    double half = 0.5*(f1 - f0), mid = 0.5*(f0 + f1);
+    double kappa = std::max(vtkSplineTubeCurvature(c, f0),
+                            vtkSplineTubeCurvature(c, f1));
+    for (int i = 0; i < 5; i++) {
+      kappa = std::max(kappa, vtkSplineTubeCurvature(c, mid + half*GAUSS_NODES[i]));
+    }
+    piece.MaximumCurvature = std::max(piece.MaximumCurvature, 1.1*kappa);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSplineTubeUniformPointSampler::AssignSamples(vtkIdType numPoints) {
+  size_t numPieces = this->Pieces.size();
+  this->PieceOffsets.assign(numPieces + 1, 0);
+
+  double total = 0.0;
+  for (size_t j = 0; j < numPieces; j++)
+    total += this->Pieces[j].Measure;
+  if (total <= 0.0 || numPoints <= 0) {
+    for (size_t j = 0; j < numPieces; j++)
+      this->Pieces[j].NumberOfSamples = 0;
+    return;
+  }
+
+  // Largest remainder apportionment. A piece's share changes only when
+  // the measures change, and then by at most a sample or two for pieces
+  // that did not move.
+  std::vector<std::pair<double, size_t> > remainders(numPieces);
+  vtkIdType assigned = 0;
+  for (size_t j = 0; j < numPieces; j++) {
+    double share = numPoints * this->Pieces[j].Measure / total;
+    vtkIdType whole = static_cast<vtkIdType>(share);
+    this->Pieces[j].NumberOfSamples = whole;
+    assigned += whole;
+    remainders[j] = std::make_pair(-(share - whole), j);
+  }
+  std::sort(remainders.begin(), remainders.end());
+  for (size_t i = 0; assigned < numPoints && i < numPieces; i++, assigned++) {
+    this->Pieces[remainders[i].second].NumberOfSamples++;
+  }
+
+  for (size_t j = 0; j < numPieces; j++) {
+    this->PieceOffsets[j+1] = this->PieceOffsets[j] + this->Pieces[j].NumberOfSamples;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkSplineTubeUniformPointSampler::ComputeSamplePoint(vtkIdType sample,
+                                                          double pt[3]) {
+  size_t j = std::upper_bound(this->PieceOffsets.begin(), this->PieceOffsets.end(),
+                              sample) - this->PieceOffsets.begin() - 1;
+  const Piece& piece = this->Pieces[j];
+  vtkIdType k = sample - this->PieceOffsets[j];
+
+  if (3*k < static_cast<vtkIdType>(piece.Points.size())) {
+    for (int c = 0; c < 3; c++)
+      pt[c] = piece.Points[3*k + c];
+    return;
+  }
+
+  this->ComputePiecePoint(piece, k, pt);
+}
+
+//----------------------------------------------------------------------------
+void vtkSplineTubeUniformPointSampler::ComputePiecePoint(const Piece& piece,
+                                                         vtkIdType sample,
+                                                         double pt[3]) {
+  double twoPi = 2.0*vtkMath::Pi();
+  double r = this->Radius;
+  vtkTypeUInt32 words[4];
+
+  // Samples of different pieces use disjoint counters.
+  vtkIdType counter = (piece.Stream << 32) | (sample & 0xFFFFFFFF);
+
+  if (piece.Stream == START_CAP || piece.Stream == END_CAP) {
+    double center[3], normal[3], e1[3], e2[3];
+    for (int c = 0; c < 3; c++) {
+      center[c] = piece.Coefficients[c][0];
+      normal[c] = piece.Coefficients[c][1];
+    }
+    vtkSplineTubePerpendiculars(normal, e1, e2);
+
+    this->RandomWords(counter, 0, words);
+    double rho = r*sqrt(UniformFromWord(words[0]));
+    double theta = twoPi*UniformFromWord(words[1]);
+    for (int c = 0; c < 3; c++)
+      pt[c] = center[c] + rho*(cos(theta)*e1[c] + sin(theta)*e2[c]);
+    return;
+  }
+
+  // A point uniform in arc length along the centerline and angle around
+  // it, accepted with probability proportional to the area (volume)
+  // scale factor 1 - rho k.n, where k is the curvature vector and n the
+  // direction from the centerline.
+  const double (*c)[4] = piece.Coefficients;
+  double length = piece.CumulativeLengths.back();
+  double bound = 1.0 + r*piece.MaximumCurvature;
+  for (vtkTypeUInt32 block = 0; block < MAX_REJECTION_BLOCKS; block++) {
+    this->RandomWords(counter, block, words);
+
+    double s = UniformFromWord(words[0])*length;
+    size_t m = std::upper_bound(piece.CumulativeLengths.begin(),
+                                piece.CumulativeLengths.end(), s) -
+      piece.CumulativeLengths.begin();
+    if (m >= piece.CumulativeLengths.size())
+      m = piece.CumulativeLengths.size() - 1;
+    double s0 = m > 0 ? piece.CumulativeLengths[m-1] : 0.0;
+    double f = vtkSplineTubeParameterAtLength
+      (c, piece.IntervalBounds[m], piece.IntervalBounds[m+1], s - s0,
+       piece.CumulativeLengths[m] - s0);
+
+    double p[3], d1[3], d2[3], t[3], e1[3], e2[3];
+    vtkSplineTubeEvaluate(c, f, p, d1, d2);
+    vtkSplineTubeTangent(c, f, t);
+    vtkSplineTubePerpendiculars(t, e1, e2);
+
+    double speed2 = vtkMath::Dot(d1, d1);
+    double along = vtkMath::Dot(d2, t);
+    double curvature[3] = {0.0, 0.0, 0.0};
+    if (speed2 > 0.0) {
+      for (int i = 0; i < 3; i++)
+        curvature[i] = (d2[i] - along*t[i]) / speed2;
+    }
+
+    double theta = twoPi*UniformFromWord(words[1]);
+    double rho = this->SampleVolume ? r*sqrt(UniformFromWord(words[2])) : r;
+    double n[3];
+    for (int i = 0; i < 3; i++) {
+      n[i] = cos(theta)*e1[i] + sin(theta)*e2[i];
+      pt[i] = p[i] + rho*n[i];
+    }
+
+    double scale = 1.0 - rho*vtkMath::Dot(curvature, n);
+    if (UniformFromWord(words[3])*bound <= scale)
+      break;
+  }
+}
@@ -0,0 +1,196 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkSplineTubeUniformPointSampler.h,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkSplineTubeUniformPointSampler - Uniform point sampling of a tube around a spline
+// .SECTION Description
+
+// vtkSplineTubeUniformPointSampler creates a uniform sampling of points
+// on the surface or in the interior of a tube of constant Radius around
+// a vtkParametricSpline, directly from the spline, without tessellating
+// it. The tube is the one vtkTubeFilter approximates; with Capping on,
+// the surface includes the two end disks.
+//
+// Each segment of the spline between two control points is split into
+// intervals over which the tangent turns by at most MaximumTurningAngle,
+// so that strongly curved parts get finer intervals. Points are placed
+// uniformly in arc length along the centerline and accepted with
+// probability proportional to the area (or volume) scale factor of the
+// tube at that point, which accounts for the inside of bends being
+// shorter than the outside. The tube must be thinner than its radius of
+// curvature, as it must for vtkTubeFilter.
+//
+// The samples of each segment are kept from one update to the next and
+// depend only on the seed and on that segment. When a control point
+// moves, only segments whose centerline moved by more than
+// ReuseTolerance are sampled again; the others at most gain or lose a
+// point as the total is shared out among segments. The Shape and the
+// shape parameters of vtkAnalyticUniformPointSampler other than Radius
+// are ignored, and samples are always independent random numbers, so
+// LowDiscrepancy is ignored as well. Samples are not stored on disk.
+
+#ifndef __vtkSplineTubeUniformPointSampler_h
+#define __vtkSplineTubeUniformPointSampler_h
+
+#include "vtkAnalyticUniformPointSampler.h"
+
+#include "vtkParametricSpline.h"
+
+#include <vector>
+
+class vtkSplineTubeUniformPointSampler : public vtkAnalyticUniformPointSampler
+{
+public:
+  static vtkSplineTubeUniformPointSampler *New();
+  vtkTypeMacro(vtkSplineTubeUniformPointSampler,vtkAnalyticUniformPointSampler);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Centerline of the tube.
+  vtkSetObjectMacro(Spline, vtkParametricSpline);
+  vtkGetObjectMacro(Spline, vtkParametricSpline);
+
+  // Description:
+  // Include the end disks in the surface. On by default.
+  vtkSetMacro(Capping, int);
+  vtkGetMacro(Capping, int);
+  vtkBooleanMacro(Capping, int);
+
+  // Description:
+  // Largest angle, in degrees, by which the tangent may turn over one
+  // interval of the centerline.
+  vtkSetClampMacro(MaximumTurningAngle, double, 0.1, 90.0);
+  vtkGetMacro(MaximumTurningAngle, double);
+
+  // Description:
+  // Segments whose centerline moved by less than this distance since
+  // they were sampled keep their samples.
+  vtkSetClampMacro(ReuseTolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(ReuseTolerance, double);
+
+  // Description:
+  // Surface area and volume of the tube from the current spline.
+  virtual double ComputeSurfaceArea();
+  virtual double ComputeVolume();
+
+  // Description:
+  // Number of evenly spaced parameter steps a vtkParametricFunctionSource
+  // needs along the whole spline so that no step spans more than one
+  // interval, i.e. so that no step turns by more than
+  // MaximumTurningAngle. Limited to maximumPerSegment steps per segment.
+  int ComputeUniformResolution(int maximumPerSegment);
+
+  // Description:
+  // Include the spline and its points in the modification time.
+  vtkMTimeType GetMTime();
+
+protected:
+  vtkSplineTubeUniformPointSampler();
+  virtual ~vtkSplineTubeUniformPointSampler();
+
+  vtkParametricSpline *Spline;
+  int                  Capping;
+  double               MaximumTurningAngle;
+  double               ReuseTolerance;
+
+  // Description:
+  // A spline segment or an end cap, with the samples computed for it.
+  struct Piece
+  {
+    // Random stream of the piece's samples: the segment index, or
+    // START_CAP or END_CAP.
+    vtkIdType Stream;
+
+    // Cubic coefficients of the segment in its local parameter in
+    // [0,1], by coordinate and power. For caps, the center and the
+    // outward normal in the first two columns.
+    double Coefficients[3][4];
+
+    // Range of the spline parameter the segment spans.
+    double ParameterRange[2];
+
+    // Local parameter at the ends of the intervals and arc length from
+    // the start of the segment to the end of each interval.
+    std::vector<double> IntervalBounds;
+    std::vector<double> CumulativeLengths;
+
+    // Largest curvature of the centerline over the segment.
+    double MaximumCurvature;
+
+    // Area or volume of the piece.
+    double Measure;
+
+    // Number of samples assigned to the piece by the last update and
+    // the samples computed so far, as x, y, z triples.
+    vtkIdType          NumberOfSamples;
+    std::vector<float> Points;
+  };
+
+  enum {
+    START_CAP = 0x7FFFFFFE,
+    END_CAP   = 0x7FFFFFFF
+  };
+
+  std::vector<Piece>     Pieces;
+  std::vector<vtkIdType> PieceOffsets;
+
+  // Description:
+  // Settings the pieces were built with. Changing any of them
+  // discards every piece.
+  double       PieceRadius;
+  int          PieceSampleVolume;
+  int          PieceCapping;
+  double       PieceTurningAngle;
+  unsigned int PieceSeed;
+  vtkTimeStamp PieceTime;
+
+  // Description:
+  // Whether the spline was closed and the length of its centerline as
+  // of the last UpdatePieces().
+  int    PieceClosed;
+  double CenterlineLength;
+
+  // Description:
+  // Rebuilds the pieces that changed since the last call.
+  void UpdatePieces();
+
+  // Description:
+  // Splits a segment into intervals and computes its length and
+  // curvature bound.
+  void BuildSegment(Piece& piece);
+
+  // Description:
+  // Shares out numPoints samples among the pieces in proportion to
+  // their measure.
+  void AssignSamples(vtkIdType numPoints);
+
+  // Description:
+  // Computes sample number sample of a piece.
+  void ComputePiecePoint(const Piece& piece, vtkIdType sample, double pt[3]);
+
+  // Description:
+  // Computes sample point number sample, reusing stored piece samples.
+  virtual void ComputeSamplePoint(vtkIdType sample, double pt[3]);
+
+  // Description:
+  // Usual data generation method.
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+private:
+  vtkSplineTubeUniformPointSampler(const vtkSplineTubeUniformPointSampler&);  // Not implemented.
+  void operator=(const vtkSplineTubeUniformPointSampler&);  // Not implemented.
+};
+
+#endif
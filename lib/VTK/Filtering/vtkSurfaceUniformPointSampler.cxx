@@ -19,14 +19,12 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
-#include "vtkMinimalStandardRandomSequence.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkTriangle.h"
 
 #include <cstdlib>
-#include <ctime>
 
 vtkStandardNewMacro(vtkSurfaceUniformPointSampler);
 
@@ -39,15 +37,11 @@ vtkSurfaceUniformPointSampler::vtkSurfaceUniformPointSampler()
   this->SetNumberOfOutputPorts(1);
   this->Density = 0.0;
   this->SurfaceArea = 0.0;
-  this->PolygonAreas = vtkDoubleArray::New();
-  this->Register(this->PolygonAreas);
 }
 
 //----------------------------------------------------------------------------
 vtkSurfaceUniformPointSampler::~vtkSurfaceUniformPointSampler()
 {
-  this->UnRegister(this->PolygonAreas);
-  this->PolygonAreas = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -64,9 +58,6 @@ int vtkSurfaceUniformPointSampler::RequestData(
   vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
 {
-  // Set the RNG seed
-  this->Random->SetSeed( time( NULL ) );
-
   // get the info objects
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
@@ -76,12 +67,14 @@ int vtkSurfaceUniformPointSampler::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  // Clean up the weights and output object.
-  this->PolygonAreas->Initialize();
   output->Initialize();
 
-  // Calculate weights for each polygon.
-  this->ComputePolygonAreas(input);
+  // Calculate weights for each polygon. These depend only on the mesh,
+  // so they are reused until the input changes.
+  if (input->GetMTime() > this->AliasTableTime.GetMTime() ||
+      this->TriangleVertices.empty()) {
+    this->ComputePolygonAreas(input);
+  }
 
   // Create the sample points
   this->CreateSamplePoints(input, output);
@@ -96,23 +89,35 @@ void vtkSurfaceUniformPointSampler::ComputePolygonAreas(vtkPolyData* input) {
   vtkIdType npts, *pts;
   vtkCellArray* triangles = input->GetPolys();
 
-  // Invariant: at the completion of each iteration, the current polygon
-  // is associated with the total area computed so far.
-  // This will be used to randomly select a polygon for point sampling using
-  // an uniform distribution.
+  std::vector<double> areas;
+  areas.reserve(triangles->GetNumberOfCells());
+  this->TriangleVertices.clear();
+  this->TriangleVertices.reserve(9*triangles->GetNumberOfCells());
+
+  // Cache the vertices of each triangle alongside its area so that
+  // sampling never touches the cell structure of the input.
   this->SurfaceArea = 0.0;
   for (triangles->InitTraversal(); triangles->GetNextCell(npts, pts); ) {
-    double p1[3], p2[3], p3[3];
+    double p[3][3];
     if (npts == 3) {
-      input->GetPoint(pts[0], p1);
-      input->GetPoint(pts[1], p2);
-      input->GetPoint(pts[2], p3);
-      this->SurfaceArea += vtkTriangle::TriangleArea(p1, p2, p3);
-      this->PolygonAreas->InsertNextValue(this->SurfaceArea);
+      input->GetPoint(pts[0], p[0]);
+      input->GetPoint(pts[1], p[1]);
+      input->GetPoint(pts[2], p[2]);
+      double area = vtkTriangle::TriangleArea(p[0], p[1], p[2]);
+      this->SurfaceArea += area;
+      areas.push_back(area);
+      this->TriangleVertices.insert(this->TriangleVertices.end(), &p[0][0], &p[0][0] + 9);
     } else {
       vtkDebugMacro(<< "npts != 3");
     }
   }
+
+  this->BuildAliasTable(areas);
+  if (!this->TriangleVertices.empty()) {
+    this->HashDistribution(&this->TriangleVertices[0],
+                           this->TriangleVertices.size()*sizeof(double));
+  }
+  this->AliasTableTime.Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -122,66 +127,35 @@ void vtkSurfaceUniformPointSampler::CreateSamplePoints(vtkPolyData *input,
   int numPoints = this->NumberOfSamples;
   if (!this->UseFixedNumberOfSamples)
     numPoints = this->ComputeNumberOfSamples(this->SurfaceArea, this->Density);
-  output->Allocate(numPoints, 10);
-  vtkPoints *newPoints = vtkPoints::New();
-  newPoints->SetNumberOfPoints(numPoints);
-
-  // Insert the appropriate number of points.
-  for (int j = 0; j < numPoints; j++) {
-
-    // Get a random number. Probably doesn't matter how good it is.
-    this->Random->Next();
-    double rand = this->Random->GetValue() * this->SurfaceArea;
-
-    // Map this number to a polygon index via a binary search.
-    vtkIdType polygonIndex = -1;    
-    int start = 0;
-    int finish = this->PolygonAreas->GetNumberOfTuples() - 1;
-    while (finish - start > 1) {
-      int mid = ((finish - start + 1) / 2) + start;
-      double weight = this->PolygonAreas->GetTuple(mid)[0];
-      rand <= weight ? finish = mid : start = mid;
-    }
+  if (this->AliasProbability.empty())
+    numPoints = 0;
 
-    // Final decision.
-    if (rand <= this->PolygonAreas->GetTuple(start)[0])
-      polygonIndex = start;
-    else
-      polygonIndex = finish;
-
-    // Get the polygon points and compute the new point to insert
-    vtkTriangle *triangle = vtkTriangle::SafeDownCast(input->GetCell(polygonIndex));
-    if (!triangle) {
-      vtkErrorMacro(<< "Could not downcast polygon with " << input->GetCell(polygonIndex)->GetNumberOfPoints() << " points to vtkTriangle");
-      continue;
-    }
+  this->GenerateSamplePoints(numPoints, output);
+}
 
-    double randomPoint[3];
-    this->RandomTrianglePoint(triangle, input, randomPoint);
+//----------------------------------------------------------------------------
+void vtkSurfaceUniformPointSampler::ComputeSamplePoint(vtkIdType sample,
+                                                       double pt[3]) {
+  double u[3];
+  this->SampleUniforms(sample, 3, u);
 
-    newPoints->InsertPoint(j, randomPoint);
-    //output->InsertNextCell(VTK_VERTEX, 1, &j);
-    vtkIdType id = static_cast<vtkIdType>(j);
-    output->InsertNextCell(static_cast<int>(VTK_VERTEX), 1, &id);
-  }
+  // Pick a triangle with probability proportional to its area.
+  vtkIdType triangleIndex = this->SampleCell(u[0]);
 
-  output->SetPoints(newPoints);
-  newPoints->Delete();
+  const double *p = &this->TriangleVertices[9*triangleIndex];
+  this->RandomTrianglePoint(p, p+3, p+6, u+1, pt);
 }
 
 //----------------------------------------------------------------------------
-void vtkSurfaceUniformPointSampler::RandomTrianglePoint(vtkTriangle *triangle, 
-                                                 vtkPolyData *polyData, 
+void vtkSurfaceUniformPointSampler::RandomTrianglePoint(const double *p1,
+                                                 const double *p2,
+                                                 const double *p3,
+                                                 const double random[2],
                                                  double *pt) {
   // Parameterize two edges u = p3-p1, v = p2-p1 by value t in range
   // [0,1]. We compute the inverted function of the area of the triangle
   // formed by u(t), v(t) to map a uniform random sample to the CDF
   // as determined by the triangle area.
-  double p1[3], p2[3], p3[3];
-  polyData->GetPoint(triangle->GetPointId(0), p1);
-  polyData->GetPoint(triangle->GetPointId(1), p2);
-  polyData->GetPoint(triangle->GetPointId(2), p3);
-
   double ux = p3[0] - p1[0];
   double uy = p3[1] - p1[1];
   double uz = p3[2] - p1[2];
@@ -189,8 +163,7 @@ void vtkSurfaceUniformPointSampler::RandomTrianglePoint(vtkTriangle *triangle,
   double vy = p2[1] - p1[1];
   double vz = p2[2] - p1[2];
 
-  this->Random->Next();
-  double t = sqrt( this->Random->GetValue() );
+  double t = sqrt( random[0] );
   
   // Now that we know t, get a random point on the line
   // connecting edges u and v.
@@ -201,8 +174,7 @@ void vtkSurfaceUniformPointSampler::RandomTrianglePoint(vtkTriangle *triangle,
   double vty = vy*t + p1[1];
   double vtz = vz*t + p1[2];
 
-  this->Random->Next();
-  double s = this->Random->GetValue();
+  double s = random[1];
 
   pt[0] = (utx*(1.0-s)) + (vtx*s);
   pt[1] = (uty*(1.0-s)) + (vty*s);
@@ -46,16 +46,17 @@ protected:
   virtual ~vtkSurfaceUniformPointSampler();
 
   // Description:
-  // Weights assigned to each polygon in the input data based on area. Element in 
-  // this array sum to 1.0.
-  vtkDoubleArray *PolygonAreas;
+  // Vertex coordinates of each triangle in the input, nine values per
+  // triangle, in the same order as the alias table.
+  std::vector<double> TriangleVertices;
 
   // Description:
   // Surface area of the polygonal data.
   double SurfaceArea;
 
   // Description:
-  // Computes the surface weights of polygons in the input data.
+  // Computes the areas of triangles in the input data, caches their
+  // vertices, and builds the alias table used to pick triangles.
   void ComputePolygonAreas(vtkPolyData* input);
 
   // Description:
@@ -64,8 +65,15 @@ protected:
   void CreateSamplePoints(vtkPolyData *input, vtkPolyData *output);
 
   // Description:
-  // Given a triangle, creates a random point using simplex point picking.
-  void RandomTrianglePoint(vtkTriangle *triangle, vtkPolyData *polyData, double *pt);
+  // Computes sample point number sample.
+  virtual void ComputeSamplePoint(vtkIdType sample, double pt[3]);
+
+  // Description:
+  // Given triangle vertices and two uniform random numbers, creates a
+  // random point using simplex point picking.
+  void RandomTrianglePoint(const double *p1, const double *p2,
+                           const double *p3, const double random[2],
+                           double *pt);
 
   // Description:
   // Usual data generation method.
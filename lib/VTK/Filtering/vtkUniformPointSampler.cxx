@@ -16,14 +16,100 @@
 
 #include "vtkCellArray.h"
 #include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
-#include "vtkMinimalStandardRandomSequence.h"
 #include "vtkObjectFactory.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSOADataArrayTemplate.h"
 #include "vtkTriangle.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+//----------------------------------------------------------------------------
+struct vtkUniformPointSamplerThreadInfo
+{
+  vtkUniformPointSampler *Sampler;
+  vtkIdType               FirstSample;
+  vtkIdType               NumberOfSamples;
+
+  // First x, y and z coordinate and distance between consecutive points,
+  // so that interleaved and structure-of-arrays layouts share one loop.
+  float                  *Coordinates[3];
+  int                     Stride;
+};
+
+//----------------------------------------------------------------------------
+// Gets pointers to the first x, y and z coordinates of points created by
+// GenerateSamplePoints() and the distance between consecutive points.
+static int vtkUniformPointSamplerGetCoordinates(vtkPoints *points, int compact,
+                                                float *coordinates[3]) {
+  if (compact) {
+    vtkSOADataArrayTemplate<float> *coords =
+      static_cast<vtkSOADataArrayTemplate<float> *>(points->GetData());
+    for (int c = 0; c < 3; c++) {
+      coordinates[c] = coords->GetComponentArrayPointer(c);
+    }
+    return 1;
+  }
+
+  float *coords = vtkFloatArray::SafeDownCast(points->GetData())->GetPointer(0);
+  for (int c = 0; c < 3; c++) {
+    coordinates[c] = coords + c;
+  }
+  return 3;
+}
+
+//----------------------------------------------------------------------------
+// Cache directory for samplers that do not set one.
+static std::string vtkUniformPointSamplerGlobalCacheDirectory;
+
+// Identifies sample cache files. Change the version when the way samples
+// are computed from the random numbers changes, so that old files are no
+// longer used.
+static const char vtkUniformPointSamplerCacheMagic[8] =
+  {'M', 'S', 'I', 'M', 'S', 'M', 'P', '1'};
+
+//----------------------------------------------------------------------------
+// Degree, polynomial coefficients and initial direction numbers of the
+// primitive polynomials for Sobol dimensions 2 through 7 (Joe and Kuo).
+// The first dimension is the van der Corput sequence.
+static const int vtkUniformPointSamplerSobolDegree[] = {1, 2, 3, 3, 4, 4};
+static const int vtkUniformPointSamplerSobolCoefficients[] = {0, 1, 1, 2, 1, 4};
+static const int vtkUniformPointSamplerSobolInitial[][4] = {
+  {1}, {1, 3}, {1, 3, 1}, {1, 1, 1}, {1, 1, 3, 3}, {1, 3, 5, 13}
+};
+
+static void vtkUniformPointSamplerInitializeSobol(vtkTypeUInt32 directions[][32],
+                                                  int dimensions) {
+  for (int k = 0; k < 32; k++) {
+    directions[0][k] = 1u << (31 - k);
+  }
+
+  for (int d = 1; d < dimensions; d++) {
+    int s = vtkUniformPointSamplerSobolDegree[d-1];
+    int a = vtkUniformPointSamplerSobolCoefficients[d-1];
+    vtkTypeUInt32 *v = directions[d];
+    for (int k = 0; k < s; k++) {
+      v[k] = static_cast<vtkTypeUInt32>(vtkUniformPointSamplerSobolInitial[d-1][k]) << (31 - k);
+    }
+    for (int k = s; k < 32; k++) {
+      v[k] = v[k-s] ^ (v[k-s] >> s);
+      for (int j = 1; j < s; j++) {
+        if ((a >> (s - 1 - j)) & 1) {
+          v[k] ^= v[k-j];
+        }
+      }
+    }
+  }
+}
 
 //----------------------------------------------------------------------------
 vtkUniformPointSampler::vtkUniformPointSampler()
@@ -36,17 +122,506 @@ vtkUniformPointSampler::vtkUniformPointSampler()
   this->UseFixedNumberOfSamples = 0;
   this->NumberOfSamples = 0;
   this->SurfaceArea = 0.0;
-  this->Random = vtkSmartPointer< vtkMinimalStandardRandomSequence >::New();
+  this->Seed = 0;
+  this->CompactOutput = 0;
+  this->LowDiscrepancy = 0;
+  vtkUniformPointSamplerInitializeSobol(this->SobolDirections, MAX_SAMPLE_DIMENSIONS);
+  for (int d = 0; d < MAX_SAMPLE_DIMENSIONS; d++) {
+    this->SobolShift[d] = 0;
+  }
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+  this->SampleCacheSeed = 0;
+  this->SampleCacheCompact = 0;
+  this->SampleCacheLowDiscrepancy = 0;
+  this->DistributionHash = vtkCacheFileUtilities::HashBytes(NULL, 0);
+  this->CacheDirectory = NULL;
+  this->SampleCacheFileCount = -1;
 }
 
 //----------------------------------------------------------------------------
 vtkUniformPointSampler::~vtkUniformPointSampler()
 {
+  if (this->Threader)
+    {
+    this->Threader->Delete();
+    }
+  this->SetCacheDirectory(NULL);
 }
 
 //----------------------------------------------------------------------------
 void vtkUniformPointSampler::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Seed: " << this->Seed << "\n";
+  os << indent << "Compact Output: " << this->CompactOutput << "\n";
+  os << indent << "Low Discrepancy: " << this->LowDiscrepancy << "\n";
+  os << indent << "Number Of Threads: " << this->NumberOfThreads << "\n";
+  os << indent << "Cache Directory: "
+     << (this->CacheDirectory ? this->CacheDirectory : "(none)") << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkUniformPointSampler::SetGlobalCacheDirectory(const char *directory) {
+  vtkUniformPointSamplerGlobalCacheDirectory = directory ? directory : "";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkUniformPointSampler::GetGlobalCacheDirectory() {
+  if (vtkUniformPointSamplerGlobalCacheDirectory.empty())
+    return NULL;
+  return vtkUniformPointSamplerGlobalCacheDirectory.c_str();
+}
+
+//----------------------------------------------------------------------------
+void vtkUniformPointSampler::SetCacheSizeLimit(vtkTypeInt64 bytes) {
+  vtkCacheFileUtilities::SetCacheSizeLimit(bytes);
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkUniformPointSampler::GetCacheSizeLimit() {
+  return vtkCacheFileUtilities::GetCacheSizeLimit();
+}
+
+//----------------------------------------------------------------------------
+void vtkUniformPointSampler::BuildAliasTable(const std::vector<double>& weights) {
+  this->InvalidateSampleCache();
+  this->DistributionHash = vtkCacheFileUtilities::HashBytes(NULL, 0);
+  if (!weights.empty()) {
+    this->HashDistribution(&weights[0], weights.size()*sizeof(double));
+  }
+
+  vtkIdType n = static_cast<vtkIdType>(weights.size());
+  this->AliasProbability.assign(n, 1.0);
+  this->AliasIndex.resize(n);
+  for (vtkIdType i = 0; i < n; i++) {
+    this->AliasIndex[i] = i;
+  }
+
+  double total = 0.0;
+  for (vtkIdType i = 0; i < n; i++) {
+    if (weights[i] > 0.0) {
+      total += weights[i];
+    }
+  }
+  if (n == 0 || total <= 0.0) {
+    this->CumulativeWeights.clear();
+    return;
+  }
+
+  this->CumulativeWeights.resize(n);
+  double sum = 0.0;
+  for (vtkIdType i = 0; i < n; i++) {
+    if (weights[i] > 0.0) {
+      sum += weights[i];
+    }
+    this->CumulativeWeights[i] = sum / total;
+  }
+
+  // Vose's method: pair each under-full bin with an over-full bin that
+  // donates the remainder of its probability.
+  std::vector<double> scaled(n);
+  std::vector<vtkIdType> small, large;
+  for (vtkIdType i = 0; i < n; i++) {
+    scaled[i] = weights[i] > 0.0 ? weights[i] * n / total : 0.0;
+    if (scaled[i] < 1.0) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+
+  while (!small.empty() && !large.empty()) {
+    vtkIdType s = small.back();
+    small.pop_back();
+    vtkIdType l = large.back();
+    large.pop_back();
+
+    this->AliasProbability[s] = scaled[s];
+    this->AliasIndex[s] = l;
+
+    scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+    if (scaled[l] < 1.0) {
+      small.push_back(l);
+    } else {
+      large.push_back(l);
+    }
+  }
+
+  // Leftovers are full up to round-off.
+  for (size_t i = 0; i < large.size(); i++) {
+    this->AliasProbability[large[i]] = 1.0;
+  }
+  for (size_t i = 0; i < small.size(); i++) {
+    this->AliasProbability[small[i]] = 1.0;
+  }
 }
 
+//----------------------------------------------------------------------------
+vtkIdType vtkUniformPointSampler::SampleCumulativeTable(double random) {
+  vtkIdType n = static_cast<vtkIdType>(this->CumulativeWeights.size());
+  vtkIdType i = static_cast<vtkIdType>
+    (std::upper_bound(this->CumulativeWeights.begin(),
+                      this->CumulativeWeights.end(), random) -
+     this->CumulativeWeights.begin());
+  if (i >= n) {
+    // Round-off in the last cumulative weight; take the last cell that
+    // can be sampled.
+    i = n - 1;
+    while (i > 0 && this->CumulativeWeights[i] == this->CumulativeWeights[i-1]) {
+      i--;
+    }
+  }
+  return i;
+}
+
+//----------------------------------------------------------------------------
+void vtkUniformPointSampler::InvalidateSampleCache() {
+  this->SampleCache = NULL;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkUniformPointSampler::GetSampleCacheFileName() {
+  if (this->Seed != 0)
+    return std::string();
+
+  const char *directory = this->CacheDirectory;
+  if (!directory || directory[0] == '\0')
+    directory = GetGlobalCacheDirectory();
+  if (!directory)
+    return std::string();
+
+  char name[256];
+  sprintf(name, "%s-%016llx-%u-%d.samples", this->GetClassName(),
+          static_cast<unsigned long long>(this->DistributionHash),
+          this->Seed, this->LowDiscrepancy ? 1 : 0);
+
+  std::string fileName(directory);
+  fileName.append("/");
+  fileName.append(name);
+  return fileName;
+}
+
+//----------------------------------------------------------------------------
+// Cache files hold the magic string, the number of points as a 64-bit
+// integer, and the points as interleaved single-precision coordinates,
+// all in native byte order.
+vtkPoints* vtkUniformPointSampler::ReadSampleCacheFile(const char *fileName) {
+  std::ifstream file(fileName, std::ios::in | std::ios::binary);
+  if (!file)
+    return NULL;
+
+  char magic[8];
+  vtkTypeInt64 count = 0;
+  file.read(magic, 8);
+  file.read(reinterpret_cast<char *>(&count), sizeof(count));
+  if (!file || memcmp(magic, vtkUniformPointSamplerCacheMagic, 8) != 0 ||
+      count < 0) {
+    return NULL;
+  }
+
+  // Check the size before allocating so a damaged header does not
+  // trigger a huge allocation.
+  std::streampos dataStart = file.tellg();
+  file.seekg(0, std::ios::end);
+  std::streampos dataEnd = file.tellg();
+  if (static_cast<vtkTypeInt64>(dataEnd - dataStart) !=
+      count * 3 * static_cast<vtkTypeInt64>(sizeof(float))) {
+    return NULL;
+  }
+  file.seekg(dataStart);
+
+  vtkPoints *points = vtkPoints::New(VTK_FLOAT);
+  points->SetNumberOfPoints(static_cast<vtkIdType>(count));
+  if (count > 0) {
+    float *coords = vtkFloatArray::SafeDownCast(points->GetData())->GetPointer(0);
+    file.read(reinterpret_cast<char *>(coords), count*3*sizeof(float));
+    if (!file) {
+      points->Delete();
+      return NULL;
+    }
+  }
+
+  return points;
+}
+
+//----------------------------------------------------------------------------
+bool vtkUniformPointSampler::WriteSampleCacheFile(const char *fileName,
+                                                  vtkPoints *points,
+                                                  int compact) {
+  std::string directory = vtksys::SystemTools::GetFilenamePath(fileName);
+  if (!directory.empty() && !vtksys::SystemTools::MakeDirectory(directory.c_str()))
+    return false;
+
+  std::string tempName(fileName);
+  char suffix[64];
+  sprintf(suffix, ".%p.tmp", static_cast<void *>(points));
+  tempName.append(suffix);
+
+  std::ofstream file(tempName.c_str(), std::ios::out | std::ios::binary);
+  if (!file)
+    return false;
+
+  vtkTypeInt64 count = points->GetNumberOfPoints();
+  file.write(vtkUniformPointSamplerCacheMagic, 8);
+  file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+
+  float *coords[3];
+  int stride = vtkUniformPointSamplerGetCoordinates(points, compact, coords);
+  if (stride == 3) {
+    file.write(reinterpret_cast<const char *>(coords[0]), count*3*sizeof(float));
+  } else {
+    std::vector<float> buffer;
+    const vtkIdType chunk = 65536;
+    for (vtkIdType first = 0; first < count; first += chunk) {
+      vtkIdType n = std::min(chunk, static_cast<vtkIdType>(count) - first);
+      buffer.resize(3*n);
+      for (vtkIdType i = 0; i < n; i++) {
+        for (int c = 0; c < 3; c++) {
+          buffer[3*i + c] = coords[c][(first + i)*stride];
+        }
+      }
+      file.write(reinterpret_cast<const char *>(&buffer[0]), 3*n*sizeof(float));
+    }
+  }
+  file.close();
+  if (!file) {
+    remove(tempName.c_str());
+    return false;
+  }
+
+  // rename() does not replace existing files on every platform.
+  remove(fileName);
+  if (rename(tempName.c_str(), fileName) != 0) {
+    remove(tempName.c_str());
+    return false;
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkUniformPointSampler::GenerateRandomWords(unsigned int seed,
+                                                 vtkIdType counter,
+                                                 vtkTypeUInt32 block,
+                                                 vtkTypeUInt32 words[4]) {
+  vtkTypeUInt64 count = static_cast<vtkTypeUInt64>(counter);
+  words[0] = static_cast<vtkTypeUInt32>(count);
+  words[1] = static_cast<vtkTypeUInt32>(count >> 32);
+  words[2] = block;
+  words[3] = 0;
+
+  vtkTypeUInt32 key0 = static_cast<vtkTypeUInt32>(seed);
+  vtkTypeUInt32 key1 = 0;
+
+  for (int round = 0; round < 10; round++) {
+    vtkTypeUInt64 product0 = static_cast<vtkTypeUInt64>(0xD2511F53u) * words[0];
+    vtkTypeUInt64 product1 = static_cast<vtkTypeUInt64>(0xCD9E8D57u) * words[2];
+    vtkTypeUInt32 hi0 = static_cast<vtkTypeUInt32>(product0 >> 32);
+    vtkTypeUInt32 lo0 = static_cast<vtkTypeUInt32>(product0);
+    vtkTypeUInt32 hi1 = static_cast<vtkTypeUInt32>(product1 >> 32);
+    vtkTypeUInt32 lo1 = static_cast<vtkTypeUInt32>(product1);
+
+    words[0] = hi1 ^ words[1] ^ key0;
+    words[1] = lo1;
+    words[2] = hi0 ^ words[3] ^ key1;
+    words[3] = lo0;
+
+    key0 += 0x9E3779B9u;
+    key1 += 0xBB67AE85u;
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkUniformPointSampler::SampleUniforms(vtkIdType sample, int count,
+                                            double *u) {
+  if (count > MAX_SAMPLE_DIMENSIONS) {
+    count = MAX_SAMPLE_DIMENSIONS;
+  }
+
+  vtkTypeUInt32 words[8];
+  this->RandomWords(sample, 0, words);
+  if (count > 3) {
+    this->RandomWords(sample, 1, words+4);
+  }
+
+  if (!this->LowDiscrepancy) {
+    u[0] = UniformFromWords(words[0], words[1]);
+    for (int d = 1; d < count; d++) {
+      u[d] = UniformFromWord(words[d+1]);
+    }
+    return;
+  }
+
+  // Point number sample of the Sobol sequence with a random digital
+  // shift, which keeps the sequence's stratification.
+  vtkTypeUInt64 index = static_cast<vtkTypeUInt64>(sample);
+  for (int d = 0; d < count; d++) {
+    vtkTypeUInt32 x = this->SobolShift[d];
+    for (int k = 0; k < 32 && (index >> k) != 0; k++) {
+      if ((index >> k) & 1) {
+        x ^= this->SobolDirections[d][k];
+      }
+    }
+    u[d] = UniformFromWord(x);
+  }
+
+  // The sequence has 32 bits; fill the bits below those at random so
+  // cells are still picked at full precision.
+  u[0] += (UniformFromWord(words[0]) - 0.5) * (1.0 / 4294967296.0);
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkUniformPointSampler::ThreadedGenerateSamplePoints(void *arg) {
+  int threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
+  int threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
+  vtkUniformPointSamplerThreadInfo *userData = (vtkUniformPointSamplerThreadInfo *)
+    (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
+
+  // Contiguous block of samples for this thread. Every sample costs about
+  // the same, so a static split balances well.
+  vtkIdType first = userData->FirstSample;
+  vtkIdType numSamples = userData->NumberOfSamples - first;
+  vtkIdType start = first + (numSamples * threadId) / threadCount;
+  vtkIdType end   = first + (numSamples * (threadId + 1)) / threadCount;
+
+  int stride = userData->Stride;
+  float *x = userData->Coordinates[0] + stride*start;
+  float *y = userData->Coordinates[1] + stride*start;
+  float *z = userData->Coordinates[2] + stride*start;
+  for (vtkIdType i = start; i < end; i++) {
+    double pt[3];
+    userData->Sampler->ComputeSamplePoint(i, pt);
+    *x = static_cast<float>(pt[0]); x += stride;
+    *y = static_cast<float>(pt[1]); y += stride;
+    *z = static_cast<float>(pt[2]); z += stride;
+  }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+void vtkUniformPointSampler::GenerateSamplePoints(vtkIdType numPoints,
+                                                  vtkPolyData *output) {
+  if (numPoints < 0)
+    numPoints = 0;
+
+  if (this->SampleCacheSeed != this->Seed ||
+      this->SampleCacheLowDiscrepancy != this->LowDiscrepancy)
+    this->InvalidateSampleCache();
+
+  // Digital shift of the Sobol sequence. Sample blocks never reach these
+  // block numbers.
+  vtkTypeUInt32 shiftWords[8];
+  this->RandomWords(0, 0xFFFFFFFFu, shiftWords);
+  this->RandomWords(0, 0xFFFFFFFEu, shiftWords+4);
+  for (int d = 0; d < MAX_SAMPLE_DIMENSIONS; d++) {
+    this->SobolShift[d] = shiftWords[d];
+  }
+
+  vtkUniformPointSamplerThreadInfo info;
+  info.Sampler = this;
+  info.FirstSample = 0;
+  info.NumberOfSamples = numPoints;
+
+  vtkPoints *newPoints = vtkPoints::New(VTK_FLOAT);
+  if (this->CompactOutput) {
+    vtkSOADataArrayTemplate<float> *coords = vtkSOADataArrayTemplate<float>::New();
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(numPoints);
+    newPoints->SetData(coords);
+    coords->Delete();
+  } else {
+    newPoints->SetNumberOfPoints(numPoints);
+  }
+  info.Stride = vtkUniformPointSamplerGetCoordinates
+    (newPoints, this->CompactOutput, info.Coordinates);
+
+  // Read samples stored by an earlier run if they go further than the
+  // samples in memory.
+  std::string cacheFileName = this->GetSampleCacheFileName();
+  if (cacheFileName != this->SampleCacheFileName) {
+    this->SampleCacheFileName = cacheFileName;
+    this->SampleCacheFileCount = -1;
+  }
+  vtkIdType numInMemory = this->SampleCache ? this->SampleCache->GetNumberOfPoints() : 0;
+  if (!cacheFileName.empty() && numPoints > numInMemory &&
+      (this->SampleCacheFileCount < 0 || this->SampleCacheFileCount > numInMemory)) {
+    vtkPoints *stored = ReadSampleCacheFile(cacheFileName.c_str());
+    this->SampleCacheFileCount = stored ? stored->GetNumberOfPoints() : 0;
+
+    // Mark the file as recently used so it is removed last.
+    if (stored)
+      vtksys::SystemTools::Touch(cacheFileName.c_str(), false);
+    if (stored && stored->GetNumberOfPoints() > numInMemory) {
+      this->SampleCache = stored;
+      this->SampleCacheCompact = 0;
+    }
+    if (stored)
+      stored->Delete();
+  }
+
+  // Copy the samples that were already computed.
+  if (this->SampleCache) {
+    float *cached[3];
+    int cachedStride = vtkUniformPointSamplerGetCoordinates
+      (this->SampleCache, this->SampleCacheCompact, cached);
+    vtkIdType numCached = this->SampleCache->GetNumberOfPoints();
+    if (numCached > numPoints)
+      numCached = numPoints;
+    for (int c = 0; c < 3; c++) {
+      const float *src = cached[c];
+      float *dst = info.Coordinates[c];
+      for (vtkIdType i = 0; i < numCached; i++) {
+        *dst = *src;
+        src += cachedStride;
+        dst += info.Stride;
+      }
+    }
+    info.FirstSample = numCached;
+  }
+
+  vtkIdType numNew = numPoints - info.FirstSample;
+  if (numNew > 0) {
+    int numThreads = this->NumberOfThreads;
+    if (numThreads > numNew)
+      numThreads = static_cast<int>(numNew);
+    this->Threader->SetNumberOfThreads(numThreads);
+    this->Threader->SetSingleMethod(vtkUniformPointSampler::ThreadedGenerateSamplePoints,
+                                    &info);
+    this->Threader->SingleMethodExecute();
+  }
+
+  // Store the samples if there are more than the file already holds.
+  // A failed write is not retried until the file name changes.
+  if (!cacheFileName.empty() && numPoints > this->SampleCacheFileCount) {
+    vtkTypeInt64 fileSize = 8 + sizeof(vtkTypeInt64) +
+      static_cast<vtkTypeInt64>(numPoints) * 3 * sizeof(float);
+    if (vtkCacheFileUtilities::PruneCacheDirectory(cacheFileName.c_str(), fileSize) &&
+        !WriteSampleCacheFile(cacheFileName.c_str(), newPoints, this->CompactOutput)) {
+      vtkWarningMacro(<< "Could not write sample cache file " << cacheFileName);
+    }
+    this->SampleCacheFileCount = numPoints;
+  }
+
+  output->SetPoints(newPoints);
+  this->SampleCache = newPoints;
+  this->SampleCacheSeed = this->Seed;
+  this->SampleCacheCompact = this->CompactOutput;
+  this->SampleCacheLowDiscrepancy = this->LowDiscrepancy;
+  newPoints->Delete();
+
+  if (this->CompactOutput) {
+    return;
+  }
+
+  // One vertex cell per point
+  vtkCellArray *verts = vtkCellArray::New();
+  vtkIdType *cells = verts->WritePointer(numPoints, 2*numPoints);
+  for (vtkIdType i = 0; i < numPoints; i++) {
+    *cells++ = 1;
+    *cells++ = i;
+  }
+  output->SetVerts(verts);
+  verts->Delete();
+}
@@ -22,12 +22,16 @@
 #define __vtkUniformPointSampler_h
 
 #include "vtkPolyDataAlgorithm.h"
+#include "vtkCacheFileUtilities.h"
+#include "vtkMultiThreader.h"
 #include "vtkSmartPointer.h"
+#include "vtkType.h"
 
-class vtkMinimalStandardRandomSequence;
-
+#include <string>
+#include <vector>
 
 class vtkDoubleArray;
+class vtkPoints;
 
 class vtkUniformPointSampler : public vtkPolyDataAlgorithm
 {
@@ -56,11 +60,93 @@ public:
   vtkSetMacro(NumberOfSamples,int);
   vtkGetMacro(NumberOfSamples,int);
   
+  // Description:
+  // Seed of the random generator. Sample i is a function only of the
+  // input, the seed, and i, so the same seed reproduces the same
+  // sampling regardless of the number of threads.
+  vtkSetMacro(Seed, unsigned int);
+  vtkGetMacro(Seed, unsigned int);
+
+  // Description:
+  // When on, the output holds only points, stored as single-precision
+  // structure-of-arrays (a vtkSOADataArrayTemplate<float> with separate
+  // x, y and z buffers), and no vertex cells. This takes 12 bytes per
+  // point instead of 28. Consumers that need vertex cells should leave
+  // this off (the default).
+  vtkSetMacro(CompactOutput, int);
+  vtkGetMacro(CompactOutput, int);
+  vtkBooleanMacro(CompactOutput, int);
+
+  // Description:
+  // When on, samples follow a randomly shifted Sobol sequence instead
+  // of independent random numbers, with cells chosen by inverting the
+  // cumulative cell measure so that the sequence's stratification
+  // carries over to the geometry. Images converge to the continuous
+  // labeling limit with far fewer samples. The seed selects the shift.
+  vtkSetMacro(LowDiscrepancy, int);
+  vtkGetMacro(LowDiscrepancy, int);
+  vtkBooleanMacro(LowDiscrepancy, int);
+
+  // Description:
+  // Number of threads used to generate samples.
+  vtkSetClampMacro(NumberOfThreads, int, 1, VTK_MAX_THREADS);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Directory holding sampled points between sessions. Files are named
+  // by the class, a hash of the sampled distribution, the seed and the
+  // sampling mode, so a later run sampling the same geometry with the
+  // same settings reads the points back instead of computing them.
+  // Only samples for the default seed of 0 are stored, since other seeds
+  // come from regenerating fluorophores and are rarely drawn again.
+  // When not set, the global cache directory is used; when neither is
+  // set, nothing is stored.
+  vtkSetStringMacro(CacheDirectory);
+  vtkGetStringMacro(CacheDirectory);
+
+  // Description:
+  // Cache directory shared by all samplers that do not set their own.
+  static void SetGlobalCacheDirectory(const char *directory);
+  static const char* GetGlobalCacheDirectory();
+
+  // Description:
+  // Largest number of bytes of cache files kept in a cache directory,
+  // counting the tetrahedral meshes of vtkPolyDataToTetrahedralGrid.
+  // When a new file would go over it, the files least recently read or
+  // written are removed. Files larger than the limit are not written.
+  // Default is 2 GiB. See vtkCacheFileUtilities.
+  static void SetCacheSizeLimit(vtkTypeInt64 bytes);
+  static vtkTypeInt64 GetCacheSizeLimit();
+
   // Description:
   // Get number of sample points that would be on this geometry for given
   // surface area and density.
   virtual int ComputeNumberOfSamples(double surfaceArea, double density) = 0;
 
+  // Description:
+  // Counter-based random generator (Philox4x32-10). Fills words with
+  // four random 32-bit values that depend only on seed, counter, and
+  // block. Shared with filters that need random numbers tied to
+  // individual samples.
+  static void GenerateRandomWords(unsigned int seed, vtkIdType counter,
+                                  vtkTypeUInt32 block, vtkTypeUInt32 words[4]);
+
+  // Description:
+  // Uniform random number in (0,1) from one random word.
+  static double UniformFromWord(vtkTypeUInt32 word) {
+    return (static_cast<double>(word) + 0.5) * (1.0 / 4294967296.0);
+  }
+
+  // Description:
+  // Uniform random number in [0,1) with 53 bits of precision from two
+  // random words. Used to pick cells so that the alias table keeps its
+  // accuracy on large meshes.
+  static double UniformFromWords(vtkTypeUInt32 high, vtkTypeUInt32 low) {
+    return (static_cast<double>(high >> 5) * 67108864.0 +
+            static_cast<double>(low >> 6)) * (1.0 / 9007199254740992.0);
+  }
+
+
 protected:
   vtkUniformPointSampler();
   virtual ~vtkUniformPointSampler();
@@ -87,8 +173,155 @@ protected:
   long ComputedTime;
 
   // Description:
-  // Random number generator
-  vtkSmartPointer< vtkMinimalStandardRandomSequence > Random;
+  // Random generator seed.
+  unsigned int Seed;
+
+  // Description:
+  // Emit points only, in structure-of-arrays layout.
+  int CompactOutput;
+
+  // Description:
+  // Use the Sobol sequence.
+  int LowDiscrepancy;
+
+  // Description:
+  // Maximum number of uniform random numbers per sample available
+  // through SampleUniforms().
+  enum { MAX_SAMPLE_DIMENSIONS = 7 };
+
+  // Description:
+  // Sobol direction numbers and the digital shift derived from the seed.
+  vtkTypeUInt32 SobolDirections[MAX_SAMPLE_DIMENSIONS][32];
+  vtkTypeUInt32 SobolShift[MAX_SAMPLE_DIMENSIONS];
+
+  // Description:
+  // Threads for sample generation.
+  vtkMultiThreader *Threader;
+  int               NumberOfThreads;
+
+  // Description:
+  // Alias table (Walker/Vose) over the sampled cells. A cell is chosen
+  // with probability proportional to its weight in constant time.
+  std::vector<double>    AliasProbability;
+  std::vector<vtkIdType> AliasIndex;
+
+  // Description:
+  // Normalized cumulative cell weights, used to pick cells in
+  // low-discrepancy mode.
+  std::vector<double>    CumulativeWeights;
+
+  // Description:
+  // Time at which the alias table and cached cell vertices were built.
+  vtkTimeStamp AliasTableTime;
+
+  // Description:
+  // Builds the alias table from cell weights. Non-positive weights are
+  // never sampled. Invalidates the sample cache.
+  void BuildAliasTable(const std::vector<double>& weights);
+
+  // Description:
+  // Points generated by the last update, shared with the output. While
+  // the sampled distribution and seed stay the same, a change in the
+  // number of samples copies the samples that are still needed from
+  // here and computes only the new ones. Because samples are
+  // independent, keeping the first n of them when the number goes down
+  // drops a random subset, and going back up restores the same points.
+  vtkSmartPointer<vtkPoints> SampleCache;
+  unsigned int               SampleCacheSeed;
+  int                        SampleCacheCompact;
+  int                        SampleCacheLowDiscrepancy;
+
+  // Description:
+  // Subclasses call this when the sampled distribution changes.
+  void InvalidateSampleCache();
+
+  // Description:
+  // Hash of everything the samples depend on besides the seed and the
+  // sampling mode. BuildAliasTable() starts it from the cell weights,
+  // and subclasses fold in the cell geometry with HashDistribution().
+  vtkTypeUInt64 DistributionHash;
+
+  void HashDistribution(const void *data, size_t length) {
+    this->DistributionHash =
+      vtkCacheFileUtilities::HashBytes(data, length, this->DistributionHash);
+  }
+
+  // Description:
+  // Disk cache. SampleCacheFileCount is the number of samples in the
+  // file SampleCacheFileName, or -1 if the file has not been read yet.
+  char        *CacheDirectory;
+  std::string  SampleCacheFileName;
+  vtkIdType    SampleCacheFileCount;
+
+  // Description:
+  // Name of the cache file for the current distribution and settings,
+  // or an empty string if no cache directory is set. Subclasses whose
+  // samples are not worth keeping return an empty string.
+  virtual std::string GetSampleCacheFileName();
+
+  // Description:
+  // Reads points from a cache file. Returns NULL if the file does not
+  // exist or is not a valid cache file.
+  static vtkPoints* ReadSampleCacheFile(const char *fileName);
+
+  // Description:
+  // Writes points to a cache file. The file is written under a
+  // temporary name and renamed, so that concurrent runs never read a
+  // partial file.
+  static bool WriteSampleCacheFile(const char *fileName, vtkPoints *points,
+                                   int compact);
+
+  // Description:
+  // Maps a uniform random number in [0,1) to a cell index.
+  vtkIdType SampleAliasTable(double random) {
+    vtkIdType n = static_cast<vtkIdType>(this->AliasProbability.size());
+    double scaled = random * n;
+    vtkIdType i = static_cast<vtkIdType>(scaled);
+    if (i >= n) {
+      i = n - 1;
+    }
+    return (scaled - i < this->AliasProbability[i]) ? i : this->AliasIndex[i];
+  }
+
+  // Description:
+  // Maps a uniform random number in [0,1) to a cell index by inverting
+  // the cumulative weights. Slower than the alias table, but monotone.
+  vtkIdType SampleCumulativeTable(double random);
+
+  // Description:
+  // Picks a cell with the method suited to the sampling mode.
+  vtkIdType SampleCell(double random) {
+    return this->LowDiscrepancy ? this->SampleCumulativeTable(random)
+                                : this->SampleAliasTable(random);
+  }
+
+  // Description:
+  // Fills words with four random 32-bit values that depend only on
+  // Seed, the sample index, and the block number. Samples needing more
+  // than four values use further blocks.
+  void RandomWords(vtkIdType sample, vtkTypeUInt32 block, vtkTypeUInt32 words[4]) {
+    GenerateRandomWords(this->Seed, sample, block, words);
+  }
+
+  // Description:
+  // Fills u with count uniform numbers in (0,1) for sample number
+  // sample, either independent random numbers or the coordinates of a
+  // point of the Sobol sequence. u[0] has 53 bits of precision and is
+  // meant for picking cells. At most MAX_SAMPLE_DIMENSIONS numbers are
+  // available.
+  void SampleUniforms(vtkIdType sample, int count, double *u);
+
+  // Description:
+  // Computes sample point number sample. Called concurrently from
+  // several threads, so it must only read shared state.
+  virtual void ComputeSamplePoint(vtkIdType sample, double pt[3]) = 0;
+
+  // Description:
+  // Fills the output with numPoints samples, generated in parallel.
+  // Samples held in the sample cache are reused.
+  void GenerateSamplePoints(vtkIdType numPoints, vtkPolyData *output);
+
+  static VTK_THREAD_RETURN_TYPE ThreadedGenerateSamplePoints(void *arg);
 
 
 private:
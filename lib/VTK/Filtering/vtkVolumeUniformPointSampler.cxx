@@ -19,13 +19,11 @@
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkObjectFactory.h"
-#include "vtkMinimalStandardRandomSequence.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkTetra.h"
 
 #include <cstdlib>
-#include <ctime>
 
 vtkStandardNewMacro(vtkVolumeUniformPointSampler);
 
@@ -38,15 +36,11 @@ vtkVolumeUniformPointSampler::vtkVolumeUniformPointSampler()
   this->SetNumberOfOutputPorts(1);
   this->Density = 0.0;
   this->Volume = 0.0;
-  this->TetrahedraVolumes = vtkDoubleArray::New();
-  this->Register(this->TetrahedraVolumes);
 }
 
 //----------------------------------------------------------------------------
 vtkVolumeUniformPointSampler::~vtkVolumeUniformPointSampler()
 {
-  this->UnRegister(this->TetrahedraVolumes);
-  this->TetrahedraVolumes = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -69,9 +63,6 @@ int vtkVolumeUniformPointSampler::RequestData(
   vtkInformationVector** inputVector,
   vtkInformationVector* outputVector)
 {
-  // Set the RNG seed
-  this->Random->SetSeed( time( NULL ) );
-
   // get the info objects
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
@@ -81,12 +72,14 @@ int vtkVolumeUniformPointSampler::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  // Clean up the weights and output object.
-  this->TetrahedraVolumes->Initialize();
   output->Initialize();
 
-  // Calculate weights for each polygon.
-  this->ComputeTetrahedraVolumes(input);
+  // Calculate weights for each tetrahedron. These depend only on the
+  // mesh, so they are reused until the input changes.
+  if (input->GetMTime() > this->AliasTableTime.GetMTime() ||
+      this->TetrahedraVertices.empty()) {
+    this->ComputeTetrahedraVolumes(input);
+  }
 
   // Create the sample points
   this->CreateSamplePoints(input, output);
@@ -101,32 +94,42 @@ void vtkVolumeUniformPointSampler::ComputeTetrahedraVolumes(vtkUnstructuredGrid*
   vtkIdType npts, *pts;
   vtkCellArray* tetrahedra = input->GetCells();
 
-  // Invariant: at the completion of each iteration, the current tetrahedron
-  // is associated with the total volume computed so far.
-  // This will be used to randomly select a tetrahedron for point sampling using
-  // an uniform distribution.
+  std::vector<double> volumes;
+  volumes.reserve(tetrahedra->GetNumberOfCells());
+  this->TetrahedraVertices.clear();
+  this->TetrahedraVertices.reserve(12*tetrahedra->GetNumberOfCells());
+
+  // Cache the vertices of each tetrahedron alongside its volume so that
+  // sampling never touches the cell structure of the input.
   int cellId = 0;
   this->Volume = 0.0;
   for (tetrahedra->InitTraversal(); tetrahedra->GetNextCell(npts, pts); ) {
-    double p0[3], p1[3], p2[3], p3[3];
+    double p[4][3];
     if (npts == 4) {
-      input->GetPoint(pts[0], p0);
-      input->GetPoint(pts[1], p1);
-      input->GetPoint(pts[2], p2);
-      input->GetPoint(pts[3], p3);
-      double volume = vtkTetra::ComputeVolume(p0, p1, p2, p3);
+      input->GetPoint(pts[0], p[0]);
+      input->GetPoint(pts[1], p[1]);
+      input->GetPoint(pts[2], p[2]);
+      input->GetPoint(pts[3], p[3]);
+      double volume = vtkTetra::ComputeVolume(p[0], p[1], p[2], p[3]);
       if (volume <= 0.0) {
         std::cout << "Non-positive volume in element ID " << cellId
                   << ". Volume: " << volume << std::endl;
       }
-      //this->Volume += vtkTetra::ComputeVolume(p0, p1, p2, p3);
       this->Volume += volume;
-      this->TetrahedraVolumes->InsertNextValue(this->Volume);
+      volumes.push_back(volume);
+      this->TetrahedraVertices.insert(this->TetrahedraVertices.end(), &p[0][0], &p[0][0] + 12);
     } else {
       vtkDebugMacro(<< "npts != 4");
     }
     cellId++;
   }
+
+  this->BuildAliasTable(volumes);
+  if (!this->TetrahedraVertices.empty()) {
+    this->HashDistribution(&this->TetrahedraVertices[0],
+                           this->TetrahedraVertices.size()*sizeof(double));
+  }
+  this->AliasTableTime.Modified();
 }
 
 //----------------------------------------------------------------------------
@@ -136,74 +139,38 @@ void vtkVolumeUniformPointSampler::CreateSamplePoints(vtkUnstructuredGrid *input
   int numPoints = this->NumberOfSamples;
   if (!this->UseFixedNumberOfSamples)
     numPoints = this->ComputeNumberOfSamples(this->Volume, this->Density);
-  if (this->Volume <= 0.0)
+  if (this->Volume <= 0.0 || this->AliasProbability.empty())
     numPoints = 0;
 
-  output->Allocate(numPoints, 10);
-  vtkPoints *newPoints = vtkPoints::New();
-  newPoints->SetNumberOfPoints(numPoints);
-
-  // Insert the appropriate number of points.
-  for (int j = 0; j < numPoints; j++) {
-
-    // Get a random number. Probably doesn't matter how good it is.
-    this->Random->Next();
-    double rand = this->Random->GetValue() * this->Volume;
-
-    // Map this number to a polygon index via a binary search.
-    vtkIdType tetraIndex = -1;    
-    int start = 0;
-    int finish = this->TetrahedraVolumes->GetNumberOfTuples() - 1;
-    while (finish - start > 1) {
-      int mid = ((finish - start + 1) / 2) + start;
-      double weight = this->TetrahedraVolumes->GetTuple(mid)[0];
-      rand <= weight ? finish = mid : start = mid;
-    }
+  this->GenerateSamplePoints(numPoints, output);
+}
 
-    // Final decision.
-    if (rand <= this->TetrahedraVolumes->GetTuple(start)[0])
-      tetraIndex = start;
-    else
-      tetraIndex = finish;
-
-    // Get the polygon points and compute the new point to insert
-    vtkTetra *tetra = vtkTetra::SafeDownCast(input->GetCell(tetraIndex));
-    if (!tetra) {
-      vtkErrorMacro(<< "Could not downcast to tetrahedra with " << input->GetCell(tetraIndex)->GetNumberOfPoints() << " points to vtkTetra");
-      continue;
-    }
-    double randomPoint[3];
-    this->RandomTetrahedronPoint(tetra, input, randomPoint);
+//----------------------------------------------------------------------------
+void vtkVolumeUniformPointSampler::ComputeSamplePoint(vtkIdType sample,
+                                                      double pt[3]) {
+  double u[4];
+  this->SampleUniforms(sample, 4, u);
 
-    newPoints->InsertPoint(j, randomPoint);
-    vtkIdType id = static_cast<vtkIdType>(j);
-    output->InsertNextCell(static_cast<int>(VTK_VERTEX), 1, &id);
-  }
+  // Pick a tetrahedron with probability proportional to its volume.
+  vtkIdType tetraIndex = this->SampleCell(u[0]);
 
-  output->SetPoints(newPoints);
-  newPoints->Delete();
+  const double *p = &this->TetrahedraVertices[12*tetraIndex];
+  this->RandomTetrahedronPoint(p, p+3, p+6, p+9, u+1, pt);
 }
 
 //----------------------------------------------------------------------------
-void vtkVolumeUniformPointSampler::RandomTetrahedronPoint(vtkTetra *tetra, 
-                                                  vtkUnstructuredGrid *grid, 
+void vtkVolumeUniformPointSampler::RandomTetrahedronPoint(const double *p1,
+                                                  const double *p2,
+                                                  const double *p3,
+                                                  const double *p4,
+                                                  const double random[3],
                                                   double *pt) {
-  // Map to real coordinate.
-  double p1[3], p2[3], p3[3], p4[3];
-  grid->GetPoint(tetra->GetPointId(0), p1);
-  grid->GetPoint(tetra->GetPointId(1), p2);
-  grid->GetPoint(tetra->GetPointId(2), p3);
-  grid->GetPoint(tetra->GetPointId(3), p4);
-
   // Get coordinates that give a uniformly random
   // distribution in the space contained by the
   // tetrahedron.
-  this->Random->Next();
-  double s = pow(this->Random->GetValue(), 1.0/3.0);
-  this->Random->Next();
-  double t = sqrt(this->Random->GetValue());
-  this->Random->Next();
-  double r = this->Random->GetValue();
+  double s = pow(random[0], 1.0/3.0);
+  double t = sqrt(random[1]);
+  double r = random[2];
 
   // Get triangle
   double ux = s*(p2[0] - p1[0]) + p1[0];
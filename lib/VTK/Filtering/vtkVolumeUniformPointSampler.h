@@ -49,8 +49,9 @@ protected:
   virtual ~vtkVolumeUniformPointSampler();
 
   // Description:
-  // Volume of each tetrahedra.
-  vtkDoubleArray *TetrahedraVolumes;
+  // Vertex coordinates of each tetrahedron in the input, twelve values
+  // per tetrahedron, in the same order as the alias table.
+  std::vector<double> TetrahedraVertices;
 
   // Description:
   // Volume of the tetrahedral grid.
@@ -61,7 +62,8 @@ protected:
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
   // Description:
-  // Computes the volumes of the tetrahedra in the grid.
+  // Computes the volumes of the tetrahedra in the grid, caches their
+  // vertices, and builds the alias table used to pick tetrahedra.
   void ComputeTetrahedraVolumes(vtkUnstructuredGrid* input);
 
   // Description:
@@ -70,9 +72,15 @@ protected:
   void CreateSamplePoints(vtkUnstructuredGrid *input, vtkPolyData *output);
 
   // Description:
-  // Given a tetrahedron, creates a random point within the tetrahedron 
-  // using simplex point picking.
-  void RandomTetrahedronPoint(vtkTetra *tetra, vtkUnstructuredGrid *grid, double *pt);
+  // Computes sample point number sample.
+  virtual void ComputeSamplePoint(vtkIdType sample, double pt[3]);
+
+  // Description:
+  // Given tetrahedron vertices and three uniform random numbers, creates
+  // a random point within the tetrahedron using simplex point picking.
+  void RandomTetrahedronPoint(const double *p1, const double *p2,
+                              const double *p3, const double *p4,
+                              const double random[3], double *pt);
 
   // Description:
   // Usual data generation method.
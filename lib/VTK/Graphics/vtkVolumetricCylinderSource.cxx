@@ -20,6 +20,9 @@ vtkVolumetricCylinderSource::vtkVolumetricCylinderSource (int res)
   this->Height = 1.0;
   this->Radius = 0.5;
   this->GenerateScalars = 1;
+  this->MaximumError = 0.0;
+  this->MinimumResolution = 8;
+  this->MaximumResolution = 128;
 
   this->SetNumberOfInputPorts(0);
 }
@@ -68,7 +71,13 @@ int vtkVolumetricCylinderSource::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  double angle= 2.0 * vtkMath::Pi()/this->Resolution;
+  int resolution = this->Resolution;
+  if (this->MaximumError > 0.0)
+    {
+    resolution = this->ComputeResolution(this->Radius, 2.0*vtkMath::Pi());
+    }
+
+  double angle= 2.0 * vtkMath::Pi()/resolution;
   int numCells, numPts;
   double xtop[3], xbot[3];
   int i, idx;
@@ -80,18 +89,18 @@ int vtkVolumetricCylinderSource::RequestData(
   // Set things up; allocate memory
   //
 
-  numPts   = 2*this->Resolution + 2;
-  numCells = 3*this->Resolution;
+  numPts   = 2*resolution + 2;
+  numCells = 3*resolution;
 
   newPoints = vtkPoints::New();
   newPoints->Allocate(numPts);
 
   newCells = vtkCellArray::New();
-  newCells->Allocate(newCells->EstimateSize(numCells,this->Resolution));
+  newCells->Allocate(newCells->EstimateSize(numCells,resolution));
   //
   // Generate points and point data for sides
   //
-  for (i=0; i<this->Resolution; i++)
+  for (i=0; i<resolution; i++)
     {
     this->ComputePoint(0.0, i*angle, 1.0, xtop);
     this->ComputePoint(1.0, i*angle, 1.0, xbot);
@@ -113,11 +122,11 @@ int vtkVolumetricCylinderSource::RequestData(
   // Generate tetrahedral cells for volume. We (conceptually) loop over
   // wedges, then subdivide the wedges into tetrahedra.
   //
-  for (i=0; i<this->Resolution; i++)
+  for (i=0; i<resolution; i++)
     {
     // Tetra 1
     pts[0] = 2*i;
-    pts[1] = (2*(i+1)) % (2*this->Resolution);
+    pts[1] = (2*(i+1)) % (2*resolution);
     pts[2] = 2*i+1;
     pts[3] = numPts-2;
     newCells->InsertNextCell(4,pts);
@@ -126,13 +135,13 @@ int vtkVolumetricCylinderSource::RequestData(
     pts[0] = 2*i+1;
     pts[1] = numPts-1;
     pts[2] = numPts-2;
-    pts[3] = (2*(i+1)+1) % (2*this->Resolution);
+    pts[3] = (2*(i+1)+1) % (2*resolution);
     newCells->InsertNextCell(4,pts);
 
     // Tetra 3
-    pts[0] = (2*(i+1)) % (2*this->Resolution);
+    pts[0] = (2*(i+1)) % (2*resolution);
     pts[1] = numPts-2;
-    pts[2] = (2*(i+1)+1) % (2*this->Resolution);
+    pts[2] = (2*(i+1)+1) % (2*resolution);
     pts[3] = 2*i+1;
     newCells->InsertNextCell(4,pts);
     }
@@ -158,4 +167,7 @@ void vtkVolumetricCylinderSource::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Height: " << this->Height << "\n";
   os << indent << "Radius: " << this->Radius << "\n";
   os << indent << "GenerateScalars: " << (this->GenerateScalars ? "On\n" : "Off\n");
+  os << indent << "MaximumError: " << this->MaximumError << "\n";
+  os << indent << "MinimumResolution: " << this->MinimumResolution << "\n";
+  os << indent << "MaximumResolution: " << this->MaximumResolution << "\n";
 }
@@ -20,6 +20,9 @@ vtkVolumetricEllipsoidSource::vtkVolumetricEllipsoidSource (int res)
   this->PhiResolution   = res;
   this->Radius[0] = this->Radius[1] = this->Radius[2] = 1.0;
   this->GenerateScalars = 1;
+  this->MaximumError = 0.0;
+  this->MinimumResolution = 8;
+  this->MaximumResolution = 128;
 
   this->SetNumberOfInputPorts(0);
 }
@@ -82,8 +85,21 @@ int vtkVolumetricEllipsoidSource::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  double thetaAngle = 2.0 * vtkMath::Pi()/this->ThetaResolution;
-  double phiAngle   = vtkMath::Pi()/(this->PhiResolution-1);
+  int thetaResolution = this->ThetaResolution;
+  int phiResolution   = this->PhiResolution;
+  if (this->MaximumError > 0.0)
+    {
+    // The longest meridian and parallel lie on circles no larger than
+    // the largest radius.
+    double radius = this->Radius[0];
+    radius = (this->Radius[1] > radius ? this->Radius[1] : radius);
+    radius = (this->Radius[2] > radius ? this->Radius[2] : radius);
+    thetaResolution = this->ComputeResolution(radius, 2.0*vtkMath::Pi());
+    phiResolution   = this->ComputeResolution(radius, vtkMath::Pi()) + 1;
+    }
+
+  double thetaAngle = 2.0 * vtkMath::Pi()/thetaResolution;
+  double phiAngle   = vtkMath::Pi()/(phiResolution-1);
   int numCells, numPts;
   double x[3];
   int i, j;
@@ -95,26 +111,26 @@ int vtkVolumetricEllipsoidSource::RequestData(
   // Set things up; allocate memory
   //
 
-  numPts   = (this->ThetaResolution+1)*(this->PhiResolution-2) + 2;
-  numCells = 3*this->ThetaResolution*(this->PhiResolution-2) + 2*this->ThetaResolution;
+  numPts   = (thetaResolution+1)*(phiResolution-2) + 2;
+  numCells = 3*thetaResolution*(phiResolution-2) + 2*thetaResolution;
 
   newPoints = vtkPoints::New();
   newPoints->Allocate(numPts);
 
   newCells = vtkCellArray::New();
-  newCells->Allocate(newCells->EstimateSize(numCells,this->ThetaResolution));
+  newCells->Allocate(newCells->EstimateSize(numCells,thetaResolution));
 
-  int skip = this->ThetaResolution+1;
+  int skip = thetaResolution+1;
 
   //
   // Generate points and point data for all parts of the ellipsoid except for the
   // north and south poles.
   //
-  for (i=1; i<this->PhiResolution-1; i++)
+  for (i=1; i<phiResolution-1; i++)
     {
     double phi   = i*phiAngle;
 
-    for (j=0; j<this->ThetaResolution; j++)
+    for (j=0; j<thetaResolution; j++)
       {
       // x coordinate
       double theta = j*thetaAngle;
@@ -125,7 +141,7 @@ int vtkVolumetricEllipsoidSource::RequestData(
     // Point on the central axis
     x[0] = x[1] = 0.0;
     x[2] = this->Radius[2]*cos(phi);
-    newPoints->InsertPoint((i-1)*skip + this->ThetaResolution,x);
+    newPoints->InsertPoint((i-1)*skip + thetaResolution,x);
     }
 
   //
@@ -140,37 +156,37 @@ int vtkVolumetricEllipsoidSource::RequestData(
   //
   // Start by creating the tetrahedra at the north and south polls.
   //
-  for (i=0; i<this->ThetaResolution;i++)
+  for (i=0; i<thetaResolution;i++)
     {
     // South pole
     pts[0] = numPts-2;
-    pts[1] = (this->PhiResolution-3)*skip + i;
-    pts[2] = (this->PhiResolution-3)*skip + ((i+1) % this->ThetaResolution);
-    pts[3] = (this->PhiResolution-3)*skip + this->ThetaResolution;
+    pts[1] = (phiResolution-3)*skip + i;
+    pts[2] = (phiResolution-3)*skip + ((i+1) % thetaResolution);
+    pts[3] = (phiResolution-3)*skip + thetaResolution;
     newCells->InsertNextCell(4, pts);
 
     // North pole
     pts[0] = numPts-1;
-    pts[1] = (i+1) % this->ThetaResolution;
+    pts[1] = (i+1) % thetaResolution;
     pts[2] = i;
-    pts[3] = this->ThetaResolution;
+    pts[3] = thetaResolution;
     newCells->InsertNextCell(4, pts);
     }
 
   //
   // Generate tetrahedral cells for volume.
   //
-  for (i=0; i<this->PhiResolution-3; i++)
+  for (i=0; i<phiResolution-3; i++)
     {
 
-    for (j=0; j<this->ThetaResolution; j++)
+    for (j=0; j<thetaResolution; j++)
       {
       int n0 = (i  )*skip + j;
       int n1 = (i+1)*skip + j;
-      int n2 = (i+1)*skip + this->ThetaResolution;
-      int n3 = (i  )*skip + this->ThetaResolution;
-      int n4 = (i+1)*skip + ((j+1) % this->ThetaResolution);
-      int n5 = (i  )*skip + ((j+1) % this->ThetaResolution);
+      int n2 = (i+1)*skip + thetaResolution;
+      int n3 = (i  )*skip + thetaResolution;
+      int n4 = (i+1)*skip + ((j+1) % thetaResolution);
+      int n5 = (i  )*skip + ((j+1) % thetaResolution);
 
       // Tet 0
       pts[0] = n0;
@@ -219,4 +235,7 @@ void vtkVolumetricEllipsoidSource::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ThetaResolution: " << this->ThetaResolution << "\n";
   os << indent << "PhiResolution: " << this->PhiResolution << "\n";
   os << indent << "GenerateScalars: " << (this->GenerateScalars ? "On\n" : "Off\n");
+  os << indent << "MaximumError: " << this->MaximumError << "\n";
+  os << indent << "MinimumResolution: " << this->MinimumResolution << "\n";
+  os << indent << "MaximumResolution: " << this->MaximumResolution << "\n";
 }
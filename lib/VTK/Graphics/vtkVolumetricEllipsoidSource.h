@@ -23,6 +23,7 @@
 #include "vtkUnstructuredGridAlgorithm.h"
 
 #include "vtkCell.h" // Needed for VTK_CELL_SIZE
+#include "vtkVolumetricSourceUtilities.h" // Needed for ComputeResolution
 
 class vtkVolumetricEllipsoidSource : public vtkUnstructuredGridAlgorithm 
 {
@@ -46,6 +47,24 @@ public:
   vtkSetClampMacro(PhiResolution,int,2,VTK_INT_MAX)
   vtkGetMacro(PhiResolution,int);
 
+  // Description:
+  // Largest distance allowed between the faceted surface and the true
+  // surface. When positive, the resolutions are chosen from the size
+  // of the shape to meet it, between MinimumResolution and
+  // MaximumResolution, so that small shapes get few tetrahedra and large
+  // shapes stay smooth. Initial value is 0, which uses the resolutions
+  // set above.
+  vtkSetClampMacro(MaximumError,double,0.0,VTK_DOUBLE_MAX)
+  vtkGetMacro(MaximumError,double);
+
+  // Description:
+  // Bounds on the resolution chosen when MaximumError is positive.
+  // Initial values are 8 and 128.
+  vtkSetClampMacro(MinimumResolution,int,3,VTK_INT_MAX)
+  vtkGetMacro(MinimumResolution,int);
+  vtkSetClampMacro(MaximumResolution,int,3,VTK_INT_MAX)
+  vtkGetMacro(MaximumResolution,int);
+
   // Description:
   // Turn on/off generation of scalar data. Initial value is true.
   vtkSetMacro(GenerateScalars,int);
@@ -74,10 +93,23 @@ protected:
   ~vtkVolumetricEllipsoidSource() {};
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
+  // Description:
+  // Number of segments of a circular arc of the given radius and angle
+  // that keep it within MaximumError of its chords.
+  int ComputeResolution(double radius, double angle)
+    {
+    return vtkVolumetricSourceUtilities::ComputeArcResolution(
+      radius, angle, this->MaximumError,
+      this->MinimumResolution, this->MaximumResolution);
+    };
+
   double Radius[3];
   int ThetaResolution;
   int PhiResolution;
   int GenerateScalars;
+  double MaximumError;
+  int MinimumResolution;
+  int MaximumResolution;
 
 private:
   vtkVolumetricEllipsoidSource(const vtkVolumetricEllipsoidSource&);  // Not implemented.
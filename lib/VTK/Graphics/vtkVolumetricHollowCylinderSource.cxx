@@ -21,6 +21,9 @@ vtkVolumetricHollowCylinderSource::vtkVolumetricHollowCylinderSource (int res)
   this->InnerRadius = 0.1;
   this->OuterRadius = 0.5;
   this->GenerateScalars = 1;
+  this->MaximumError = 0.0;
+  this->MinimumResolution = 8;
+  this->MaximumResolution = 128;
   this->Center[0] = this->Center[1] = this->Center[2] = 0.0;
 
   this->SetNumberOfInputPorts(0);
@@ -83,7 +86,13 @@ int vtkVolumetricHollowCylinderSource::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  double angle= 2.0 * vtkMath::Pi()/this->Resolution;
+  int resolution = this->Resolution;
+  if (this->MaximumError > 0.0)
+    {
+    resolution = this->ComputeResolution(this->OuterRadius, 2.0*vtkMath::Pi());
+    }
+
+  double angle= 2.0 * vtkMath::Pi()/resolution;
   int numCells, numPts;
   double xtopin[3], xbotin[3], xtopout[3], xbotout[3];
   int i, idx;
@@ -94,18 +103,18 @@ int vtkVolumetricHollowCylinderSource::RequestData(
   // Set things up; allocate memory
   //
 
-  numPts   = 4*this->Resolution;
-  numCells = 5*this->Resolution;
+  numPts   = 4*resolution;
+  numCells = 5*resolution;
 
   newPoints = vtkPoints::New();
   newPoints->Allocate(numPts);
 
   newCells = vtkCellArray::New();
-  newCells->Allocate(newCells->EstimateSize(numCells,this->Resolution));
+  newCells->Allocate(newCells->EstimateSize(numCells,resolution));
   //
   // Generate points and point data for sides
   //
-  for (i=0; i<this->Resolution; i++)
+  for (i=0; i<resolution; i++)
     {
     this->ComputePoint(1.0, i*angle, 1.0, xtopout);
     this->ComputePoint(1.0, i*angle, 0.0, xtopin);
@@ -124,9 +133,9 @@ int vtkVolumetricHollowCylinderSource::RequestData(
   //
   // Generate tetrahedral cells for volume.
   //
-  for (i=0; i<this->Resolution; i++)
+  for (i=0; i<resolution; i++)
     {
-    int mod = 4*this->Resolution;
+    int mod = 4*resolution;
     int n0 = 4*i+0, n1 = 4*i+1, n2 = 4*i+2, n3 = 4*i+3;
     int n4 = (4*(i+1)+0) % mod, n5 = (4*(i+1)+1) % mod;
     int n6 = (4*(i+1)+2) % mod, n7 = (4*(i+1)+3) % mod;
@@ -199,4 +208,7 @@ void vtkVolumetricHollowCylinderSource::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Center: (" << this->Center[0] << ", "
      << this->Center[1] << ", " << this->Center[2] << " )\n";
   os << indent << "GenerateScalars: " << (this->GenerateScalars ? "On\n" : "Off\n");
+  os << indent << "MaximumError: " << this->MaximumError << "\n";
+  os << indent << "MinimumResolution: " << this->MinimumResolution << "\n";
+  os << indent << "MaximumResolution: " << this->MaximumResolution << "\n";
 }
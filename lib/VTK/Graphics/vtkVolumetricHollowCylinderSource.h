@@ -22,6 +22,7 @@
 #include "vtkUnstructuredGridAlgorithm.h"
 
 #include "vtkCell.h" // Needed for VTK_CELL_SIZE
+#include "vtkVolumetricSourceUtilities.h" // Needed for ComputeResolution
 
 class vtkVolumetricHollowCylinderSource : public vtkUnstructuredGridAlgorithm
 {
@@ -56,6 +57,24 @@ public:
   vtkSetClampMacro(Resolution,int,2,VTK_CELL_SIZE)
   vtkGetMacro(Resolution,int);
 
+  // Description:
+  // Largest distance allowed between the faceted surface and the true
+  // surface. When positive, the resolution is chosen from the size
+  // of the shape to meet it, between MinimumResolution and
+  // MaximumResolution, so that small shapes get few tetrahedra and large
+  // shapes stay smooth. Initial value is 0, which uses the resolution
+  // set above.
+  vtkSetClampMacro(MaximumError,double,0.0,VTK_DOUBLE_MAX)
+  vtkGetMacro(MaximumError,double);
+
+  // Description:
+  // Bounds on the resolution chosen when MaximumError is positive.
+  // Initial values are 8 and 128.
+  vtkSetClampMacro(MinimumResolution,int,3,VTK_INT_MAX)
+  vtkGetMacro(MinimumResolution,int);
+  vtkSetClampMacro(MaximumResolution,int,3,VTK_INT_MAX)
+  vtkGetMacro(MaximumResolution,int);
+
   // Description:
   // Turn on/off generation of scalar data. Initial value is true.
   vtkSetMacro(GenerateScalars,int);
@@ -84,12 +103,25 @@ protected:
   ~vtkVolumetricHollowCylinderSource() {};
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *);
+  // Description:
+  // Number of segments of a circular arc of the given radius and angle
+  // that keep it within MaximumError of its chords.
+  int ComputeResolution(double radius, double angle)
+    {
+    return vtkVolumetricSourceUtilities::ComputeArcResolution(
+      radius, angle, this->MaximumError,
+      this->MinimumResolution, this->MaximumResolution);
+    };
+
   double Height;
   double InnerRadius;
   double OuterRadius;
   double Center[3];
   int Resolution;
   int GenerateScalars;
+  double MaximumError;
+  int MinimumResolution;
+  int MaximumResolution;
 
 private:
   vtkVolumetricHollowCylinderSource(const vtkVolumetricHollowCylinderSource&);  // Not implemented.
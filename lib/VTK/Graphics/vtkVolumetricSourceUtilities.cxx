@@ -0,0 +1,34 @@
+#include "vtkVolumetricSourceUtilities.h"
+
+#include <math.h>
+
+int vtkVolumetricSourceUtilities::ComputeArcResolution(double radius, double angle,
+                                                       double maximumError,
+                                                       int minimumResolution,
+                                                       int maximumResolution)
+{
+  int resolution = maximumResolution;
+  if (maximumError < radius)
+    {
+    // A chord spanning angle a lies radius*(1 - cos(a/2)) inside the arc.
+    double maxAngle = 2.0*acos(1.0 - maximumError/radius);
+    if (maxAngle*maximumResolution > angle)
+      {
+      resolution = static_cast<int>(ceil(angle / maxAngle));
+      }
+    }
+  else
+    {
+    resolution = minimumResolution;
+    }
+
+  if (resolution < minimumResolution)
+    {
+    resolution = minimumResolution;
+    }
+  if (resolution > maximumResolution)
+    {
+    resolution = maximumResolution;
+    }
+  return resolution;
+}
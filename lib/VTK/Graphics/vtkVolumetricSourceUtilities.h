@@ -0,0 +1,24 @@
+// .NAME vtkVolumetricSourceUtilities - helpers shared by the volumetric
+// sources
+// .SECTION Description
+// vtkVolumetricSourceUtilities holds the computations the volumetric
+// cylinder, hollow cylinder, ellipsoid and torus sources have in common.
+
+
+#ifndef __vtkVolumetricSourceUtilities_h
+#define __vtkVolumetricSourceUtilities_h
+
+class vtkVolumetricSourceUtilities
+{
+public:
+  // Description:
+  // Number of segments of a circular arc of the given radius and angle
+  // that keep it within maximumError of its chords, clamped between
+  // minimumResolution and maximumResolution.
+  static int ComputeArcResolution(double radius, double angle,
+                                  double maximumError,
+                                  int minimumResolution,
+                                  int maximumResolution);
+};
+
+#endif
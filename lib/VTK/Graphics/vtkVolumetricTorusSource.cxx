@@ -21,6 +21,9 @@ vtkVolumetricTorusSource::vtkVolumetricTorusSource (int res)
   this->ThetaResolution = res;
   this->PhiResolution   = res;
   this->GenerateScalars = 1;
+  this->MaximumError = 0.0;
+  this->MinimumResolution = 8;
+  this->MaximumResolution = 128;
 
   this->SetNumberOfInputPorts(0);
 }
@@ -83,8 +86,20 @@ int vtkVolumetricTorusSource::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  double thetaAngle = 2.0 * vtkMath::Pi()/this->ThetaResolution;
-  double phiAngle   = 2.0 * vtkMath::Pi()/this->PhiResolution;
+  int thetaResolution = this->ThetaResolution;
+  int phiResolution   = this->PhiResolution;
+  if (this->MaximumError > 0.0)
+    {
+    // The ring is faceted on the outer equator, the largest circle
+    // around the axis.
+    thetaResolution = this->ComputeResolution(
+      this->RingRadius + this->CrossSectionRadius, 2.0*vtkMath::Pi());
+    phiResolution   = this->ComputeResolution(
+      this->CrossSectionRadius, 2.0*vtkMath::Pi());
+    }
+
+  double thetaAngle = 2.0 * vtkMath::Pi()/thetaResolution;
+  double phiAngle   = 2.0 * vtkMath::Pi()/phiResolution;
   int numCells, numPts;
   double x[3];
   int i, j;
@@ -96,26 +111,26 @@ int vtkVolumetricTorusSource::RequestData(
   // Set things up; allocate memory
   //
 
-  numPts   = this->ThetaResolution*(this->PhiResolution+1);
-  numCells = 3*this->ThetaResolution*this->PhiResolution;
+  numPts   = thetaResolution*(phiResolution+1);
+  numCells = 3*thetaResolution*phiResolution;
 
   newPoints = vtkPoints::New();
   newPoints->Allocate(numPts);
 
   newCells = vtkCellArray::New();
-  newCells->Allocate(newCells->EstimateSize(numCells,this->ThetaResolution));
+  newCells->Allocate(newCells->EstimateSize(numCells,thetaResolution));
 
-  int skip = this->PhiResolution+1;
+  int skip = phiResolution+1;
 
   //
   // Generate points and point data.
   //
-  for (j=0; j<this->ThetaResolution; j++)
+  for (j=0; j<thetaResolution; j++)
     {
     // x coordinate
     double theta = j*thetaAngle;
 
-    for (i=0; i<this->PhiResolution; i++)
+    for (i=0; i<phiResolution; i++)
       {
       double phi   = i*phiAngle;
       this->ComputePoint(theta, phi, 1.0, x);
@@ -124,22 +139,22 @@ int vtkVolumetricTorusSource::RequestData(
 
     // Point on the medial axis
     this->ComputePoint(theta, 0.0, 0.0, x);
-    newPoints->InsertPoint(j*skip + this->PhiResolution,x);
+    newPoints->InsertPoint(j*skip + phiResolution,x);
     }
 
   //
   // Generate tetrahedral cells for volume.
   //
-  for (i=0; i<this->PhiResolution; i++)
+  for (i=0; i<phiResolution; i++)
     {
     int i1Idx = i;
-    int i2Idx = (i+1)%this->PhiResolution;
-    int iInIdx = this->PhiResolution;
+    int i2Idx = (i+1)%phiResolution;
+    int iInIdx = phiResolution;
 
-    for (j=0; j<this->ThetaResolution; j++)
+    for (j=0; j<thetaResolution; j++)
       {
       int j1Idx = j;
-      int j2Idx = (j+1)%this->ThetaResolution;
+      int j2Idx = (j+1)%thetaResolution;
       int n0 = j1Idx*skip + i1Idx;
       int n1 = j2Idx*skip + i1Idx;
       int n2 = j2Idx*skip + iInIdx;
@@ -193,4 +208,7 @@ void vtkVolumetricTorusSource::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ThetaResolution: " << this->ThetaResolution << "\n";
   os << indent << "PhiResolution: " << this->PhiResolution << "\n";
   os << indent << "GenerateScalars: " << (this->GenerateScalars ? "On\n" : "Off\n");
+  os << indent << "MaximumError: " << this->MaximumError << "\n";
+  os << indent << "MinimumResolution: " << this->MinimumResolution << "\n";
+  os << indent << "MaximumResolution: " << this->MaximumResolution << "\n";
 }
@@ -0,0 +1,697 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkAnalyticPartialVolumeSource.cxx,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAnalyticPartialVolumeSource.h"
+
+#include "vtkCriticalSection.h"
+#include "vtkDataArray.h"
+#include "vtkImageData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkMultiThreader.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+vtkStandardNewMacro(vtkAnalyticPartialVolumeSource);
+
+// Largest number of breakpoints a shape splits an integration range at.
+static const int MAX_BREAKS = 24;
+
+//----------------------------------------------------------------------------
+// Length of the overlap of the intervals [a0, a1] and [b0, b1].
+static inline double vtkAnalyticPartialVolumeSourceOverlap(double a0, double a1,
+                                                           double b0, double b1)
+{
+  double length = std::min(a1, b1) - std::max(a0, b0);
+  return length > 0.0 ? length : 0.0;
+}
+
+//----------------------------------------------------------------------------
+// Adds the breakpoints -sqrt(square) and sqrt(square) if square is positive.
+static inline void vtkAnalyticPartialVolumeSourceAddBreaks(double *breaks,
+                                                           int &numBreaks,
+                                                           double square)
+{
+  if (square > 0.0 && numBreaks + 2 <= MAX_BREAKS)
+    {
+    double root = sqrt(square);
+    breaks[numBreaks++] = -root;
+    breaks[numBreaks++] = root;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Splits [a, b] at the breakpoints that fall inside it. Returns the number
+// of pieces; piece p is [ends[p], ends[p+1]].
+static int vtkAnalyticPartialVolumeSourceSplit(double a, double b,
+                                               double *breaks, int numBreaks,
+                                               double *ends)
+{
+  std::sort(breaks, breaks + numBreaks);
+  int numEnds = 0;
+  ends[numEnds++] = a;
+  for (int i = 0; i < numBreaks; i++)
+    {
+    if (breaks[i] > ends[numEnds-1] && breaks[i] < b)
+      {
+      ends[numEnds++] = breaks[i];
+      }
+    }
+  ends[numEnds++] = b;
+  return numEnds - 1;
+}
+
+//----------------------------------------------------------------------------
+// Signed distance in the meridian plane from (rho, y) to the region
+// |y| <= halfHeight, |rho - center| <= halfWidth. It is the exact signed
+// distance to the cylinder or hollow cylinder this region sweeps out.
+static double vtkAnalyticPartialVolumeSourceSlabDistance(double rho, double y,
+                                                         double center,
+                                                         double halfWidth,
+                                                         double halfHeight)
+{
+  double dr = fabs(rho - center) - halfWidth;
+  double dy = fabs(y) - halfHeight;
+  double outr = dr > 0.0 ? dr : 0.0;
+  double outy = dy > 0.0 ? dy : 0.0;
+  double inside = std::max(dr, dy);
+  return sqrt(outr*outr + outy*outy) + (inside < 0.0 ? inside : 0.0);
+}
+
+//----------------------------------------------------------------------------
+struct vtkAnalyticPartialVolumeSourceThreadInfo
+{
+  vtkAnalyticPartialVolumeSource *Source;
+  vtkDataArray                   *Scalars;
+  double                          Origin[3];
+  double                          Spacing[3];
+};
+
+//----------------------------------------------------------------------------
+vtkAnalyticPartialVolumeSource::vtkAnalyticPartialVolumeSource()
+{
+  this->Shape = ELLIPSOID;
+  this->Radii[0] = this->Radii[1] = this->Radii[2] = 0.5;
+  this->Radius = 0.5;
+  this->InnerRadius = 0.25;
+  this->OuterRadius = 0.5;
+  this->Height = 1.0;
+  this->RingRadius = 1.0;
+  this->CrossSectionRadius = 0.25;
+  this->QuadratureOrder = 6;
+
+  this->SampleDimensions[0] = 50;
+  this->SampleDimensions[1] = 50;
+  this->SampleDimensions[2] = 50;
+
+  for (int i = 0; i < 6; i++)
+    {
+    this->ModelBounds[i] = 0.0;
+    }
+
+  this->OutputScalarType = VTK_DOUBLE;
+
+  this->Threader = vtkMultiThreader::New();
+  this->NumberOfThreads = this->Threader->GetNumberOfThreads();
+  this->SliceMutex = new vtkSimpleCriticalSection;
+  this->NextSlice = 0;
+
+  this->SetNumberOfInputPorts(0);
+}
+
+//----------------------------------------------------------------------------
+vtkAnalyticPartialVolumeSource::~vtkAnalyticPartialVolumeSource()
+{
+  this->Threader->Delete();
+  delete this->SliceMutex;
+}
+
+//----------------------------------------------------------------------------
+void vtkAnalyticPartialVolumeSource::GetShapeBounds(double bounds[6])
+{
+  double extent[3];
+  switch (this->Shape)
+    {
+    case ELLIPSOID:
+      extent[0] = this->Radii[0];
+      extent[1] = this->Radii[1];
+      extent[2] = this->Radii[2];
+      break;
+
+    case CYLINDER:
+      extent[0] = extent[2] = this->Radius;
+      extent[1] = 0.5*this->Height;
+      break;
+
+    case HOLLOW_CYLINDER:
+      extent[0] = extent[2] = this->OuterRadius;
+      extent[1] = 0.5*this->Height;
+      break;
+
+    case TORUS:
+    default:
+      extent[0] = extent[1] = this->RingRadius + this->CrossSectionRadius;
+      extent[2] = this->CrossSectionRadius;
+      break;
+    }
+
+  for (int i = 0; i < 3; i++)
+    {
+    bounds[2*i]   = -extent[i];
+    bounds[2*i+1] =  extent[i];
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkAnalyticPartialVolumeSource::ComputeOriginAndSpacing(double origin[3],
+                                                             double spacing[3])
+{
+  double shapeBounds[6];
+  double *bounds = this->ModelBounds;
+  if ( this->ModelBounds[0] >= this->ModelBounds[1] ||
+       this->ModelBounds[2] >= this->ModelBounds[3] ||
+       this->ModelBounds[4] >= this->ModelBounds[5] )
+    {
+    this->GetShapeBounds(shapeBounds);
+    bounds = shapeBounds;
+    }
+
+  for (int i = 0; i < 3; i++)
+    {
+    origin[i] = bounds[2*i];
+    if ( this->SampleDimensions[i] <= 1 )
+      {
+      spacing[i] = 1.0;
+      }
+    else
+      {
+      spacing[i] = (bounds[2*i+1] - bounds[2*i]) /
+        (this->SampleDimensions[i] - 1);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkAnalyticPartialVolumeSource::EvaluateDistanceBound(const double x[3])
+{
+  switch (this->Shape)
+    {
+    case ELLIPSOID:
+      {
+      // Scaling the ellipsoid to the unit sphere shrinks distances by at
+      // most the smallest radius.
+      double minRadius = std::min(this->Radii[0],
+                                  std::min(this->Radii[1], this->Radii[2]));
+      if (minRadius <= 0.0)
+        {
+        return VTK_DOUBLE_MAX;
+        }
+      double q = 0.0;
+      for (int i = 0; i < 3; i++)
+        {
+        q += (x[i] / this->Radii[i])*(x[i] / this->Radii[i]);
+        }
+      return minRadius*(sqrt(q) - 1.0);
+      }
+
+    case CYLINDER:
+      return vtkAnalyticPartialVolumeSourceSlabDistance(
+        sqrt(x[0]*x[0] + x[2]*x[2]), x[1],
+        0.0, this->Radius, 0.5*this->Height);
+
+    case HOLLOW_CYLINDER:
+      return vtkAnalyticPartialVolumeSourceSlabDistance(
+        sqrt(x[0]*x[0] + x[2]*x[2]), x[1],
+        0.5*(this->OuterRadius + this->InnerRadius),
+        0.5*(this->OuterRadius - this->InnerRadius), 0.5*this->Height);
+
+    case TORUS:
+    default:
+      {
+      // Exact outside. Inside a torus whose tube overlaps itself, the
+      // depth can only be larger.
+      double rho = sqrt(x[0]*x[0] + x[1]*x[1]) - this->RingRadius;
+      return sqrt(rho*rho + x[2]*x[2]) - this->CrossSectionRadius;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkAnalyticPartialVolumeSource::ComputeBoxVolume(const double box[6])
+{
+  const int numNodes = static_cast<int>(this->GaussNodes.size());
+  const double *nodes = &this->GaussNodes[0];
+  const double *weights = &this->GaussWeights[0];
+
+  double outerBreaks[MAX_BREAKS], innerBreaks[MAX_BREAKS];
+  double outerEnds[MAX_BREAKS+2], innerEnds[MAX_BREAKS+2];
+  int numOuterBreaks = 0;
+  double volume = 0.0;
+
+  switch (this->Shape)
+    {
+    case ELLIPSOID:
+      {
+      // Exact length along z, integrated over y and then x. The pieces
+      // end where the length or its range in y reaches a box face.
+      double rx = this->Radii[0], ry = this->Radii[1], rz = this->Radii[2];
+      if (rx <= 0.0 || ry <= 0.0 || rz <= 0.0)
+        {
+        return 0.0;
+        }
+      for (int a = 2; a < 4; a++)
+        {
+        double yb = box[a] / ry;
+        vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                                rx*rx*(1.0 - yb*yb));
+        for (int b = 4; b < 6; b++)
+          {
+          double zb = box[b] / rz;
+          vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                                  rx*rx*(1.0 - yb*yb - zb*zb));
+          }
+        }
+      for (int b = 4; b < 6; b++)
+        {
+        double zb = box[b] / rz;
+        vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                                rx*rx*(1.0 - zb*zb));
+        }
+
+      double x0 = std::max(box[0], -rx), x1 = std::min(box[1], rx);
+      if (x0 >= x1)
+        {
+        return 0.0;
+        }
+      int numOuter = vtkAnalyticPartialVolumeSourceSplit(
+        x0, x1, outerBreaks, numOuterBreaks, outerEnds);
+      for (int p = 0; p < numOuter; p++)
+        {
+        double xc = 0.5*(outerEnds[p] + outerEnds[p+1]);
+        double xh = 0.5*(outerEnds[p+1] - outerEnds[p]);
+        for (int n = 0; n < numNodes; n++)
+          {
+          double x = xc + xh*nodes[n];
+          double s = 1.0 - (x/rx)*(x/rx);
+          if (s <= 0.0)
+            {
+            continue;
+            }
+          double yExtent = ry*sqrt(s);
+          double y0 = std::max(box[2], -yExtent), y1 = std::min(box[3], yExtent);
+          if (y0 >= y1)
+            {
+            continue;
+            }
+          int numInnerBreaks = 0;
+          for (int b = 4; b < 6; b++)
+            {
+            double zb = box[b] / rz;
+            vtkAnalyticPartialVolumeSourceAddBreaks(innerBreaks, numInnerBreaks,
+                                                    ry*ry*(s - zb*zb));
+            }
+          int numInner = vtkAnalyticPartialVolumeSourceSplit(
+            y0, y1, innerBreaks, numInnerBreaks, innerEnds);
+
+          double area = 0.0;
+          for (int q = 0; q < numInner; q++)
+            {
+            double yc = 0.5*(innerEnds[q] + innerEnds[q+1]);
+            double yh = 0.5*(innerEnds[q+1] - innerEnds[q]);
+            for (int m = 0; m < numNodes; m++)
+              {
+              double y = yc + yh*nodes[m];
+              double t = s - (y/ry)*(y/ry);
+              double zExtent = t > 0.0 ? rz*sqrt(t) : 0.0;
+              area += yh*weights[m]*vtkAnalyticPartialVolumeSourceOverlap(
+                box[4], box[5], -zExtent, zExtent);
+              }
+            }
+          volume += xh*weights[n]*area;
+          }
+        }
+      return volume;
+      }
+
+    case CYLINDER:
+    case HOLLOW_CYLINDER:
+      {
+      // Exact along y, the axis, and along x; integrated over z. The
+      // pieces end where a circle crosses a box face in x.
+      double outer = this->Shape == CYLINDER ? this->Radius : this->OuterRadius;
+      double inner = this->Shape == CYLINDER ? 0.0 :
+        std::min(this->InnerRadius, this->OuterRadius);
+      double height = vtkAnalyticPartialVolumeSourceOverlap(
+        box[2], box[3], -0.5*this->Height, 0.5*this->Height);
+      if (height <= 0.0 || outer <= 0.0)
+        {
+        return 0.0;
+        }
+
+      vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                              inner*inner);
+      for (int a = 0; a < 2; a++)
+        {
+        vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                                outer*outer - box[a]*box[a]);
+        vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                                inner*inner - box[a]*box[a]);
+        }
+
+      double z0 = std::max(box[4], -outer), z1 = std::min(box[5], outer);
+      if (z0 >= z1)
+        {
+        return 0.0;
+        }
+      int numPieces = vtkAnalyticPartialVolumeSourceSplit(
+        z0, z1, outerBreaks, numOuterBreaks, outerEnds);
+      for (int p = 0; p < numPieces; p++)
+        {
+        double zc = 0.5*(outerEnds[p] + outerEnds[p+1]);
+        double zh = 0.5*(outerEnds[p+1] - outerEnds[p]);
+        for (int n = 0; n < numNodes; n++)
+          {
+          double z = zc + zh*nodes[n];
+          double co = outer*outer - z*z;
+          co = co > 0.0 ? sqrt(co) : 0.0;
+          double length = vtkAnalyticPartialVolumeSourceOverlap(
+            box[0], box[1], -co, co);
+          double ci = inner*inner - z*z;
+          if (ci > 0.0)
+            {
+            ci = sqrt(ci);
+            length -= vtkAnalyticPartialVolumeSourceOverlap(box[0], box[1], -ci, ci);
+            }
+          volume += zh*weights[n]*length;
+          }
+        }
+      return height*volume;
+      }
+
+    case TORUS:
+    default:
+      {
+      // Exact length along z, integrated over y and then x. In the x-y
+      // plane the torus covers the annulus between ringMin and ringMax,
+      // and the length along z reaches a box face on the circles of
+      // radius levels[].
+      double ring = this->RingRadius;
+      double r = this->CrossSectionRadius;
+      if (r <= 0.0)
+        {
+        return 0.0;
+        }
+      double ringMax = ring + r;
+      double ringMin = ring - r > 0.0 ? ring - r : 0.0;
+      double levels[4];
+      int numLevels = 0;
+      for (int b = 4; b < 6; b++)
+        {
+        double h = r*r - box[b]*box[b];
+        if (h > 0.0)
+          {
+          h = sqrt(h);
+          levels[numLevels++] = ring + h;
+          if (ring - h > 0.0)
+            {
+            levels[numLevels++] = ring - h;
+            }
+          }
+        }
+
+      double circles[6];
+      int numCircles = 0;
+      circles[numCircles++] = ringMax;
+      circles[numCircles++] = ringMin;
+      for (int l = 0; l < numLevels; l++)
+        {
+        circles[numCircles++] = levels[l];
+        }
+      vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                              ring*ring);
+      for (int c = 0; c < numCircles; c++)
+        {
+        vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                                circles[c]*circles[c]);
+        for (int a = 2; a < 4; a++)
+          {
+          vtkAnalyticPartialVolumeSourceAddBreaks(outerBreaks, numOuterBreaks,
+                                                  circles[c]*circles[c] - box[a]*box[a]);
+          }
+        }
+
+      double x0 = std::max(box[0], -ringMax), x1 = std::min(box[1], ringMax);
+      if (x0 >= x1)
+        {
+        return 0.0;
+        }
+      int numOuter = vtkAnalyticPartialVolumeSourceSplit(
+        x0, x1, outerBreaks, numOuterBreaks, outerEnds);
+      for (int p = 0; p < numOuter; p++)
+        {
+        double xc = 0.5*(outerEnds[p] + outerEnds[p+1]);
+        double xh = 0.5*(outerEnds[p+1] - outerEnds[p]);
+        for (int n = 0; n < numNodes; n++)
+          {
+          double x = xc + xh*nodes[n];
+          double yMax = ringMax*ringMax - x*x;
+          if (yMax <= 0.0)
+            {
+            continue;
+            }
+          yMax = sqrt(yMax);
+          double y0 = std::max(box[2], -yMax), y1 = std::min(box[3], yMax);
+          if (y0 >= y1)
+            {
+            continue;
+            }
+          int numInnerBreaks = 0;
+          for (int c = 1; c < numCircles; c++)
+            {
+            vtkAnalyticPartialVolumeSourceAddBreaks(innerBreaks, numInnerBreaks,
+                                                    circles[c]*circles[c] - x*x);
+            }
+          int numInner = vtkAnalyticPartialVolumeSourceSplit(
+            y0, y1, innerBreaks, numInnerBreaks, innerEnds);
+
+          double area = 0.0;
+          for (int q = 0; q < numInner; q++)
+            {
+            double yc = 0.5*(innerEnds[q] + innerEnds[q+1]);
+            double yh = 0.5*(innerEnds[q+1] - innerEnds[q]);
+            for (int m = 0; m < numNodes; m++)
+              {
+              double y = yc + yh*nodes[m];
+              double d = sqrt(x*x + y*y) - ring;
+              double t = r*r - d*d;
+              double zExtent = t > 0.0 ? sqrt(t) : 0.0;
+              area += yh*weights[m]*vtkAnalyticPartialVolumeSourceOverlap(
+                box[4], box[5], -zExtent, zExtent);
+              }
+            }
+          volume += xh*weights[n]*area;
+          }
+        }
+      return volume;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkAnalyticPartialVolumeSource::RequestInformation (
+  vtkInformation * vtkNotUsed(request),
+  vtkInformationVector** vtkNotUsed( inputVector ),
+  vtkInformationVector *outputVector)
+{
+  // get the info objects
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+
+  double origin[3], spacing[3];
+  this->ComputeOriginAndSpacing(origin, spacing);
+
+  outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
+  outInfo->Set(vtkDataObject::SPACING(), spacing, 3);
+  outInfo->Set(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
+               0, this->SampleDimensions[0] - 1,
+               0, this->SampleDimensions[1] - 1,
+               0, this->SampleDimensions[2] - 1);
+
+  vtkDataObject::SetPointDataActiveScalarInfo(outInfo, this->OutputScalarType, 1);
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+VTK_THREAD_RETURN_TYPE vtkAnalyticPartialVolumeSource::ThreadedExecute( void *arg )
+{
+  vtkAnalyticPartialVolumeSourceThreadInfo *info =
+    (vtkAnalyticPartialVolumeSourceThreadInfo *)
+    (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
+  vtkAnalyticPartialVolumeSource *self = info->Source;
+  int *dims = self->SampleDimensions;
+
+  double halfWidth[3];
+  for (int i = 0; i < 3; i++)
+    {
+    halfWidth[i] = 0.5*info->Spacing[i];
+    }
+  double halfDiagonal = sqrt(halfWidth[0]*halfWidth[0] +
+                             halfWidth[1]*halfWidth[1] +
+                             halfWidth[2]*halfWidth[2]);
+  double voxelVolume = 8.0*halfWidth[0]*halfWidth[1]*halfWidth[2];
+
+  // Hand out slices one at a time, since only the slices through the
+  // surface of the shape take much time.
+  while (true)
+    {
+    self->SliceMutex->Lock();
+    int k = self->NextSlice++;
+    self->SliceMutex->Unlock();
+
+    if (k >= dims[2])
+      {
+      break;
+      }
+
+    double x[3];
+    x[2] = info->Origin[2] + k*info->Spacing[2];
+    for (int j = 0; j < dims[1]; j++)
+      {
+      x[1] = info->Origin[1] + j*info->Spacing[1];
+      for (int i = 0; i < dims[0]; i++)
+        {
+        x[0] = info->Origin[0] + i*info->Spacing[0];
+
+        double fraction;
+        double distance = self->EvaluateDistanceBound(x);
+        if (distance >= halfDiagonal)
+          {
+          fraction = 0.0;
+          }
+        else if (distance <= -halfDiagonal)
+          {
+          fraction = 1.0;
+          }
+        else
+          {
+          double box[6];
+          for (int c = 0; c < 3; c++)
+            {
+            box[2*c]   = x[c] - halfWidth[c];
+            box[2*c+1] = x[c] + halfWidth[c];
+            }
+          fraction = self->ComputeBoxVolume(box) / voxelVolume;
+          fraction = fraction < 0.0 ? 0.0 : (fraction > 1.0 ? 1.0 : fraction);
+          }
+
+        vtkIdType idx = i + static_cast<vtkIdType>(dims[0])*(j + dims[1]*k);
+        info->Scalars->SetComponent(idx, 0, fraction);
+        }
+      }
+    }
+
+  return VTK_THREAD_RETURN_VALUE;
+}
+
+//----------------------------------------------------------------------------
+int vtkAnalyticPartialVolumeSource::RequestData(
+  vtkInformation* vtkNotUsed( request ),
+  vtkInformationVector** vtkNotUsed( inputVector ),
+  vtkInformationVector* outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkImageData *output = vtkImageData::SafeDownCast(
+    outInfo->Get(vtkDataObject::DATA_OBJECT()));
+
+  output->SetExtent(
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
+  output->AllocateScalars(this->OutputScalarType, 1);
+
+  vtkAnalyticPartialVolumeSourceThreadInfo info;
+  info.Source = this;
+  info.Scalars = output->GetPointData()->GetScalars();
+  this->ComputeOriginAndSpacing(info.Origin, info.Spacing);
+
+  // Gauss-Legendre points are the roots of the Legendre polynomial of
+  // degree QuadratureOrder, found by Newton's method.
+  int order = this->QuadratureOrder;
+  this->GaussNodes.resize(order);
+  this->GaussWeights.resize(order);
+  for (int i = 0; i < order; i++)
+    {
+    double x = cos(vtkMath::Pi()*(i + 0.75) / (order + 0.5));
+    double derivative = 1.0;
+    for (int iteration = 0; iteration < 100; iteration++)
+      {
+      double p0 = 1.0, p1 = x;
+      for (int n = 2; n <= order; n++)
+        {
+        double p2 = ((2*n - 1)*x*p1 - (n - 1)*p0) / n;
+        p0 = p1;
+        p1 = p2;
+        }
+      derivative = order*(x*p1 - p0) / (x*x - 1.0);
+      double step = p1 / derivative;
+      x -= step;
+      if (fabs(step) < 1e-15)
+        {
+        break;
+        }
+      }
+    this->GaussNodes[i] = x;
+    this->GaussWeights[i] = 2.0 / ((1.0 - x*x)*derivative*derivative);
+    }
+
+  this->NextSlice = 0;
+  this->Threader->SetNumberOfThreads(
+    std::min(this->NumberOfThreads, this->SampleDimensions[2]));
+  this->Threader->SetSingleMethod(vtkAnalyticPartialVolumeSource::ThreadedExecute,
+                                  (void *)&info);
+  this->Threader->SingleMethodExecute();
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkAnalyticPartialVolumeSource::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Shape: " << this->Shape << "\n";
+  os << indent << "Radii: (" << this->Radii[0] << ", " << this->Radii[1]
+     << ", " << this->Radii[2] << ")\n";
+  os << indent << "Radius: " << this->Radius << "\n";
+  os << indent << "InnerRadius: " << this->InnerRadius << "\n";
+  os << indent << "OuterRadius: " << this->OuterRadius << "\n";
+  os << indent << "Height: " << this->Height << "\n";
+  os << indent << "RingRadius: " << this->RingRadius << "\n";
+  os << indent << "CrossSectionRadius: " << this->CrossSectionRadius << "\n";
+  os << indent << "QuadratureOrder: " << this->QuadratureOrder << "\n";
+  os << indent << "Sample Dimensions: (" << this->SampleDimensions[0] << ", "
+               << this->SampleDimensions[1] << ", "
+               << this->SampleDimensions[2] << ")\n";
+  os << indent << "Model Bounds: \n";
+  os << indent << "  Xmin,Xmax: (" << this->ModelBounds[0] << ", "
+     << this->ModelBounds[1] << ")\n";
+  os << indent << "  Ymin,Ymax: (" << this->ModelBounds[2] << ", "
+     << this->ModelBounds[3] << ")\n";
+  os << indent << "  Zmin,Zmax: (" << this->ModelBounds[4] << ", "
+     << this->ModelBounds[5] << ")\n";
+  os << indent << "OutputScalarType: " << this->OutputScalarType << endl;
+}
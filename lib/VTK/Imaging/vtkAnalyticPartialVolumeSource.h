@@ -0,0 +1,183 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    $RCSfile: vtkAnalyticPartialVolumeSource.h,v $
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkAnalyticPartialVolumeSource - voxel coverage of primitive shapes
+// .SECTION Description
+// vtkAnalyticPartialVolumeSource produces the same kind of image as
+// vtkPartialVolumeModeller, the fraction of each voxel covered by a shape,
+// but computes it from the parameters of a primitive shape instead of
+// from a tetrahedral mesh. The shapes are placed the same way as the
+// corresponding volumetric sources and vtkAnalyticUniformPointSampler:
+// ellipsoids (and spheres) and tori are centered at the origin with the
+// torus ring in the x-y plane, and cylinders and hollow cylinders are
+// centered at the origin along the y axis.
+//
+// Voxels farther from the surface than half their diagonal are entirely
+// inside or outside and are set directly. For the others, the length of
+// the shape inside the voxel along one axis is computed exactly, and is
+// integrated over the other axes by Gauss-Legendre quadrature, split
+// where the shape's silhouette has kinks. Along the axis of cylinders
+// the coverage is exact.
+// .SECTION see also
+// vtkPartialVolumeModeller vtkAnalyticUniformPointSampler
+
+#ifndef __vtkAnalyticPartialVolumeSource_h
+#define __vtkAnalyticPartialVolumeSource_h
+
+#include "vtkImageAlgorithm.h"
+
+#include <vector>
+
+class vtkMultiThreader;
+class vtkSimpleCriticalSection;
+
+class vtkAnalyticPartialVolumeSource : public vtkImageAlgorithm
+{
+public:
+  static vtkAnalyticPartialVolumeSource *New();
+  vtkTypeMacro(vtkAnalyticPartialVolumeSource,vtkImageAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  enum {
+    ELLIPSOID = 0,
+    CYLINDER,
+    HOLLOW_CYLINDER,
+    TORUS
+  };
+
+  // Description:
+  // Shape to voxelize.
+  vtkSetClampMacro(Shape, int, ELLIPSOID, TORUS);
+  vtkGetMacro(Shape, int);
+  void SetShapeToEllipsoid()      {this->SetShape(ELLIPSOID);};
+  void SetShapeToCylinder()       {this->SetShape(CYLINDER);};
+  void SetShapeToHollowCylinder() {this->SetShape(HOLLOW_CYLINDER);};
+  void SetShapeToTorus()          {this->SetShape(TORUS);};
+
+  // Description:
+  // Semi-axis lengths of the ellipsoid.
+  vtkSetVector3Macro(Radii, double);
+  vtkGetVector3Macro(Radii, double);
+
+  // Description:
+  // Radius of the cylinder.
+  vtkSetClampMacro(Radius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Radius, double);
+
+  // Description:
+  // Radii of the hollow cylinder.
+  vtkSetClampMacro(InnerRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(InnerRadius, double);
+  vtkSetClampMacro(OuterRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(OuterRadius, double);
+
+  // Description:
+  // Height of the cylinder and hollow cylinder.
+  vtkSetClampMacro(Height, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(Height, double);
+
+  // Description:
+  // Radii of the torus.
+  vtkSetClampMacro(RingRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(RingRadius, double);
+  vtkSetClampMacro(CrossSectionRadius, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(CrossSectionRadius, double);
+
+  // Description:
+  // Number of Gauss-Legendre points per axis in each smooth piece of a
+  // voxel that the surface crosses. Default is 6.
+  vtkSetClampMacro(QuadratureOrder, int, 1, 16);
+  vtkGetMacro(QuadratureOrder, int);
+
+  // Description:
+  // Get the bounds of the shape from its current parameters.
+  void GetShapeBounds(double bounds[6]);
+
+  // Description:
+  // Set the i-j-k dimensions of the image. Default is (50, 50, 50).
+  vtkSetVector3Macro(SampleDimensions, int);
+  vtkGetVectorMacro(SampleDimensions, int, 3);
+
+  // Description:
+  // Specify the region in space to voxelize. The first and last voxel
+  // centers lie on the bounds. Default is (0, 0, 0, 0, 0, 0), which
+  // uses the bounds of the shape.
+  vtkSetVector6Macro(ModelBounds, double);
+  vtkGetVectorMacro(ModelBounds, double, 6);
+
+  // Description:
+  // Control the scalar type of the output image. The default is
+  // VTK_DOUBLE.
+  vtkSetMacro(OutputScalarType,int);
+  void SetOutputScalarTypeToFloat(){this->SetOutputScalarType(VTK_FLOAT);};
+  void SetOutputScalarTypeToDouble(){this->SetOutputScalarType(VTK_DOUBLE);};
+  vtkGetMacro(OutputScalarType,int);
+
+protected:
+  vtkAnalyticPartialVolumeSource();
+  ~vtkAnalyticPartialVolumeSource();
+
+  int    Shape;
+  double Radii[3];
+  double Radius;
+  double InnerRadius;
+  double OuterRadius;
+  double Height;
+  double RingRadius;
+  double CrossSectionRadius;
+  int    QuadratureOrder;
+
+  int    SampleDimensions[3];
+  double ModelBounds[6];
+  int    OutputScalarType;
+
+  // Description:
+  // Gauss-Legendre points and weights on [-1, 1] of QuadratureOrder.
+  std::vector<double> GaussNodes;
+  std::vector<double> GaussWeights;
+
+  vtkMultiThreader         *Threader;
+  int                       NumberOfThreads;
+  vtkSimpleCriticalSection *SliceMutex;
+  int                       NextSlice;
+
+  // Description:
+  // Compute the origin and spacing of the image.
+  void ComputeOriginAndSpacing(double origin[3], double spacing[3]);
+
+  // Description:
+  // Lower bound on the distance from a point to the surface of the
+  // shape, negative inside.
+  double EvaluateDistanceBound(const double x[3]);
+
+  // Description:
+  // Volume of the intersection of the shape with the box
+  // [xmin, xmax] x [ymin, ymax] x [zmin, zmax].
+  double ComputeBoxVolume(const double box[6]);
+
+  static VTK_THREAD_RETURN_TYPE ThreadedExecute( void *arg );
+
+  virtual int RequestInformation(vtkInformation *,
+                                 vtkInformationVector **,
+                                 vtkInformationVector *);
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **,
+                          vtkInformationVector *);
+
+private:
+  vtkAnalyticPartialVolumeSource(const vtkAnalyticPartialVolumeSource&);  // Not implemented.
+  void operator=(const vtkAnalyticPartialVolumeSource&);  // Not implemented.
+};
+
+#endif
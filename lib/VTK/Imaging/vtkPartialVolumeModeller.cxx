@@ -14,34 +14,436 @@
 =========================================================================*/
 #include "vtkPartialVolumeModeller.h"
 
-#include "vtkBoxClipDataSet.h"
-#include "vtkCell.h"
-#include "vtkCellLocator.h"
 #include "vtkCriticalSection.h"
-#include "vtkDataSetSurfaceFilter.h"
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
 #include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMultiThreader.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
-#include "vtkRectilinearGrid.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
-#include "vtkStructuredGrid.h"
-#include "vtkTetra.h"
-#include "vtkUnstructuredGrid.h"
 
 #include <math.h>
 
+#include <algorithm>
+
 vtkStandardNewMacro(vtkPartialVolumeModeller);
 
+// Nonzero voxels of one tile found by one thread, as a range of the
+// thread's sparse output.
+struct vtkPartialVolumeModellerBlock
+{
+  vtkIdType Bin;
+  int       Thread;
+  vtkIdType Begin;
+  vtkIdType End;
+
+  bool operator<(const vtkPartialVolumeModellerBlock& other) const
+  {
+    return this->Bin < other.Bin;
+  }
+};
+
+// Sparse output of one thread.
+struct vtkPartialVolumeModellerSparseBuffer
+{
+  std::vector<float>                         Points;
+  std::vector<float>                         Values;
+  std::vector<vtkPartialVolumeModellerBlock> Blocks;
+};
+
 struct vtkPartialVolumeModellerThreadInfo
 {
   vtkPartialVolumeModeller *Modeller;
-  vtkDataSet               **Input;
+  double                    Origin[3];
+  double                    Spacing[3];
+
+  // Dense output, or NULL if only the sparse output is generated.
+  vtkDataArray *Scalars;
+
+  // Sparse output of each thread, if it is generated.
+  std::vector<vtkPartialVolumeModellerSparseBuffer> Sparse;
+};
+
+// Edge length, in voxels, of the bins that index the tetrahedra.
+static const int BIN_SIZE = 8;
+
+//----------------------------------------------------------------------------
+// Largest number of vertices of a polygon clipped by the kernel: a
+// triangle clipped by the six faces of a box, or a rectangle clipped by
+// the four faces of a tetrahedron, gains at most one vertex per plane.
+static const int MAX_POLYGON_VERTICES = 16;
+
+//----------------------------------------------------------------------------
+// Clips a convex polygon against the half-space normal.x <= offset.
+// Vertices within tolerance of the plane count as inside. Returns the
+// number of vertices written to result.
+static int vtkPartialVolumeModellerClipPolygon(double polygon[][3], int numVertices,
+                                               const double normal[3], double offset,
+                                               double tolerance, double result[][3])
+{
+  int numResult = 0;
+  for (int v = 0; v < numVertices; v++)
+    {
+    const double *a = polygon[v];
+    const double *b = polygon[(v + 1) % numVertices];
+    double da = normal[0]*a[0] + normal[1]*a[1] + normal[2]*a[2] - offset;
+    double db = normal[0]*b[0] + normal[1]*b[1] + normal[2]*b[2] - offset;
+    bool aInside = da <= tolerance;
+    bool bInside = db <= tolerance;
+    if (aInside)
+      {
+      result[numResult][0] = a[0];
+      result[numResult][1] = a[1];
+      result[numResult][2] = a[2];
+      numResult++;
+      }
+    if (aInside != bInside && da != db)
+      {
+      double t = da / (da - db);
+      t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+      result[numResult][0] = a[0] + t*(b[0] - a[0]);
+      result[numResult][1] = a[1] + t*(b[1] - a[1]);
+      result[numResult][2] = a[2] + t*(b[2] - a[2]);
+      numResult++;
+      }
+    }
+  return numResult;
+}
+
+//----------------------------------------------------------------------------
+// Twice the vector area of a planar polygon; its length is twice the
+// area and its direction follows the winding of the vertices.
+static void vtkPartialVolumeModellerPolygonArea(double polygon[][3], int numVertices,
+                                                double area[3])
+{
+  area[0] = area[1] = area[2] = 0.0;
+  for (int v = 0; v < numVertices; v++)
+    {
+    const double *a = polygon[v];
+    const double *b = polygon[(v + 1) % numVertices];
+    area[0] += a[1]*b[2] - a[2]*b[1];
+    area[1] += a[2]*b[0] - a[0]*b[2];
+    area[2] += a[0]*b[1] - a[1]*b[0];
+    }
+}
+
+//----------------------------------------------------------------------------
+// Volume of the intersection of a tetrahedron with the axis-aligned box
+// [-h,h] centered at the origin. Tetrahedron vertices are given relative
+// to the box center.
+//
+// By the divergence theorem, the volume of a polyhedron is one third of
+// the integral of x.n over its boundary, and on a planar face x.n is the
+// constant distance of the plane from the origin. The boundary of the
+// intersection consists of the parts of the tetrahedron faces inside the
+// box and the parts of the box faces inside the tetrahedron, each a
+// convex polygon obtained by clipping. Where a tetrahedron face lies on
+// a box face with the same outward direction, only the box face counts.
+static double vtkPartialVolumeModellerBoxTetraVolume(const double h[3],
+                                                     const double tetra[4][3])
+{
+  double boxVolume = 8.0*h[0]*h[1]*h[2];
+
+  double e1[3], e2[3], e3[3];
+  for (int c = 0; c < 3; c++)
+    {
+    e1[c] = tetra[1][c] - tetra[0][c];
+    e2[c] = tetra[2][c] - tetra[0][c];
+    e3[c] = tetra[3][c] - tetra[0][c];
+    }
+  double det = e1[0]*(e2[1]*e3[2] - e2[2]*e3[1]) +
+               e1[1]*(e2[2]*e3[0] - e2[0]*e3[2]) +
+               e1[2]*(e2[0]*e3[1] - e2[1]*e3[0]);
+  double tetraVolume = fabs(det) / 6.0;
+  if (tetraVolume <= 0.0)
+    {
+    return 0.0;
+    }
+
+  // Bounding box test, and the tetrahedron inside the box.
+  bool tetraInsideBox = true;
+  for (int c = 0; c < 3; c++)
+    {
+    double lo = tetra[0][c], hi = tetra[0][c];
+    for (int v = 1; v < 4; v++)
+      {
+      lo = tetra[v][c] < lo ? tetra[v][c] : lo;
+      hi = tetra[v][c] > hi ? tetra[v][c] : hi;
+      }
+    if (hi <= -h[c] || lo >= h[c])
+      {
+      return 0.0;
+      }
+    if (lo < -h[c] || hi > h[c])
+      {
+      tetraInsideBox = false;
+      }
+    }
+  if (tetraInsideBox)
+    {
+    return tetraVolume;
+    }
+
+  // Faces with outward normals; face f is opposite vertex f.
+  double faces[4][3][3];
+  double normals[4][3];
+  double offsets[4];
+  bool boxInsideTetra = true;
+  for (int f = 0; f < 4; f++)
+    {
+    const double *a = tetra[(f + 1) % 4];
+    const double *b = tetra[(f + 2) % 4];
+    const double *c = tetra[(f + 3) % 4];
+    const double *opposite = tetra[f];
+    double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+    double ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+    double *n = normals[f];
+    n[0] = ab[1]*ac[2] - ab[2]*ac[1];
+    n[1] = ab[2]*ac[0] - ab[0]*ac[2];
+    n[2] = ab[0]*ac[1] - ab[1]*ac[0];
+    bool flip = n[0]*(opposite[0] - a[0]) + n[1]*(opposite[1] - a[1]) +
+      n[2]*(opposite[2] - a[2]) > 0.0;
+    for (int c2 = 0; c2 < 3; c2++)
+      {
+      if (flip)
+        {
+        n[c2] = -n[c2];
+        }
+      faces[f][0][c2] = a[c2];
+      faces[f][1][c2] = flip ? c[c2] : b[c2];
+      faces[f][2][c2] = flip ? b[c2] : c[c2];
+      }
+    offsets[f] = n[0]*a[0] + n[1]*a[1] + n[2]*a[2];
+
+    // Range of n.x - offset over the box.
+    double spread = fabs(n[0])*h[0] + fabs(n[1])*h[1] + fabs(n[2])*h[2];
+    if (-offsets[f] - spread >= 0.0)
+      {
+      return 0.0;
+      }
+    if (spread - offsets[f] > 0.0)
+      {
+      boxInsideTetra = false;
+      }
+    }
+  if (boxInsideTetra)
+    {
+    return boxVolume;
+    }
+
+  double hMax = h[0] > h[1] ? (h[0] > h[2] ? h[0] : h[2]) : (h[1] > h[2] ? h[1] : h[2]);
+  double tolerance = 1e-9*hMax;
+
+  double bufferA[MAX_POLYGON_VERTICES][3], bufferB[MAX_POLYGON_VERTICES][3];
+  double area[3];
+  double sum = 0.0;
+
+  // Tetrahedron faces clipped to the box.
+  for (int f = 0; f < 4; f++)
+    {
+    const double *n = normals[f];
+    double nLength = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+
+    bool onBoxFace = false;
+    for (int c = 0; c < 3 && !onBoxFace; c++)
+      {
+      int c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+      if (fabs(n[c1]) <= 1e-9*nLength && fabs(n[c2]) <= 1e-9*nLength)
+        {
+        double side = n[c] > 0.0 ? 1.0 : -1.0;
+        onBoxFace = fabs(faces[f][0][c] - side*h[c]) <= tolerance;
+        }
+      }
+    if (onBoxFace)
+      {
+      continue;
+      }
+
+    double (*polygon)[3] = bufferA;
+    double (*clipped)[3] = bufferB;
+    int numVertices = 3;
+    for (int v = 0; v < 3; v++)
+      {
+      polygon[v][0] = faces[f][v][0];
+      polygon[v][1] = faces[f][v][1];
+      polygon[v][2] = faces[f][v][2];
+      }
+    for (int plane = 0; plane < 6 && numVertices > 0; plane++)
+      {
+      double boxNormal[3] = {0.0, 0.0, 0.0};
+      boxNormal[plane/2] = (plane % 2) ? 1.0 : -1.0;
+      numVertices = vtkPartialVolumeModellerClipPolygon
+        (polygon, numVertices, boxNormal, h[plane/2], tolerance, clipped);
+      double (*swap)[3] = polygon;
+      polygon = clipped;
+      clipped = swap;
+      }
+    if (numVertices < 3)
+      {
+      continue;
+      }
+    vtkPartialVolumeModellerPolygonArea(polygon, numVertices, area);
+    sum += 0.5*(faces[f][0][0]*area[0] + faces[f][0][1]*area[1] +
+                faces[f][0][2]*area[2]);
+    }
+
+  // Box faces clipped to the tetrahedron.
+  for (int plane = 0; plane < 6; plane++)
+    {
+    int c = plane/2, c1 = (c + 1) % 3, c2 = (c + 2) % 3;
+    double side = (plane % 2) ? 1.0 : -1.0;
+    double (*polygon)[3] = bufferA;
+    double (*clipped)[3] = bufferB;
+    static const double corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+    for (int v = 0; v < 4; v++)
+      {
+      polygon[v][c]  = side*h[c];
+      polygon[v][c1] = corners[v][0]*h[c1];
+      polygon[v][c2] = corners[v][1]*h[c2];
+      }
+    int numVertices = 4;
+    for (int f = 0; f < 4 && numVertices > 0; f++)
+      {
+      const double *n = normals[f];
+      double nLength = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+      numVertices = vtkPartialVolumeModellerClipPolygon
+        (polygon, numVertices, n, offsets[f], tolerance*nLength, clipped);
+      double (*swap)[3] = polygon;
+      polygon = clipped;
+      clipped = swap;
+      }
+    if (numVertices < 3)
+      {
+      continue;
+      }
+    vtkPartialVolumeModellerPolygonArea(polygon, numVertices, area);
+    sum += 0.5*h[c]*fabs(area[c]);
+    }
+
+  double volume = sum / 3.0;
+  if (volume < 0.0)
+    {
+    volume = 0.0;
+    }
+  if (volume > tetraVolume)
+    {
+    volume = tetraVolume;
+    }
+  if (volume > boxVolume)
+    {
+    volume = boxVolume;
+    }
+  return volume;
+}
+
+//----------------------------------------------------------------------------
+// Range of voxel indices along each axis whose voxels overlap the given
+// bounds, clamped to the grid. An axis with no such voxel gets an upper
+// index below the lower one.
+static void vtkPartialVolumeModellerVoxelRange(const double bounds[6],
+                                               const double origin[3],
+                                               const double spacing[3],
+                                               const int dims[3],
+                                               int range[6])
+{
+  for (int c = 0; c < 3; c++)
+    {
+    double halfWidth = 0.5*spacing[c];
+    double lo = ceil((bounds[2*c] - halfWidth - origin[c]) / spacing[c]);
+    double hi = floor((bounds[2*c+1] + halfWidth - origin[c]) / spacing[c]);
+    lo = lo < 0.0 ? 0.0 : lo;
+    hi = hi > dims[c] - 1 ? dims[c] - 1 : hi;
+    range[2*c]   = static_cast<int>(lo);
+    range[2*c+1] = lo <= hi ? static_cast<int>(hi) : -1;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Where the ray along +x through (y, z) crosses a triangle. Returns 0 if
+// it misses. The triangle is projected onto the y-z plane, and a ray
+// through an edge or a vertex is assigned to exactly one of the triangles
+// sharing it by the top-left rule of rasterization, so that a closed
+// surface is crossed an even number of times.
+static int vtkPartialVolumeModellerRayCrossing(const double tri[9],
+                                               double y, double z,
+                                               double &x)
+{
+  const double *a = tri;
+  const double *b = tri + 3;
+  const double *c = tri + 6;
+
+  double area = (b[1] - a[1])*(c[2] - a[2]) - (b[2] - a[2])*(c[1] - a[1]);
+  if (area == 0.0)
+    {
+    return 0;
+    }
+  if (area < 0.0)
+    {
+    const double *tmp = b;
+    b = c;
+    c = tmp;
+    area = -area;
+    }
+
+  const double *edges[3][2] = {{b, c}, {c, a}, {a, b}};
+  double weights[3];
+  for (int e = 0; e < 3; e++)
+    {
+    const double *p = edges[e][0];
+    const double *q = edges[e][1];
+    double du = q[1] - p[1];
+    double dv = q[2] - p[2];
+    weights[e] = du*(z - p[2]) - dv*(y - p[1]);
+    if (weights[e] < 0.0)
+      {
+      return 0;
+      }
+    if (weights[e] == 0.0 && !(dv < 0.0 || (dv == 0.0 && du < 0.0)))
+      {
+      return 0;
+      }
+    }
+
+  x = (weights[0]*a[0] + weights[1]*b[0] + weights[2]*c[0]) / area;
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+// Face of a tetrahedron, identified by its sorted point ids.
+struct vtkPartialVolumeModellerFace
+{
+  vtkIdType Ids[3];
+  vtkIdType Tetra;
+  int       Face;
+
+  bool operator<(const vtkPartialVolumeModellerFace& other) const
+  {
+    for (int i = 0; i < 3; i++)
+      {
+      if (this->Ids[i] != other.Ids[i])
+        {
+        return this->Ids[i] < other.Ids[i];
+        }
+      }
+    return false;
+  }
+
+  bool SameAs(const vtkPartialVolumeModellerFace& other) const
+  {
+    return this->Ids[0] == other.Ids[0] && this->Ids[1] == other.Ids[1] &&
+      this->Ids[2] == other.Ids[2];
+  }
 };
 
+
 // Construct an instance of vtkPartialVolumeModeller with its sample dimensions
 // set to (50,50,50), and so that the model bounds are
 // automatically computed from its input. The maximum distance is set to
@@ -62,11 +464,20 @@ vtkPartialVolumeModeller::vtkPartialVolumeModeller()
   this->SampleDimensions[1] = 50;
   this->SampleDimensions[2] = 50;
 
+  this->BinDimensions[0] = 0;
+  this->BinDimensions[1] = 0;
+  this->BinDimensions[2] = 0;
+
   this->OutputScalarType = VTK_DOUBLE;
+  this->GenerateDenseOutput = 1;
 
   this->Threader        = vtkMultiThreader::New();
   this->NumberOfThreads = this->Threader->GetNumberOfThreads();
   this->ProgressMutex = new vtkSimpleCriticalSection;
+  this->TileMutex = new vtkSimpleCriticalSection;
+  this->NextTile = 0;
+
+  this->SetNumberOfOutputPorts(2);
 }
 
 //----------------------------------------------------------------------------
@@ -81,6 +492,11 @@ vtkPartialVolumeModeller::~vtkPartialVolumeModeller()
     {
     delete this->ProgressMutex;
     }
+
+  if (this->TileMutex)
+    {
+    delete this->TileMutex;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -148,67 +564,18 @@ int vtkPartialVolumeModeller::RequestInformation (
 VTK_THREAD_RETURN_TYPE vtkPartialVolumeModeller::ThreadedExecute( void *arg )
 {
   int threadId = ((vtkMultiThreader::ThreadInfo *)(arg))->ThreadID;
-  int threadCount = ((vtkMultiThreader::ThreadInfo *)(arg))->NumberOfThreads;
   vtkPartialVolumeModellerThreadInfo *userData = (vtkPartialVolumeModellerThreadInfo *)
     (((vtkMultiThreader::ThreadInfo *)(arg))->UserData);
 
-  vtkDataSet *input = userData->Input[threadId];
-
-  // Extract the grid boundaries
-  vtkDataSetSurfaceFilter *surfaceFilter = vtkDataSetSurfaceFilter::New();
-  surfaceFilter->SetInputData(input);
-  surfaceFilter->Update();
-
-  // Set up a locator
-  vtkCellLocator *locator = vtkCellLocator::New();
-  locator->SetDataSet(surfaceFilter->GetOutput());
-  locator->AutomaticOn();
-  locator->SetNumberOfCellsPerBucket(1);
-  locator->CacheCellBoundsOn();
-  locator->BuildLocator();
-
-  // Generic cell to use when locating cells
-  vtkGenericCell *cell = vtkGenericCell::New();
-
-  vtkImageData *output = userData->Modeller->GetOutput();
-  double *spacing = output->GetSpacing();
-  double *origin = output->GetOrigin();
-
-  int *sampleDimensions = userData->Modeller->GetSampleDimensions();
-  if (!output->GetPointData()->GetScalars())
-    {
-    vtkGenericWarningMacro("No output scalars defined.");
-    surfaceFilter->Delete();
-    locator->Delete();
-    cell->Delete();
+  vtkPartialVolumeModeller *self = userData->Modeller;
 
-    return VTK_THREAD_RETURN_VALUE;
-    }
+  double *spacing = userData->Spacing;
+  double *origin = userData->Origin;
 
-  // break up into slabs based on threadId and threadCount
-  int slabSize = sampleDimensions[2] / threadCount;
-  int slabSizeExtra = slabSize + 1; // For slabs with an extra layer
-  int numThreadsWithExtraLayer = sampleDimensions[2] % threadCount;
-
-  int slabMin, slabMax;
-  if (threadId < numThreadsWithExtraLayer)
-    {
-    slabMin = threadId * slabSizeExtra;
-    slabMax = slabMin + slabSizeExtra - 1;
-    }
-  else
-    {
-    slabMin = numThreadsWithExtraLayer * slabSizeExtra +
-      (threadId - numThreadsWithExtraLayer) * slabSize;
-    slabMax = slabMin + slabSize - 1;
-    }
-  if (slabMin >= sampleDimensions[2])
-    {
-    return VTK_THREAD_RETURN_VALUE;
-    }
-
-  double *weights = new double[input->GetMaxCellSize()];
-  vtkDataArray *newScalars = output->GetPointData()->GetScalars();
+  int *sampleDimensions = self->GetSampleDimensions();
+  vtkDataArray *newScalars = userData->Scalars;
+  vtkPartialVolumeModellerSparseBuffer *sparse = userData->Sparse.empty() ?
+    NULL : &userData->Sparse[threadId];
 
   //
   // Voxel widths are 1/2 the height, width, length of a voxel
@@ -219,141 +586,170 @@ VTK_THREAD_RETURN_TYPE vtkPartialVolumeModeller::ThreadedExecute( void *arg )
     voxelHalfWidth[i] = spacing[i] / 2.0;
     }
 
-  double voxelRadius = sqrt(voxelHalfWidth[0]*voxelHalfWidth[0] +
-                            voxelHalfWidth[1]*voxelHalfWidth[1] +
-                            voxelHalfWidth[2]*voxelHalfWidth[2]);
-
-  // Set up the box clipping filter
-  vtkBoxClipDataSet *clipper = vtkBoxClipDataSet::New();
-  clipper->SetInputData(input);
-  clipper->SetOrientation(0);
-
-  // Compute the volume of a filled voxel.
-  double fullVoxelVolume = spacing[0]*spacing[1]*spacing[2];
+  int jkFactor = sampleDimensions[0]*sampleDimensions[1];
+  double voxelProgressWeight = 1.0 /
+    (static_cast<double>(jkFactor)*sampleDimensions[2]);
+  const int *binDimensions = self->BinDimensions;
+  vtkIdType numTiles = static_cast<vtkIdType>(self->TileOrder.size());
 
   //
-  // Traverse all voxels, computing partial volume intersecton on all points.
+  // Work is concentrated near the surface of the input, so the grid is
+  // handed out one tile (one bin of voxels) at a time, most expensive
+  // tiles first, rather than split into fixed slabs.
   //
-  int jkFactor = sampleDimensions[0]*sampleDimensions[1];
-  double threadTotalVoxels = static_cast< double >( (slabMax - slabMin + 1) * jkFactor );
-  int numThreads = userData->Modeller->Threader->GetNumberOfThreads();
-  double voxelProgressWeight = 1.0 / threadTotalVoxels;
-  double voxelPoint[3];
-  int count = 0;
-  for (int k = slabMin; k <= slabMax; k++)
-    {
-    voxelPoint[2] = static_cast<double>(k)*spacing[2] + origin[2];
-    double zmin = voxelPoint[2] - voxelHalfWidth[2];
-    double zmax = voxelPoint[2] + voxelHalfWidth[2];
-    for (int j = 0; j < sampleDimensions[1]; j++)
-      {
-      voxelPoint[1] = static_cast<double>(j)*spacing[1] + origin[1];
-      double ymin = voxelPoint[1] - voxelHalfWidth[1];
-      double ymax = voxelPoint[1] + voxelHalfWidth[1];
-      for (int i = 0; i < sampleDimensions[0]; i++)
+  while (true)
+    {
+    self->TileMutex->Lock();
+    vtkIdType tileIndex = self->NextTile++;
+    self->TileMutex->Unlock();
+
+    if (tileIndex >= numTiles)
+      {
+      break;
+      }
+
+    vtkIdType bin = self->TileOrder[tileIndex];
+    int tile[3];
+    tile[0] = static_cast<int>(bin % binDimensions[0]);
+    tile[1] = static_cast<int>((bin / binDimensions[0]) % binDimensions[1]);
+    tile[2] = static_cast<int>(bin / (static_cast<vtkIdType>(binDimensions[0])*binDimensions[1]));
+
+    int extent[6];
+    for (int c = 0; c < 3; c++)
+      {
+      extent[2*c]   = tile[c]*BIN_SIZE;
+      extent[2*c+1] = std::min(extent[2*c] + BIN_SIZE, sampleDimensions[c]) - 1;
+      }
+
+    //
+    // Traverse the voxels of the tile. Voxels away from the surface are
+    // entirely inside or outside, which the parity of the crossings of
+    // their row before their center tells. Voxels in the surface band
+    // sum the volumes of their intersections with the tetrahedra in
+    // their bin.
+    //
+    vtkIdType binBegin = self->BinOffsets[bin];
+    vtkIdType binEnd = self->BinOffsets[bin+1];
+    double voxelPoint[3];
+    for (int k = extent[4]; k <= extent[5]; k++)
+      {
+      voxelPoint[2] = static_cast<double>(k)*spacing[2] + origin[2];
+      for (int j = extent[2]; j <= extent[3]; j++)
         {
-        voxelPoint[0] = static_cast<double>(i)*spacing[0] + origin[0];
-        double xmin = voxelPoint[0] - voxelHalfWidth[0];
-        double xmax = voxelPoint[0] + voxelHalfWidth[0];
-
-        // Look for the closest point on the surface. If it is outside the voxel,
-        // we can skip the expensive box clipping.
-        double closestPoint[3];
-        vtkIdType cellId;
-        int subId;
-        double dist2;
-        int cellFound =
-          locator->FindClosestPointWithinRadius(voxelPoint, voxelRadius,
-                                                closestPoint, cell, cellId,
-                                                subId, dist2);
-
-        bool boundaryIntersectsVoxel = cellFound == 1 &&
-          closestPoint[0] >= xmin && closestPoint[0] <= xmax &&
-          closestPoint[1] >= ymin && closestPoint[1] <= ymax &&
-          closestPoint[2] >= zmin && closestPoint[2] <= zmax;
-
-        double volume = 0.0;
-        if (boundaryIntersectsVoxel)
+        voxelPoint[1] = static_cast<double>(j)*spacing[1] + origin[1];
+
+        vtkIdType row = j + static_cast<vtkIdType>(sampleDimensions[1])*k;
+        std::vector<double>::const_iterator rowStart =
+          self->RowCrossings.begin() + self->RowOffsets[row];
+        std::vector<double>::const_iterator rowEnd =
+          self->RowCrossings.begin() + self->RowOffsets[row+1];
+        std::vector<double>::const_iterator crossing =
+          std::lower_bound(rowStart, rowEnd,
+                           static_cast<double>(extent[0])*spacing[0] + origin[0]);
+
+        for (int i = extent[0]; i <= extent[1]; i++)
           {
-          // We need to clip with the voxel bounds and compute the volume of the intersection
-          // Update the box dimensions in the clipper
-          clipper->SetBoxClip(voxelPoint[0] - voxelHalfWidth[0], voxelPoint[0] + voxelHalfWidth[0],
-                              voxelPoint[1] - voxelHalfWidth[1], voxelPoint[1] + voxelHalfWidth[1],
-                              voxelPoint[2] - voxelHalfWidth[2], voxelPoint[2] + voxelHalfWidth[2]);
-          clipper->Update();
-
-          // Get the output tetrahedra from the clipper and compute the sum of their volumes
-          vtkUnstructuredGrid* intersection = clipper->GetOutput();
-          int numCells = intersection->GetNumberOfCells();
-          for (int cellNum = 0; cellNum < numCells; cellNum++)
+          voxelPoint[0] = static_cast<double>(i)*spacing[0] + origin[0];
+          int idx = jkFactor*k + sampleDimensions[0]*j + i;
+
+          while (crossing != rowEnd && *crossing < voxelPoint[0])
             {
-            vtkCell *cell = intersection->GetCell(cellNum);
-            if (cell->GetCellType() == VTK_TETRA)
-              {
-              vtkTetra* tet = vtkTetra::SafeDownCast(cell);
-              vtkPoints* pts = tet->GetPoints();
-              double p0[3], p1[3], p2[3], p3[3];
-              pts->GetPoint(0, p0);
-              pts->GetPoint(1, p1);
-              pts->GetPoint(2, p2);
-              pts->GetPoint(3, p3);
-              double cellVolume = vtkTetra::ComputeVolume(p0, p1, p2, p3);
-
-              // Should really check for negative volume elements here, but it's not
-              // clear what the right course of action is in that case.
-              volume += cellVolume;
-              }
+            ++crossing;
             }
-          }
-        else // no boundary intersection with voxel
-          {
-          // The voxel is either completely inside the grid or completely outside the grid.
-          // We need to determine which.
-          double pcoords[3];
-          cellId = input->FindCell(voxelPoint, NULL, 0, 1e-5, subId, pcoords, weights);
-          if (cellId == -1)
+          double fraction;
+          if (!self->SurfaceBand[idx])
             {
-            volume = 0.0;
+            fraction = (crossing - rowStart) % 2 ? 1.0 : 0.0;
             }
           else
             {
-            volume = fullVoxelVolume;
+            fraction = self->ComputeVoxelFraction(binBegin, binEnd,
+                                                  voxelPoint, voxelHalfWidth);
             }
-          }
-
-        int idx = jkFactor*k + sampleDimensions[0]*j + i;
-        newScalars->SetComponent(idx, 0, volume / fullVoxelVolume);
 
-        if (count == 50)
-          {
-          userData->Modeller->UpdateThreadProgress(voxelProgressWeight*count);
-          count = 0;
-
-          if (threadId == 0)
+          if (newScalars)
             {
-            userData->Modeller->UpdateProgress( userData->Modeller->TotalProgress );
+            newScalars->SetComponent(idx, 0, fraction);
+            }
+          // Same cut-off as thresholding the dense output, so round-off
+          // slivers do not become fluorophores.
+          if (sparse && fraction >= 1e-9)
+            {
+            sparse->Points.push_back(static_cast<float>(voxelPoint[0]));
+            sparse->Points.push_back(static_cast<float>(voxelPoint[1]));
+            sparse->Points.push_back(static_cast<float>(voxelPoint[2]));
+            sparse->Values.push_back(static_cast<float>(fraction));
             }
           }
-        ++count;
         }
       }
-    }
 
-  // Report the remnants
-  userData->Modeller->UpdateThreadProgress(voxelProgressWeight*count);
-  if (threadId == 0)
-    {
-    userData->Modeller->UpdateProgress( userData->Modeller->TotalProgress );
+    if (sparse)
+      {
+      vtkPartialVolumeModellerBlock block;
+      block.Bin = bin;
+      block.Thread = threadId;
+      block.End = static_cast<vtkIdType>(sparse->Values.size());
+      block.Begin = sparse->Blocks.empty() ? 0 : sparse->Blocks.back().End;
+      if (block.End > block.Begin)
+        {
+        sparse->Blocks.push_back(block);
+        }
+      }
+
+    int tileVoxels = (extent[1] - extent[0] + 1)*(extent[3] - extent[2] + 1)*
+      (extent[5] - extent[4] + 1);
+    self->UpdateThreadProgress(voxelProgressWeight*tileVoxels);
+    if (threadId == 0)
+      {
+      self->UpdateProgress( self->TotalProgress );
+      }
     }
 
-  clipper->Delete();
-  surfaceFilter->Delete();
-  locator->Delete();
-  cell->Delete();
+  return VTK_THREAD_RETURN_VALUE;
+}
 
-  delete [] weights;
+//----------------------------------------------------------------------------
+// Sum the volumes of the intersections of a voxel with the tetrahedra
+// in the range [binBegin, binEnd) of BinTetra.
+double vtkPartialVolumeModeller::ComputeVoxelFraction(vtkIdType binBegin,
+                                                      vtkIdType binEnd,
+                                                      const double center[3],
+                                                      const double halfWidth[3])
+{
+  double xmin = center[0] - halfWidth[0], xmax = center[0] + halfWidth[0];
+  double ymin = center[1] - halfWidth[1], ymax = center[1] + halfWidth[1];
+  double zmin = center[2] - halfWidth[2], zmax = center[2] + halfWidth[2];
 
-  return VTK_THREAD_RETURN_VALUE;
+  double volume = 0.0;
+  for (vtkIdType b = binBegin; b < binEnd; b++)
+    {
+    vtkIdType tetraId = this->BinTetra[b];
+    const double *bounds = &this->TetraBounds[6*tetraId];
+    if (bounds[1] <= xmin || bounds[0] >= xmax ||
+        bounds[3] <= ymin || bounds[2] >= ymax ||
+        bounds[5] <= zmin || bounds[4] >= zmax)
+      {
+      continue;
+      }
+
+    const double *vertices = &this->TetraVertices[12*tetraId];
+    double tetra[4][3];
+    for (int v = 0; v < 4; v++)
+      {
+      tetra[v][0] = vertices[3*v+0] - center[0];
+      tetra[v][1] = vertices[3*v+1] - center[1];
+      tetra[v][2] = vertices[3*v+2] - center[2];
+      }
+    volume += vtkPartialVolumeModellerBoxTetraVolume(halfWidth, tetra);
+    }
+
+  double fraction = volume / (8.0*halfWidth[0]*halfWidth[1]*halfWidth[2]);
+  if (fraction > 1.0)
+    {
+    fraction = 1.0;
+    }
+  return fraction;
 }
 
 //----------------------------------------------------------------------------
@@ -367,75 +763,76 @@ int vtkPartialVolumeModeller::RequestData(
   vtkDataSet *input = vtkDataSet::SafeDownCast(
     inInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  // Check that the input type is supported
-  int dataObjectType = input->GetDataObjectType();
-  if (dataObjectType != VTK_STRUCTURED_GRID &&
-      dataObjectType != VTK_UNSTRUCTURED_GRID &&
-      dataObjectType != VTK_RECTILINEAR_GRID)
-    {
-    vtkErrorMacro(<< "vtkPartialVolumeModeller expects an input data set of type "
-                  << "vtkStructuredGrid, vtkUnstructuredGrid, or vtkRectilinearGrid.");
-    return 0;
-    }
-
-  // get the output
+  // get the outputs
   vtkInformation *outInfo = outputVector->GetInformationObject(0);
   vtkImageData *output = vtkImageData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
+  vtkInformation *sparseInfo = outputVector->GetInformationObject(1);
+  vtkPolyData *sparseOutput = sparseInfo ? vtkPolyData::SafeDownCast(
+    sparseInfo->Get(vtkDataObject::DATA_OBJECT())) : NULL;
 
   // We need to allocate our own scalars since we are overriding
   // the superclasses "Execute()" method.
   output->SetExtent(
     outInfo->Get(vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT()));
-  int numTuples = 1;
-  for ( int i = 0; i < 3; ++i )
+  if (this->GenerateDenseOutput)
     {
-    numTuples *= ( output->GetExtent()[2*i+1] - output->GetExtent()[2*i] + 1 );
+    output->AllocateScalars(this->OutputScalarType, 1);
     }
-  output->AllocateScalars(this->OutputScalarType, 1);
 
   double origin[3], spacing[3];
-  double maxDistance = this->ComputeModelBounds(origin, spacing);
+  this->ComputeModelBounds(origin, spacing);
   outInfo->Set(vtkDataObject::ORIGIN(), origin, 3);
 
+  // The threads only read the tetrahedra and bins built here, so they
+  // share them instead of each working on its own copy of the input.
+  this->BuildTetrahedra(input);
+  this->BuildBins(origin, spacing);
+  this->BuildSurfaceBand(origin, spacing);
+
+  // Hand out the tiles with the most work first, estimated by the number
+  // of surface band voxels times the number of tetrahedra they check, so
+  // that the expensive tiles do not end up last on one thread.
+  vtkIdType numTiles = static_cast<vtkIdType>(this->BinOffsets.size()) - 1;
+  std::vector<std::pair<vtkIdType, vtkIdType> > tileCosts(numTiles);
+  for (vtkIdType bin = 0; bin < numTiles; bin++)
+    {
+    tileCosts[bin].first = -this->BinBandVoxels[bin]*
+      (this->BinOffsets[bin+1] - this->BinOffsets[bin]);
+    tileCosts[bin].second = bin;
+    }
+  std::sort(tileCosts.begin(), tileCosts.end());
+  this->TileOrder.resize(numTiles);
+  for (vtkIdType t = 0; t < numTiles; t++)
+    {
+    this->TileOrder[t] = tileCosts[t].second;
+    }
+  this->NextTile = 0;
+
   vtkPartialVolumeModellerThreadInfo info;
   info.Modeller = this;
+  for (int i = 0; i < 3; i++)
+    {
+    info.Origin[i] = origin[i];
+    info.Spacing[i] = spacing[i];
+    }
+  info.Scalars = this->GenerateDenseOutput ?
+    output->GetPointData()->GetScalars() : NULL;
 
   // Set the number of threads to use, then set the execution method
-  // and do it.  If the number of threads is greater than the image
-  // dimension along the splitting axis (z), reduce the number of
-  // threads so that each one gets a single-layer slab
-  if ( this->NumberOfThreads > this->SampleDimensions[2] )
+  // and do it.  There is no use for more threads than tiles.
+  if ( this->NumberOfThreads > numTiles )
     {
-    this->Threader->SetNumberOfThreads( this->SampleDimensions[2] );
+    this->Threader->SetNumberOfThreads( static_cast<int>(numTiles) );
     }
   else
     {
     this->Threader->SetNumberOfThreads( this->NumberOfThreads );
     }
 
-  // Deep copy the data set to avoid a race condition. We could also
-  // split the mesh into slabs to reduce the amount of work each thread
-  // has to do, but the splitting needs to be done in one thread,
-  // so doing so is not a clear win.
-  info.Input = new vtkDataSet*[this->Threader->GetNumberOfThreads()];
-  for (int threadId = 0; threadId < this->Threader->GetNumberOfThreads(); threadId++)
+  if (sparseOutput)
     {
-    switch (dataObjectType)
-      {
-      case VTK_STRUCTURED_GRID:
-        info.Input[threadId] = vtkStructuredGrid::New();
-        break;
-
-      case VTK_UNSTRUCTURED_GRID:
-        info.Input[threadId] = vtkUnstructuredGrid::New();
-        break;
-
-      case VTK_RECTILINEAR_GRID:
-        info.Input[threadId] = vtkRectilinearGrid::New();
-        break;
-      }
-    info.Input[threadId]->DeepCopy(input);
+    info.Sparse.resize(this->Threader->GetNumberOfThreads());
     }
 
   this->Threader->SetSingleMethod( vtkPartialVolumeModeller::ThreadedExecute,
@@ -443,16 +840,325 @@ int vtkPartialVolumeModeller::RequestData(
   this->TotalProgress = 0.0;
   this->Threader->SingleMethodExecute();
 
-  // Clean up.
-  for (int threadId = 0; threadId < this->Threader->GetNumberOfThreads(); threadId++)
+  if (sparseOutput)
     {
-    info.Input[threadId]->Delete();
+    this->GatherSparseOutput(info.Sparse, sparseOutput);
     }
-  delete[] info.Input;
 
   return 1;
 }
 
+//----------------------------------------------------------------------------
+// Concatenate the nonzero voxels the threads found, in bin order, and
+// record where each bin's voxels start.
+void vtkPartialVolumeModeller::GatherSparseOutput(
+  std::vector<vtkPartialVolumeModellerSparseBuffer>& buffers,
+  vtkPolyData *output)
+{
+  std::vector<vtkPartialVolumeModellerBlock> blocks;
+  vtkIdType numVoxels = 0;
+  for (size_t t = 0; t < buffers.size(); t++)
+    {
+    blocks.insert(blocks.end(), buffers[t].Blocks.begin(), buffers[t].Blocks.end());
+    numVoxels += static_cast<vtkIdType>(buffers[t].Values.size());
+    }
+  std::sort(blocks.begin(), blocks.end());
+
+  vtkPoints *points = vtkPoints::New(VTK_FLOAT);
+  points->SetNumberOfPoints(numVoxels);
+  float *coords = vtkFloatArray::SafeDownCast(points->GetData())->GetPointer(0);
+
+  vtkFloatArray *values = vtkFloatArray::New();
+  values->SetName("Coverage");
+  values->SetNumberOfTuples(numVoxels);
+  float *fractions = values->GetPointer(0);
+
+  vtkIdTypeArray *blockIds = vtkIdTypeArray::New();
+  blockIds->SetName("BlockIds");
+  blockIds->SetNumberOfTuples(static_cast<vtkIdType>(blocks.size()));
+  vtkIdTypeArray *blockOffsets = vtkIdTypeArray::New();
+  blockOffsets->SetName("BlockOffsets");
+  blockOffsets->SetNumberOfTuples(static_cast<vtkIdType>(blocks.size()) + 1);
+
+  vtkIdType next = 0;
+  for (size_t b = 0; b < blocks.size(); b++)
+    {
+    const vtkPartialVolumeModellerBlock& block = blocks[b];
+    const vtkPartialVolumeModellerSparseBuffer& buffer = buffers[block.Thread];
+    vtkIdType count = block.End - block.Begin;
+    std::copy(buffer.Points.begin() + 3*block.Begin,
+              buffer.Points.begin() + 3*block.End, coords + 3*next);
+    std::copy(buffer.Values.begin() + block.Begin,
+              buffer.Values.begin() + block.End, fractions + next);
+    blockIds->SetValue(static_cast<vtkIdType>(b), block.Bin);
+    blockOffsets->SetValue(static_cast<vtkIdType>(b), next);
+    next += count;
+    }
+  blockOffsets->SetValue(static_cast<vtkIdType>(blocks.size()), next);
+
+  output->SetPoints(points);
+  output->GetPointData()->SetScalars(values);
+  output->GetFieldData()->AddArray(blockIds);
+  output->GetFieldData()->AddArray(blockOffsets);
+
+  points->Delete();
+  values->Delete();
+  blockIds->Delete();
+  blockOffsets->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Decompose the 3D cells of the input into tetrahedra.
+void vtkPartialVolumeModeller::BuildTetrahedra(vtkDataSet *input)
+{
+  this->TetraVertices.clear();
+  this->TetraBounds.clear();
+  this->TetraPointIds.clear();
+
+  vtkGenericCell *cell = vtkGenericCell::New();
+  vtkIdList *ptIds = vtkIdList::New();
+  vtkPoints *pts = vtkPoints::New();
+
+  vtkIdType numCells = input->GetNumberOfCells();
+  for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+    input->GetCell(cellId, cell);
+    if (cell->GetCellDimension() != 3)
+      {
+      continue;
+      }
+
+    cell->Triangulate(0, ptIds, pts);
+    vtkIdType numTetra = pts->GetNumberOfPoints() / 4;
+    for (vtkIdType t = 0; t < numTetra; t++)
+      {
+      double bounds[6] = {VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+                          VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+                          VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX};
+      for (int v = 0; v < 4; v++)
+        {
+        double p[3];
+        pts->GetPoint(4*t + v, p);
+        this->TetraPointIds.push_back(ptIds->GetId(4*t + v));
+        for (int c = 0; c < 3; c++)
+          {
+          this->TetraVertices.push_back(p[c]);
+          bounds[2*c]   = p[c] < bounds[2*c]   ? p[c] : bounds[2*c];
+          bounds[2*c+1] = p[c] > bounds[2*c+1] ? p[c] : bounds[2*c+1];
+          }
+        }
+      this->TetraBounds.insert(this->TetraBounds.end(), bounds, bounds + 6);
+      }
+    }
+
+  cell->Delete();
+  ptIds->Delete();
+  pts->Delete();
+}
+
+//----------------------------------------------------------------------------
+// Sort the tetrahedra into bins of BIN_SIZE^3 voxels by the voxels their
+// bounds overlap.
+void vtkPartialVolumeModeller::BuildBins(double origin[3], double spacing[3])
+{
+  int *dims = this->SampleDimensions;
+  for (int c = 0; c < 3; c++)
+    {
+    this->BinDimensions[c] = (dims[c] + BIN_SIZE - 1) / BIN_SIZE;
+    }
+  vtkIdType numBins = static_cast<vtkIdType>(this->BinDimensions[0]) *
+    this->BinDimensions[1] * this->BinDimensions[2];
+
+  vtkIdType numTetra = static_cast<vtkIdType>(this->TetraBounds.size() / 6);
+  std::vector<int> binRanges(6*numTetra);
+  for (vtkIdType t = 0; t < numTetra; t++)
+    {
+    int *range = &binRanges[6*t];
+    vtkPartialVolumeModellerVoxelRange(&this->TetraBounds[6*t], origin,
+                                       spacing, dims, range);
+    for (int c = 0; c < 6; c++)
+      {
+      range[c] = range[c] < 0 ? -1 : range[c] / BIN_SIZE;
+      }
+    }
+
+  // Count, then fill.
+  this->BinOffsets.assign(numBins + 1, 0);
+  for (int pass = 0; pass < 2; pass++)
+    {
+    std::vector<vtkIdType> next;
+    if (pass == 1)
+      {
+      for (vtkIdType b = 0; b < numBins; b++)
+        {
+        this->BinOffsets[b+1] += this->BinOffsets[b];
+        }
+      this->BinTetra.resize(this->BinOffsets[numBins]);
+      next.assign(this->BinOffsets.begin(), this->BinOffsets.end() - 1);
+      }
+
+    for (vtkIdType t = 0; t < numTetra; t++)
+      {
+      const int *range = &binRanges[6*t];
+      for (int bk = range[4]; bk <= range[5]; bk++)
+        {
+        for (int bj = range[2]; bj <= range[3]; bj++)
+          {
+          for (int bi = range[0]; bi <= range[1]; bi++)
+            {
+            vtkIdType bin = bi + this->BinDimensions[0]*
+              (bj + static_cast<vtkIdType>(this->BinDimensions[1])*bk);
+            if (pass == 0)
+              {
+              this->BinOffsets[bin+1]++;
+              }
+            else
+              {
+              this->BinTetra[next[bin]++] = t;
+              }
+            }
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Find the boundary triangles of the tetrahedra, mark the voxels they may
+// touch as the surface band, and record where each row of voxel centers
+// along x crosses them. A face shared by an even number of tetrahedra is
+// interior. Cells whose triangulations do not match across a shared face
+// leave pairs of triangles over it that cross every row twice, which does
+// not change parity.
+void vtkPartialVolumeModeller::BuildSurfaceBand(double origin[3],
+                                                double spacing[3])
+{
+  static const int faceVertices[4][3] = {{0,1,2}, {0,1,3}, {0,2,3}, {1,2,3}};
+
+  vtkIdType numTetra = static_cast<vtkIdType>(this->TetraPointIds.size() / 4);
+  std::vector<vtkPartialVolumeModellerFace> faces(4*numTetra);
+  for (vtkIdType t = 0; t < numTetra; t++)
+    {
+    for (int f = 0; f < 4; f++)
+      {
+      vtkPartialVolumeModellerFace &face = faces[4*t + f];
+      for (int v = 0; v < 3; v++)
+        {
+        face.Ids[v] = this->TetraPointIds[4*t + faceVertices[f][v]];
+        }
+      std::sort(face.Ids, face.Ids + 3);
+      face.Tetra = t;
+      face.Face = f;
+      }
+    }
+  std::sort(faces.begin(), faces.end());
+
+  std::vector<double> triangles;
+  size_t first = 0;
+  while (first < faces.size())
+    {
+    size_t last = first + 1;
+    while (last < faces.size() && faces[last].SameAs(faces[first]))
+      {
+      last++;
+      }
+    if ((last - first) % 2 == 1)
+      {
+      const double *vertices = &this->TetraVertices[12*faces[first].Tetra];
+      for (int v = 0; v < 3; v++)
+        {
+        const double *p = vertices + 3*faceVertices[faces[first].Face][v];
+        triangles.insert(triangles.end(), p, p + 3);
+        }
+      }
+    first = last;
+    }
+
+  int *dims = this->SampleDimensions;
+  vtkIdType numRows = static_cast<vtkIdType>(dims[1])*dims[2];
+  this->SurfaceBand.assign(numRows*dims[0], 0);
+  this->BinBandVoxels.assign(this->BinOffsets.size() - 1, 0);
+  this->RowOffsets.assign(numRows + 1, 0);
+
+  // Mark the band, count the crossings of each row, then fill them in.
+  size_t numTriangles = triangles.size() / 9;
+  std::vector<vtkIdType> next;
+  for (int pass = 0; pass < 2; pass++)
+    {
+    if (pass == 1)
+      {
+      for (vtkIdType row = 0; row < numRows; row++)
+        {
+        this->RowOffsets[row+1] += this->RowOffsets[row];
+        }
+      this->RowCrossings.resize(this->RowOffsets[numRows]);
+      next.assign(this->RowOffsets.begin(), this->RowOffsets.end() - 1);
+      }
+
+    for (size_t t = 0; t < numTriangles; t++)
+      {
+      const double *tri = &triangles[9*t];
+      double bounds[6];
+      for (int c = 0; c < 3; c++)
+        {
+        bounds[2*c]   = std::min(tri[c], std::min(tri[3+c], tri[6+c]));
+        bounds[2*c+1] = std::max(tri[c], std::max(tri[3+c], tri[6+c]));
+        }
+      int range[6];
+      vtkPartialVolumeModellerVoxelRange(bounds, origin, spacing, dims, range);
+
+      for (int k = range[4]; k <= range[5]; k++)
+        {
+        double z = static_cast<double>(k)*spacing[2] + origin[2];
+        for (int j = range[2]; j <= range[3]; j++)
+          {
+          double y = static_cast<double>(j)*spacing[1] + origin[1];
+          vtkIdType row = j + static_cast<vtkIdType>(dims[1])*k;
+          if (pass == 0)
+            {
+            for (int i = range[0]; i <= range[1]; i++)
+              {
+              unsigned char &band = this->SurfaceBand[row*dims[0] + i];
+              if (!band)
+                {
+                band = 1;
+                this->BinBandVoxels[(i / BIN_SIZE) + this->BinDimensions[0]*
+                  ((j / BIN_SIZE) + this->BinDimensions[1]*(k / BIN_SIZE))]++;
+                }
+              }
+            }
+
+          // The row can only cross the triangle where the voxel centers
+          // of its band are, so rows outside the triangle's y-z extent
+          // are skipped.
+          if (y < bounds[2] || y > bounds[3] || z < bounds[4] || z > bounds[5])
+            {
+            continue;
+            }
+          double x;
+          if (vtkPartialVolumeModellerRayCrossing(tri, y, z, x))
+            {
+            if (pass == 0)
+              {
+              this->RowOffsets[row+1]++;
+              }
+            else
+              {
+              this->RowCrossings[next[row]++] = x;
+              }
+            }
+          }
+        }
+      }
+    }
+
+  for (vtkIdType row = 0; row < numRows; row++)
+    {
+    std::sort(this->RowCrossings.begin() + this->RowOffsets[row],
+              this->RowCrossings.begin() + this->RowOffsets[row+1]);
+    }
+}
+
 //----------------------------------------------------------------------------
 // Compute the ModelBounds based on the input geometry.
 double vtkPartialVolumeModeller::ComputeModelBounds(double origin[3],
@@ -557,6 +1263,24 @@ void vtkPartialVolumeModeller::SetSampleDimensions(int dim[3])
     }
 }
 
+//----------------------------------------------------------------------------
+vtkPolyData* vtkPartialVolumeModeller::GetSparseOutput()
+{
+  return vtkPolyData::SafeDownCast(this->GetOutputDataObject(1));
+}
+
+//----------------------------------------------------------------------------
+int vtkPartialVolumeModeller::FillOutputPortInformation(
+  int port, vtkInformation* info)
+{
+  if (port == 1)
+    {
+    info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkPolyData");
+    return 1;
+    }
+  return this->Superclass::FillOutputPortInformation(port, info);
+}
+
 //----------------------------------------------------------------------------
 int vtkPartialVolumeModeller::FillInputPortInformation(
   int vtkNotUsed(port), vtkInformation* info)
@@ -570,9 +1294,7 @@ void vtkPartialVolumeModeller::UpdateThreadProgress(double threadProgress)
 {
   this->ProgressMutex->Lock();
 
-  // This doesn't exactly represent the fraction of work contributed
-  // by the thread to the total problem, but it's good enough.
-  this->TotalProgress += threadProgress / static_cast<double>(this->Threader->GetNumberOfThreads());
+  this->TotalProgress += threadProgress;
 
   this->ProgressMutex->Unlock();
 }
@@ -594,4 +1316,5 @@ void vtkPartialVolumeModeller::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "  Zmin,Zmax: (" << this->ModelBounds[4] << ", "
      << this->ModelBounds[5] << ")\n";
   os << indent << "OutputScalarType: " << this->OutputScalarType << endl;
+  os << indent << "GenerateDenseOutput: " << this->GenerateDenseOutput << endl;
 }
@@ -19,6 +19,27 @@
 // structured point (i.e., voxel) representation. It is very similar to
 // vtkImplicitModeller, except that it doesn't record distance; instead it
 // records the volume of the intersection of each voxel with the data set.
+//
+// The 3D cells of the input are split into tetrahedra, and the volume of
+// each voxel is the sum of the exact volumes of its intersections with the
+// tetrahedra, computed in closed form by the divergence theorem. The
+// tetrahedra are sorted into bins of voxels before the threads start, and
+// the threads only read them, so the input is not copied for each thread.
+// The threads take the bins as tiles one at a time, so that the work near
+// the surface is spread over all of them.
+//
+// The second output lists only the voxels with coverage of at least 1e-9,
+// which leaves out round-off slivers, as vtkPolyData points at the voxel
+// centers with the coverage as scalars and no cells. The voxels are grouped in blocks of 8x8x8 voxels. The field
+// data array "BlockIds" holds the index of each nonempty block, x fastest,
+// and "BlockOffsets" the index of its first point, followed by the number
+// of points. With GenerateDenseOutput off, the image has no scalars and
+// only the sparse output takes memory.
+//
+// Only voxels near the boundary of the input need the exact volume. Each
+// row of voxels along x is intersected with the boundary triangles, and
+// the voxels away from them are set to 1 or 0 by the parity of the
+// crossings before their center.
 // .SECTION see also
 // vtkImplicitModeller vtkVoxelModeller
 
@@ -27,8 +48,13 @@
 
 #include "vtkImageAlgorithm.h"
 
+#include <vector>
+
+class vtkDataSet;
 class vtkMultiThreader;
+class vtkPolyData;
 class vtkSimpleCriticalSection;
+struct vtkPartialVolumeModellerSparseBuffer;
 
 class VTK_ABI_EXPORT vtkPartialVolumeModeller : public vtkImageAlgorithm
 {
@@ -89,6 +115,17 @@ public:
     {this->SetOutputScalarType(VTK_CHAR);};
   vtkGetMacro(OutputScalarType,int);
 
+  // Description:
+  // Fill in the scalars of the image output. On by default. Turn it off
+  // when only the sparse output is used.
+  vtkSetMacro(GenerateDenseOutput,int);
+  vtkGetMacro(GenerateDenseOutput,int);
+  vtkBooleanMacro(GenerateDenseOutput,int);
+
+  // Description:
+  // Get the voxels with coverage of at least 1e-9.
+  vtkPolyData* GetSparseOutput();
+
 protected:
   vtkPartialVolumeModeller();
   ~vtkPartialVolumeModeller();
@@ -104,14 +141,41 @@ protected:
 
   // see algorithm for more info
   virtual int FillInputPortInformation(int port, vtkInformation* info);
+  virtual int FillOutputPortInformation(int port, vtkInformation* info);
 
-  // Update a thread's progress. The parameter should range between
-  // (0,1), and it represents the fraction of total work done by the
-  // thread (not total work done by the filter).
+  // Update a thread's progress. The parameter is the fraction of the
+  // voxels of the whole grid the thread just finished.
   virtual void UpdateThreadProgress(double threadProgress);
 
   static VTK_THREAD_RETURN_TYPE ThreadedExecute( void *arg );
 
+  // Description:
+  // Splits the 3D cells of the input into tetrahedra and stores their
+  // vertices and bounds.
+  void BuildTetrahedra(vtkDataSet *input);
+
+  // Description:
+  // Sorts the tetrahedra into bins of voxels whose extent their bounds
+  // overlap.
+  void BuildBins(double origin[3], double spacing[3]);
+
+  // Description:
+  // Finds the boundary of the tetrahedra, marks the voxels near it and
+  // intersects it with each row of voxels.
+  void BuildSurfaceBand(double origin[3], double spacing[3]);
+
+  // Description:
+  // Fraction of a voxel covered by the tetrahedra of its bin.
+  double ComputeVoxelFraction(vtkIdType binBegin, vtkIdType binEnd,
+                              const double center[3],
+                              const double halfWidth[3]);
+
+  // Description:
+  // Builds the sparse output from the voxels found by each thread.
+  void GatherSparseOutput(
+    std::vector<vtkPartialVolumeModellerSparseBuffer>& buffers,
+    vtkPolyData *output);
+
   vtkMultiThreader         *Threader;
   int                       NumberOfThreads;
   vtkSimpleCriticalSection *ProgressMutex;
@@ -120,10 +184,45 @@ protected:
   double MaximumDistance;
   double ModelBounds[6];
   int    OutputScalarType;
+  int    GenerateDenseOutput;
 
   // Keeps track of the total progress of the filter
   double TotalProgress;
 
+  // Description:
+  // Tetrahedra of the input, as four x, y, z vertices, as xmin, xmax,
+  // ymin, ymax, zmin, zmax bounds, and as the ids of their four points.
+  std::vector<double>    TetraVertices;
+  std::vector<double>    TetraBounds;
+  std::vector<vtkIdType> TetraPointIds;
+
+  // Description:
+  // Tetrahedra overlapping each bin of voxels. The ids of the tetrahedra
+  // in bin b are BinTetra[BinOffsets[b]] up to BinTetra[BinOffsets[b+1]].
+  int                    BinDimensions[3];
+  std::vector<vtkIdType> BinOffsets;
+  std::vector<vtkIdType> BinTetra;
+
+  // Description:
+  // Nonzero for voxels that may overlap the boundary of the input. The
+  // sorted x coordinates where the row of voxel centers j, k crosses the
+  // boundary are RowCrossings[RowOffsets[j + k*dims[1]]] up to
+  // RowCrossings[RowOffsets[j + k*dims[1] + 1]].
+  std::vector<unsigned char> SurfaceBand;
+  std::vector<vtkIdType>     RowOffsets;
+  std::vector<double>        RowCrossings;
+
+  // Description:
+  // Number of surface band voxels in each bin.
+  std::vector<vtkIdType> BinBandVoxels;
+
+  // Description:
+  // Bins of voxels in the order the threads take them as tiles, the
+  // index of the next tile to take, and the lock that guards it.
+  std::vector<vtkIdType>    TileOrder;
+  vtkIdType                 NextTile;
+  vtkSimpleCriticalSection *TileMutex;
+
 private:
   vtkPartialVolumeModeller(const vtkPartialVolumeModeller&); // Not implemented
   void operator=(const vtkPartialVolumeModeller&); // Not implemented